@@ -320,6 +320,18 @@ std::string get_cc_light_instruction_name(
     return cc_light_instr_name;
 }
 
+std::string get_cc_light_instruction_name(const gate *g, const quantum_platform &platform) {
+    auto ip = platform.instructions->get(g);
+    if (ip == nullptr || ip->prototype == nullptr) {
+        return get_cc_light_instruction_name(g->name, platform);
+    }
+    const std::string &cc_light_instr_name = ip->prototype->arch_operation_name;
+    if (cc_light_instr_name.empty()) {
+        FATAL("cc_light_instr not defined for instruction: " << g->name << " !");
+    }
+    return cc_light_instr_name;
+}
+
 std::string ir2qisa(
     quantum_kernel &kernel,
     const quantum_platform &platform,
@@ -352,8 +364,8 @@ std::string ir2qisa(
                         continue;
                     }
 
-                    auto n1 = get_cc_light_instruction_name(id1, platform);
-                    auto n2 = get_cc_light_instruction_name(id2, platform);
+                    auto n1 = get_cc_light_instruction_name(*insIt1, platform);
+                    auto n2 = get_cc_light_instruction_name(*insIt2, platform);
                     if (n1 == n2) {
                         DOUT("Splicing " << id1 << "/" << n1 << " and " << id2 << "/" << n2);
                         (*secIt1).splice(insIt1, (*secIt2));
@@ -439,7 +451,7 @@ std::string ir2qisa(
                 ssinst << classical_instruction2qisa( (classical_cc *)(*firstInsIt) );
             } else {
                 DOUT("get cclight instr name for : " << iname);
-                std::string cc_light_instr_name = get_cc_light_instruction_name(iname, platform);
+                std::string cc_light_instr_name = get_cc_light_instruction_name(*firstInsIt, platform);
                 auto nOperands = ((*firstInsIt)->operands).size();
                 if (itype == __nop_gate__) {
                     ssinst << cc_light_instr_name;
@@ -624,7 +636,7 @@ void cc_light_eqasm_compiler::ccl_decompose_post_schedule(
         if (!kernel.c.empty()) {
             ASSERT(kernel.cycles_valid);
             ir::bundles_t bundles = ir::bundler(kernel.c, platform.cycle_time);
-            ccl_decompose_post_schedule_bundles(bundles, platform);
+            ccl_decompose_post_schedule_bundles(bundles, platform, *kernel.arena);
             kernel.c = ir::circuiter(bundles);
             ASSERT(kernel.cycles_valid);
         }
@@ -635,7 +647,8 @@ void cc_light_eqasm_compiler::ccl_decompose_post_schedule(
 
 void cc_light_eqasm_compiler::ccl_decompose_post_schedule_bundles(
     ir::bundles_t &bundles_dst,
-    const quantum_platform &platform
+    const quantum_platform &platform,
+    gate_arena &arena
 ) {
     auto bundles_src = bundles_dst;
 
@@ -691,10 +704,10 @@ void cc_light_eqasm_compiler::ccl_decompose_post_schedule_bundles(
                     std::string operation_type{};
                     size_t nOperands = ((*ins_src_it)->operands).size();
                     if (nOperands == 2) {
-                        auto it = platform.instruction_map.find(id);
-                        if (it != platform.instruction_map.end()) {
-                            if (platform.instruction_settings[id].count("type") > 0) {
-                                operation_type = platform.instruction_settings[id]["type"].get<std::string>();
+                        auto ip = platform.instructions->get(*ins_src_it);
+                        if (ip != nullptr && ip->prototype != nullptr) {
+                            if (ip->has_type) {
+                                operation_type = ip->type;
                             }
                         } else {
                             FATAL("custom instruction not found for : " << id << " !");
@@ -712,7 +725,7 @@ void cc_light_eqasm_compiler::ccl_decompose_post_schedule_bundles(
                                 DOUT("add the following sqf gates for edge: " << edge_no << ":");
                                 for (auto &q : edge_detunes_qubits[edge_no]) {
                                     DOUT("sqf q" << q);
-                                    custom_gate* g = new custom_gate("sqf q"+std::to_string(q));
+                                    custom_gate* g = arena.create<custom_gate>("sqf q"+std::to_string(q));
                                     g->operands.push_back(q);
 
                                     ir::section_t asec;
@@ -776,6 +789,9 @@ void cc_light_eqasm_compiler::map(
         std::stringstream ss;
         ss << "# ----- swaps added: " << mapper.nswapsadded << std::endl;
         ss << "# ----- of which moves added: " << mapper.nmovesadded << std::endl;
+        if (!mapper.portfoliowinner.empty()) {
+            ss << "# ----- portfolio winner: " << mapper.portfoliowinner << std::endl;
+        }
         ss << "# ----- virt2real map before mapper:" << utils::to_string(mapper.v2r_in) << std::endl;
         ss << "# ----- virt2real map after initial placement:" << utils::to_string(mapper.v2r_ip) << std::endl;
         ss << "# ----- virt2real map after mapper:" << utils::to_string(mapper.v2r_out) << std::endl;
@@ -972,29 +988,29 @@ void cc_light_eqasm_compiler::ccl_decompose_pre_schedule_kernel(
                 (iname == "not") || (iname == "nop")
             ) {
                 // decomp_ckt.push_back(ins);
-                decomp_ckt.push_back(new classical_cc(iname, icopers));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>(iname, icopers));
                 DOUT("    classical instruction decomposed: " << decomp_ckt.back()->qasm());
             } else if (
                 (iname == "eq") || (iname == "ne") || (iname == "lt") ||
                 (iname == "gt") || (iname == "le") || (iname == "ge")
             ) {
-                decomp_ckt.push_back(new classical_cc("cmp", {icopers[1], icopers[2]}));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>("cmp", std::vector<size_t>{icopers[1], icopers[2]}));
                 DOUT("    classical instruction decomposed: " << decomp_ckt.back()->qasm());
-                decomp_ckt.push_back(new classical_cc("nop", {}));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>("nop", std::vector<size_t>{}));
                 DOUT("                                      " << decomp_ckt.back()->qasm());
-                decomp_ckt.push_back(new classical_cc("fbr_"+iname, {icopers[0]}));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>("fbr_"+iname, std::vector<size_t>{icopers[0]}));
                 DOUT("                                      " << decomp_ckt.back()->qasm());
             } else if (iname == "mov") {
                 // r28 is used as temp, TODO use creg properly to create temporary
-                decomp_ckt.push_back(new classical_cc("ldi", {28}, 0));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>("ldi", std::vector<size_t>{28}, 0));
                 DOUT("    classical instruction decomposed: " << decomp_ckt.back()->qasm());
-                decomp_ckt.push_back(new classical_cc("add", {icopers[0], icopers[1], 28}));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>("add", std::vector<size_t>{icopers[0], icopers[1], 28}));
                 DOUT("                                      " << decomp_ckt.back()->qasm());
             } else if (iname == "ldi") {
                 // auto imval = ((classical_cc*)ins)->int_operand;
                 auto imval = ((classical*)ins)->int_operand;
                 DOUT("    classical instruction decomposed: imval=" << imval);
-                decomp_ckt.push_back(new classical_cc("ldi", {icopers[0]}, imval));
+                decomp_ckt.push_back(kernel.arena->create<classical_cc>("ldi", std::vector<size_t>{icopers[0]}, imval));
                 DOUT("    classical instruction decomposed: " << decomp_ckt.back()->qasm());
             } else {
                 EOUT("Unknown decomposition of classical operation '" << iname << "' with '" << icopers_count << "' operands!");
@@ -1005,10 +1021,18 @@ void cc_light_eqasm_compiler::ccl_decompose_pre_schedule_kernel(
                 DOUT("    wait instruction ");
                 decomp_ckt.push_back(ins);
             } else {
-                const json& instruction_settings = platform.instruction_settings;
+                const instruction_table &instructions = *platform.instructions;
+                auto ip = instructions.get(ins);
+                if (ip == nullptr || ip->name != iname) {      // ins->name is not in lower case
+                    int opcode = instructions.find(iname);
+                    ip = (opcode < 0 ? nullptr : &instructions[opcode]);
+                }
                 std::string operation_type;
-                if (instruction_settings.find(iname) != instruction_settings.end()) {
-                    operation_type = instruction_settings[iname]["type"].get<std::string>();
+                if (ip != nullptr && ip->has_settings) {
+                    if (!ip->has_type) {
+                        FATAL("JSON file: field 'type' not defined for instruction '" << iname << "'");
+                    }
+                    operation_type = ip->type;
                 } else {
                     EOUT("instruction settings not found for '" << iname << "' with '" << iqopers_count << "' operands!");
                     throw exception("instruction settings not found for '"+iname+"' with'"+std::to_string(iqopers_count)+"' operands!", false);
@@ -1023,7 +1047,7 @@ void cc_light_eqasm_compiler::ccl_decompose_pre_schedule_kernel(
                         auto &coperands = ins->creg_operands;
                         if (!coperands.empty()) {
                             auto cop = coperands[0];
-                            decomp_ckt.push_back(new classical_cc("fmr", {cop, qop}));
+                            decomp_ckt.push_back(kernel.arena->create<classical_cc>("fmr", std::vector<size_t>{cop, qop}));
                         } else {
                             // WOUT("Unknown classical operand for measure/readout operation: '" << iname <<
                             //     ". This will soon be depricated in favour of measure instruction with fmr" <<
@@ -80,6 +80,9 @@ std::string classical_instruction2qisa(classical_cc *classical_in);
 // FIXME HvS attribute of gate or just in json? Generalization to arch_operation_name is unnecessary
 std::string get_cc_light_instruction_name(const std::string &id, const quantum_platform &platform);
 
+// same for the instruction of a gate, found by its opcode
+std::string get_cc_light_instruction_name(const gate *g, const quantum_platform &platform);
+
 std::string ir2qisa(quantum_kernel &kernel, const quantum_platform &platform, MaskManager &gMaskManager);
 
 /**
@@ -99,7 +102,7 @@ public:
 
     void ccl_decompose_pre_schedule(quantum_program *programp, const quantum_platform &platform, const std::string &passname);
     void ccl_decompose_post_schedule(quantum_program *programp, const quantum_platform &platform, const std::string &passname);
-    static void ccl_decompose_post_schedule_bundles(ir::bundles_t &bundles_dst, const quantum_platform &platform);
+    static void ccl_decompose_post_schedule_bundles(ir::bundles_t &bundles_dst, const quantum_platform &platform, gate_arena &arena);
     static void map(quantum_program *programp, const quantum_platform &platform, const std::string &passname, std::string *mapStatistics);
 
     // cc_light_instr is needed by some cc_light backend passes and by cc_light resource_management:
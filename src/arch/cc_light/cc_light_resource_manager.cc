@@ -1,4 +1,5 @@
 #include "arch/cc_light/cc_light_resource_manager.h"
+#include "options.h"
 
 namespace ql {
 namespace arch {
@@ -30,6 +31,174 @@ std::string ccl_get_operation_name(ql::gate *ins, const ql::quantum_platform &pl
     return operation_name;
 }
 
+// the descriptors of all instructions, resolving their operation type and name once
+ccl_instruction_table_t::ccl_instruction_table_t(const ql::quantum_platform &platform) {
+    std::unordered_map<std::string, size_t> operation_ids;
+    for (json::const_iterator it = platform.instruction_settings.begin(); it != platform.instruction_settings.end(); ++it) {
+        const json &settings = it.value();
+
+        std::string operation_type("cc_light_type");
+        if (settings.count("type") > 0 && !settings["type"].is_null()) {
+            operation_type = settings["type"].get<std::string>();
+        }
+        std::string operation_name(it.key());
+        if (settings.count("cc_light_instr") > 0 && !settings["cc_light_instr"].is_null()) {
+            operation_name = settings["cc_light_instr"].get<std::string>();
+        }
+
+        ccl_instruction_desc_t d;
+        if (operation_type == "mw") {
+            d.type = ccl_mw_type;
+        } else if (operation_type == "flux") {
+            d.type = ccl_flux_type;
+        } else if (operation_type == "readout") {
+            d.type = ccl_readout_type;
+        } else {
+            d.type = ccl_other_type;
+        }
+        auto oit = operation_ids.find(operation_name);
+        if (oit == operation_ids.end()) {
+            oit = operation_ids.insert(std::make_pair(operation_name, operation_ids.size())).first;
+        }
+        d.operation = oit->second;
+        desc[it.key()] = d;
+    }
+    operation_count = operation_ids.size();
+
+    const ql::instruction_table &instructions = *platform.instructions;
+    opdesc.resize(instructions.size());
+    has_opdesc.assign(instructions.size(), false);
+    for (size_t opcode = 0; opcode < instructions.size(); opcode++) {
+        auto it = desc.find(instructions[opcode].name);
+        if (it != desc.end()) {
+            opdesc[opcode] = it->second;
+            has_opdesc[opcode] = true;
+        }
+    }
+}
+
+const ccl_instruction_desc_t &ccl_instruction_table_t::get(const ql::gate *ins) const {
+    if (ins->opcode >= 0 && size_t(ins->opcode) < opdesc.size() && has_opdesc[ins->opcode]) {
+        return opdesc[ins->opcode];
+    }
+    auto it = desc.find(ins->name);
+    if (it == desc.end()) {
+        JSON_FATAL("key '" << ins->name << "' not found on path '" << ins->name << "' in the instructions of the platform");
+    }
+    return it->second;
+}
+
+// the edges of the topology, indexed by their qubit pair
+const size_t ccl_edge_table_t::no_edge;
+
+ccl_edge_table_t::ccl_edge_table_t(const ql::quantum_platform &platform) {
+    nq = platform.qubit_number;
+    edge.assign(nq*nq, no_edge);
+    edge_count = 0;
+    if (platform.topology.count("edges") == 0) {
+        return;                     // e.g. a multi-core topology without explicit edges
+    }
+    for (auto &anedge : platform.topology["edges"]) {
+        size_t s = anedge["src"];
+        size_t d = anedge["dst"];
+        size_t e = anedge["id"];
+
+        if (s >= nq || d >= nq) {
+            JSON_FATAL("edge " << e << " with qubit " << std::max(s,d) << " is out of range of the platform's qubits");
+        }
+        if (edge[s*nq+d] != no_edge) {
+            EOUT("re-defining edge " << s <<"->" << d << " !");
+            throw ql::exception("[x] Error : re-defining edge !",false);
+        }
+        edge[s*nq+d] = e;
+        edge_count = std::max(edge_count, e+1);
+    }
+}
+
+size_t ccl_edge_table_t::get(size_t q0, size_t q1) const {
+    if (q0 >= nq || q1 >= nq) {
+        return no_edge;
+    }
+    return edge[q0*nq+q1];
+}
+
+// latest start cycle of an operation of the given duration that must complete at or before cycle
+static size_t ccl_start_before(size_t cycle, size_t operation_duration) {
+    return (cycle >= operation_duration ? cycle - operation_duration : 0);
+}
+
+// make a bound on the next cycle that a resource may be available at
+// to be at least one cycle beyond op_start_cycle in the scheduling direction
+static size_t ccl_next_cycle(scheduling_direction_t dir, size_t op_start_cycle, size_t cycle) {
+    if (forward_scheduling == dir) {
+        return std::max(cycle, op_start_cycle + 1);
+    } else {
+        return std::min(cycle, op_start_cycle - 1);
+    }
+}
+
+// the unit (qwg, measurement unit) that each qubit is connected to by the connection_map of the resource;
+// qubits not connected use unit 0, as they always did
+static std::vector<size_t> ccl_qubit2unit(const ql::quantum_platform &platform, const std::string &name) {
+    std::vector<size_t> qubit2unit(platform.qubit_number, 0);
+    auto &constraints = platform.resources[name]["connection_map"];
+    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
+        // COUT(it.key() << " : " << it.value() );
+        size_t unitNo = stoi( it.key() );
+        auto & connected_qubits = it.value();
+        for (auto &q : connected_qubits) {
+            size_t qi = q;
+            if (qi >= qubit2unit.size()) {
+                qubit2unit.resize(qi+1, 0);
+            }
+            qubit2unit[qi] = unitNo;
+        }
+    }
+    return qubit2unit;
+}
+
+// for each edge, the edges that it blocks, inverting the connection_map of the edges resource
+static std::vector<std::vector<size_t>> ccl_edge2edges(const ql::quantum_platform &platform, const std::string &name, size_t edge_count) {
+    std::vector<std::vector<size_t>> edge2edges(edge_count);
+    auto &constraints = platform.resources[name]["connection_map"];
+    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
+        // COUT(it.key() << " : " << it.value() << "\n");
+        size_t edgeNo = stoi( it.key() );
+        auto &connected_edges = it.value();
+        for (auto &e : connected_edges) {
+            size_t ei = e;
+            if (ei >= edge2edges.size()) {
+                edge2edges.resize(ei+1);
+            }
+            edge2edges[ei].push_back(edgeNo);
+        }
+    }
+    return edge2edges;
+}
+
+// for each edge, the qubits that a two-qubit flux gate on it detunes, from the connection_map of the detuned_qubits resource
+static std::vector<std::vector<size_t>> ccl_edge_detunes_qubits(const ql::quantum_platform &platform, const std::string &name, size_t edge_count) {
+    std::vector<std::vector<size_t>> edge_detunes_qubits(edge_count);
+    auto &constraints = platform.resources[name]["connection_map"];
+    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
+        // COUT(it.key() << " : " << it.value() << "\n");
+        size_t edgeNo = stoi( it.key() );
+        if (edgeNo >= edge_detunes_qubits.size()) {
+            edge_detunes_qubits.resize(edgeNo+1);
+        }
+        auto & detuned_qubits = it.value();
+        for (auto & q : detuned_qubits) {
+            edge_detunes_qubits[edgeNo].push_back(q);
+        }
+    }
+    return edge_detunes_qubits;
+}
+
+// The next_available_cycle methods below rely on the resource state only moving in the scheduling direction:
+// when scheduling forward, the from and to cycles only increase by reservations, when backward, they only decrease;
+// and an operation different from the current one can only be reserved when the current one has completed.
+// So when not available at op_start_cycle, it cannot be before the cycle at which the current state frees up.
+
 ccl_qubit_resource_t::ccl_qubit_resource_t(
     const ql::quantum_platform &platform,
     scheduling_direction_t dir
@@ -60,7 +229,6 @@ bool ccl_qubit_resource_t::available(
     const ql::quantum_platform &platform
 ) {
     size_t operation_duration = ccl_get_operation_duration(ins, platform);
-    std::string operation_type = ccl_get_operation_type(ins, platform);
 
     for (auto q : ins->operands) {
         if (forward_scheduling == direction) {
@@ -86,7 +254,6 @@ void ccl_qubit_resource_t::reserve(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
     size_t operation_duration = ccl_get_operation_duration(ins, platform);
 
     for (auto q : ins->operands) {
@@ -95,11 +262,31 @@ void ccl_qubit_resource_t::reserve(
     }
 }
 
+size_t ccl_qubit_resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform
+) {
+    size_t operation_duration = ccl_get_operation_duration(ins, platform);
+
+    size_t cycle = op_start_cycle;
+    for (auto q : ins->operands) {
+        if (forward_scheduling == direction) {
+            cycle = std::max(cycle, state[q]);
+        } else {
+            cycle = std::min(cycle, ccl_start_before(state[q], operation_duration));
+        }
+    }
+    return ccl_next_cycle(direction, op_start_cycle, cycle);
+}
+
 ccl_qwg_resource_t::ccl_qwg_resource_t(
     const ql::quantum_platform &platform,
-    scheduling_direction_t dir
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions
 ) :
-    resource_t("qwgs", dir)
+    resource_t("qwgs", dir),
+    instructions(instructions)
 {
     // DOUT("... creating " << name << " resource");
     count = platform.resources[name]["count"];
@@ -110,17 +297,9 @@ ccl_qwg_resource_t::ccl_qwg_resource_t(
     for (size_t i = 0; i < count; i++) {
         fromcycle[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
         tocycle[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
-        operations[i] = "";
-    }
-    auto & constraints = platform.resources[name]["connection_map"];
-    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
-        // COUT(it.key() << " : " << it.value() );
-        size_t qwgNo = stoi( it.key() );
-        auto & connected_qubits = it.value();
-        for (auto &q : connected_qubits) {
-            qubit2qwg[q] = qwgNo;
-        }
+        operations[i] = instructions->operation_count;     // i.e. none of the operations
     }
+    qubit2qwg = ccl_qubit2unit(platform, name);
 }
 
 ccl_qwg_resource_t *ccl_qwg_resource_t::clone() const & {
@@ -138,11 +317,11 @@ bool ccl_qwg_resource_t::available(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
-    std::string operation_name = ccl_get_operation_name(ins, platform);
+    const ccl_instruction_desc_t &desc = instructions->get(ins);
+    size_t      operation_name = desc.operation;
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    bool is_mw = (operation_type == "mw");
+    bool is_mw = (desc.type == ccl_mw_type);
     if (is_mw) {
         for (auto q : ins->operands) {
             DOUT(" available " << name << "? op_start_cycle: " << op_start_cycle << "  qwg: " << qubit2qwg[q] << " is busy from cycle: " << fromcycle[ qubit2qwg[q] ] << " to cycle: " << tocycle[qubit2qwg[q]] << " for operation: " << operations[ qubit2qwg[q] ]);
@@ -174,11 +353,11 @@ void ccl_qwg_resource_t::reserve(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
-    std::string operation_name = ccl_get_operation_name(ins, platform);
+    const ccl_instruction_desc_t &desc = instructions->get(ins);
+    size_t      operation_name = desc.operation;
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    bool is_mw = operation_type == "mw";
+    bool is_mw = (desc.type == ccl_mw_type);
     if (is_mw) {
         for (auto q : ins->operands) {
             if (direction == forward_scheduling) {
@@ -203,11 +382,40 @@ void ccl_qwg_resource_t::reserve(
     }
 }
 
+size_t ccl_qwg_resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform
+) {
+    size_t      operation_name = instructions->get(ins).operation;
+    size_t      operation_duration = ccl_get_operation_duration(ins, platform);
+
+    size_t cycle = op_start_cycle;
+    for (auto q : ins->operands) {
+        size_t qwg = qubit2qwg[q];
+        bool same_operation = (operations[qwg] == operation_name);
+        if (direction == forward_scheduling) {
+            cycle = std::max(cycle, fromcycle[qwg]);
+            if (!same_operation) {
+                cycle = std::max(cycle, tocycle[qwg]);
+            }
+        } else {
+            cycle = std::min(cycle, ccl_start_before(tocycle[qwg], operation_duration));
+            if (!same_operation) {
+                cycle = std::min(cycle, ccl_start_before(fromcycle[qwg], operation_duration));
+            }
+        }
+    }
+    return ccl_next_cycle(direction, op_start_cycle, cycle);
+}
+
 ccl_meas_resource_t::ccl_meas_resource_t(
     const ql::quantum_platform &platform,
-    scheduling_direction_t dir
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions
 ) :
-    resource_t("meas_units", dir)
+    resource_t("meas_units", dir),
+    instructions(instructions)
 {
     // DOUT("... creating " << name << " resource");
     count = platform.resources[name]["count"];
@@ -218,15 +426,7 @@ ccl_meas_resource_t::ccl_meas_resource_t(
         fromcycle[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
         tocycle[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
     }
-    auto &constraints = platform.resources[name]["connection_map"];
-    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
-        // COUT(it.key() << " : " << it.value());
-        size_t measUnitNo = stoi( it.key() );
-        auto & connected_qubits = it.value();
-        for (auto &q : connected_qubits) {
-            qubit2meas[q] = measUnitNo;
-        }
-    }
+    qubit2meas = ccl_qubit2unit(platform, name);
 }
 
 ccl_meas_resource_t *ccl_meas_resource_t::clone() const & {
@@ -244,10 +444,9 @@ bool ccl_meas_resource_t::available(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    bool is_measure = (operation_type == "readout");
+    bool is_measure = (instructions->get(ins).type == ccl_readout_type);
     if (is_measure) {
         for (auto q : ins->operands) {
             DOUT(" available " << name << "? op_start_cycle: " << op_start_cycle << "  meas: " << qubit2meas[q] << " is busy from cycle: " << fromcycle[ qubit2meas[q] ] << " to cycle: " << tocycle[qubit2meas[q]] );
@@ -281,10 +480,9 @@ void ccl_meas_resource_t::reserve(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    bool is_measure = (operation_type == "readout");
+    bool is_measure = (instructions->get(ins).type == ccl_readout_type);
     if (is_measure) {
         for (auto q : ins->operands) {
             fromcycle[qubit2meas[q]] = op_start_cycle;
@@ -294,11 +492,38 @@ void ccl_meas_resource_t::reserve(
     }
 }
 
+// when scheduling backward, a measurement of a shorter duration may be reserved on the measurement unit
+// in any of the next cycles and then a measurement starting in the same cycle is available;
+// so then there is no better bound than the next cycle
+size_t ccl_meas_resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform
+) {
+    if (direction != forward_scheduling) {
+        return resource_t::next_available_cycle(op_start_cycle, ins, platform);
+    }
+
+    // before the start of the current measurement, the first cycle that may be available is that start
+    size_t cycle = op_start_cycle;
+    for (auto q : ins->operands) {
+        size_t meas = qubit2meas[q];
+        if (op_start_cycle != fromcycle[meas]) {
+            cycle = std::max(cycle, (op_start_cycle < fromcycle[meas] ? fromcycle[meas] : tocycle[meas]));
+        }
+    }
+    return ccl_next_cycle(direction, op_start_cycle, cycle);
+}
+
 ccl_edge_resource_t::ccl_edge_resource_t(
     const ql::quantum_platform &platform,
-    scheduling_direction_t dir
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions,
+    std::shared_ptr<const ccl_edge_table_t> edges
 ) :
-    resource_t("edges", dir)
+    resource_t("edges", dir),
+    qubits2edge(edges),
+    instructions(instructions)
 {
     // DOUT("... creating " << name << " resource");
     count = platform.resources[name]["count"];
@@ -308,30 +533,7 @@ ccl_edge_resource_t::ccl_edge_resource_t(
         state[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
     }
 
-    for (auto &anedge : platform.topology["edges"]) {
-        size_t s = anedge["src"];
-        size_t d = anedge["dst"];
-        size_t e = anedge["id"];
-
-        qubits_pair_t aqpair(s,d);
-        auto it = qubits2edge.find(aqpair);
-        if (it != qubits2edge.end()) {
-            EOUT("re-defining edge " << s <<"->" << d << " !");
-            throw ql::exception("[x] Error : re-defining edge !",false);
-        } else {
-            qubits2edge[aqpair] = e;
-        }
-    }
-
-    auto &constraints = platform.resources[name]["connection_map"];
-    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
-        // COUT(it.key() << " : " << it.value() << "\n");
-        size_t edgeNo = stoi( it.key() );
-        auto &connected_edges = it.value();
-        for (auto &e : connected_edges) {
-            edge2edges[e].push_back(edgeNo);
-        }
-    }
+    edge2edges = ccl_edge2edges(platform, name, std::max(count, qubits2edge->edge_count));
 }
 
 ccl_edge_resource_t *ccl_edge_resource_t::clone() const & {
@@ -349,11 +551,9 @@ bool ccl_edge_resource_t::available(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    auto gname = ins->name;
-    bool is_flux = (operation_type == "flux");
+    bool is_flux = (instructions->get(ins).type == ccl_flux_type);
     if (is_flux) {
         auto nopers = ins->operands.size();
         if (nopers == 1) {
@@ -362,16 +562,13 @@ bool ccl_edge_resource_t::available(
         } else if (nopers == 2) {
             auto q0 = ins->operands[0];
             auto q1 = ins->operands[1];
-            qubits_pair_t aqpair(q0, q1);
-            auto it = qubits2edge.find(aqpair);
-            if (it != qubits2edge.end()) {
-                auto edge_no = qubits2edge[aqpair];
-
+            auto edge_no = qubits2edge->get(q0, q1);
+            if (edge_no != ccl_edge_table_t::no_edge) {
                 DOUT(" available " << name << "? op_start_cycle: " << op_start_cycle << ", edge: " << edge_no << " is busy till/from cycle : " << state[edge_no] << " for operation: " << ins->name);
 
-                std::vector<size_t> edges2check(edge2edges[edge_no]);
-                edges2check.push_back(edge_no);
-                for (auto &e : edges2check) {
+                // the edge itself and the edges that it blocks (edge2edges[edge_no]) must be free
+                for (size_t i = 0; i <= edge2edges[edge_no].size(); i++) {
+                    size_t e = (i < edge2edges[edge_no].size() ? edge2edges[edge_no][i] : edge_no);
                     if (direction == forward_scheduling) {
                         if (op_start_cycle < state[e]) {
                             DOUT("    " << name << " resource busy ...");
@@ -400,11 +597,9 @@ void ccl_edge_resource_t::reserve(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    auto gname = ins->name;
-    bool is_flux = (operation_type == "flux");
+    bool is_flux = (instructions->get(ins).type == ccl_flux_type);
     if (is_flux) {
         auto nopers = ins->operands.size();
         if (nopers == 1) {
@@ -412,8 +607,8 @@ void ccl_edge_resource_t::reserve(
         } else if (nopers == 2) {
             auto q0 = ins->operands[0];
             auto q1 = ins->operands[1];
-            qubits_pair_t aqpair(q0, q1);
-            auto edge_no = qubits2edge[aqpair];
+            auto edge_no = qubits2edge->get(q0, q1);
+            ASSERT(edge_no != ccl_edge_table_t::no_edge);       // checked by available
             if (direction == forward_scheduling) {
                 state[edge_no] = op_start_cycle + operation_duration;
                 for (auto &e : edge2edges[edge_no]) {
@@ -432,11 +627,37 @@ void ccl_edge_resource_t::reserve(
     }
 }
 
+size_t ccl_edge_resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform
+) {
+    size_t operation_duration = ccl_get_operation_duration(ins, platform);
+
+    size_t cycle = op_start_cycle;
+    size_t edge_no = (ins->operands.size() == 2 ? qubits2edge->get(ins->operands[0], ins->operands[1]) : ccl_edge_table_t::no_edge);
+    if (edge_no != ccl_edge_table_t::no_edge) {
+        for (size_t i = 0; i <= edge2edges[edge_no].size(); i++) {
+            size_t e = (i < edge2edges[edge_no].size() ? edge2edges[edge_no][i] : edge_no);
+            if (direction == forward_scheduling) {
+                cycle = std::max(cycle, state[e]);
+            } else {
+                cycle = std::min(cycle, ccl_start_before(state[e], operation_duration));
+            }
+        }
+    }
+    return ccl_next_cycle(direction, op_start_cycle, cycle);
+}
+
 ccl_detuned_qubits_resource_t::ccl_detuned_qubits_resource_t(
     const ql::quantum_platform &platform,
-    scheduling_direction_t dir
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions,
+    std::shared_ptr<const ccl_edge_table_t> edges
 ) :
-    resource_t("detuned_qubits", dir)
+    resource_t("detuned_qubits", dir),
+    qubitpair2edge(edges),
+    instructions(instructions)
 {
     // DOUT("... creating " << name << " resource");
     count = platform.resources[name]["count"];
@@ -448,35 +669,11 @@ ccl_detuned_qubits_resource_t::ccl_detuned_qubits_resource_t(
     for (size_t i = 0; i < count; i++) {
         fromcycle[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
         tocycle[i] = (forward_scheduling == dir ? 0 : MAX_CYCLE);
-        operations[i] = "";
+        operations[i] = ccl_other_type;     // i.e. neither flux nor mw
     }
 
-    // initialize qubitpair2edge map from json description; this is a constant map
-    for (auto &anedge : platform.topology["edges"]) {
-        size_t s = anedge["src"];
-        size_t d = anedge["dst"];
-        size_t e = anedge["id"];
-
-        qubits_pair_t aqpair(s,d);
-        auto it = qubitpair2edge.find(aqpair);
-        if (it != qubitpair2edge.end()) {
-            EOUT("re-defining edge " << s <<"->" << d << " !");
-            throw ql::exception("[x] Error : re-defining edge !",false);
-        } else {
-            qubitpair2edge[aqpair] = e;
-        }
-    }
-
-    // initialize edge_detunes_qubits map from json description; this is a constant map
-    auto &constraints = platform.resources[name]["connection_map"];
-    for (json::const_iterator it = constraints.begin(); it != constraints.end(); ++it) {
-        // COUT(it.key() << " : " << it.value() << "\n");
-        size_t edgeNo = stoi( it.key() );
-        auto & detuned_qubits = it.value();
-        for (auto & q : detuned_qubits) {
-            edge_detunes_qubits[edgeNo].push_back(q);
-        }
-    }
+    // initialize edge_detunes_qubits from json description; this is a constant table
+    edge_detunes_qubits = ccl_edge_detunes_qubits(platform, name, qubitpair2edge->edge_count);
 }
 
 ccl_detuned_qubits_resource_t *ccl_detuned_qubits_resource_t::clone() const & {
@@ -496,11 +693,10 @@ bool ccl_detuned_qubits_resource_t::available(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
+    ccl_operation_type_t operation_type = instructions->get(ins).type;
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    auto gname = ins->name;
-    bool is_flux = operation_type == "flux";
+    bool is_flux = (operation_type == ccl_flux_type);
     if (is_flux) {
         auto nopers = ins->operands.size();
         if (nopers == 1) {
@@ -509,11 +705,8 @@ bool ccl_detuned_qubits_resource_t::available(
         } else if (nopers == 2) {
             auto q0 = ins->operands[0];
             auto q1 = ins->operands[1];
-            qubits_pair_t aqpair(q0, q1);
-            auto it = qubitpair2edge.find(aqpair);
-            if (it != qubitpair2edge.end()) {
-                auto edge_no = qubitpair2edge[aqpair];
-
+            auto edge_no = qubitpair2edge->get(q0, q1);
+            if (edge_no != ccl_edge_table_t::no_edge) {
                 for (auto &q : edge_detunes_qubits[edge_no]) {
                     DOUT(" available " << name << "? op_start_cycle: " << op_start_cycle << ", edge: " << edge_no << " detuning qubit: " << q << " for operation: " << ins->name << " busy from: " << fromcycle[q] << " till: " << tocycle[q] << " with operation_type: " << operation_type);
                     if (direction == forward_scheduling) {
@@ -543,7 +736,7 @@ bool ccl_detuned_qubits_resource_t::available(
         }
     }
 
-    bool is_mw = operation_type == "mw";
+    bool is_mw = (operation_type == ccl_mw_type);
     if (is_mw) {
         for (auto q : ins->operands) {
             DOUT(" available " << name << "? op_start_cycle: " << op_start_cycle << ", qubit: " << q << " for operation: " << ins->name << " busy from: " << fromcycle[q] << " till: " << tocycle[q] << " with operation_type: " << operation_type);
@@ -579,11 +772,10 @@ void ccl_detuned_qubits_resource_t::reserve(
     ql::gate *ins,
     const ql::quantum_platform &platform
 ) {
-    std::string operation_type = ccl_get_operation_type(ins, platform);
+    ccl_operation_type_t operation_type = instructions->get(ins).type;
     size_t      operation_duration = ccl_get_operation_duration(ins, platform);
 
-    auto gname = ins->name;
-    bool is_flux = operation_type == "flux";
+    bool is_flux = (operation_type == ccl_flux_type);
     if (is_flux) {
         auto nopers = ins->operands.size();
         if (nopers == 1) {
@@ -591,8 +783,8 @@ void ccl_detuned_qubits_resource_t::reserve(
         } else if (nopers == 2) {
             auto q0 = ins->operands[0];
             auto q1 = ins->operands[1];
-            qubits_pair_t aqpair(q0, q1);
-            auto edge_no = qubitpair2edge[aqpair];
+            auto edge_no = qubitpair2edge->get(q0, q1);
+            ASSERT(edge_no != ccl_edge_table_t::no_edge);       // checked by available
 
             for (auto & q : edge_detunes_qubits[edge_no]) {
                 if (direction == forward_scheduling) {
@@ -622,7 +814,7 @@ void ccl_detuned_qubits_resource_t::reserve(
             FATAL("Incorrect number of operands used in operation: " << ins->name << " !");
         }
     }
-    bool is_mw = operation_type == "mw";
+    bool is_mw = (operation_type == ccl_mw_type);
     if (is_mw) {
         for (auto q : ins->operands) {
             if (direction == forward_scheduling) {
@@ -651,6 +843,286 @@ void ccl_detuned_qubits_resource_t::reserve(
     }
 }
 
+// The qubits that are checked are the detuned qubits of the edge of a two-qubit flux gate
+// and the operand qubits of a one-qubit rotation, as in available above.
+size_t ccl_detuned_qubits_resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform
+) {
+    ccl_operation_type_t operation_type = instructions->get(ins).type;
+    size_t      operation_duration = ccl_get_operation_duration(ins, platform);
+
+    std::vector<size_t> qubits2check;
+    if (operation_type == ccl_flux_type && ins->operands.size() == 2) {
+        auto edge_no = qubitpair2edge->get(ins->operands[0], ins->operands[1]);
+        if (edge_no != ccl_edge_table_t::no_edge) {
+            qubits2check = edge_detunes_qubits[edge_no];
+        }
+    } else if (operation_type == ccl_mw_type) {
+        qubits2check = ins->operands;
+    }
+
+    size_t cycle = op_start_cycle;
+    for (auto q : qubits2check) {
+        bool same_operation = (operations[q] == operation_type);
+        if (direction == forward_scheduling) {
+            cycle = std::max(cycle, fromcycle[q]);
+            if (!same_operation) {
+                cycle = std::max(cycle, tocycle[q]);
+            }
+        } else {
+            cycle = std::min(cycle, ccl_start_before(tocycle[q], operation_duration));
+            if (!same_operation) {
+                cycle = std::min(cycle, ccl_start_before(fromcycle[q], operation_duration));
+            }
+        }
+    }
+    return ccl_next_cycle(direction, op_start_cycle, cycle);
+}
+
+ccl_qubit_timeline_resource_t::ccl_qubit_timeline_resource_t(
+    const ql::quantum_platform &platform,
+    scheduling_direction_t dir
+) :
+    timeline_resource_t("qubits", dir, platform.resources["qubits"]["count"])
+{
+}
+
+ccl_qubit_timeline_resource_t *ccl_qubit_timeline_resource_t::clone() const & {
+    DOUT("Cloning/copying ccl_qubit_timeline_resource_t");
+    return new ccl_qubit_timeline_resource_t(*this);
+}
+
+ccl_qubit_timeline_resource_t *ccl_qubit_timeline_resource_t::clone() && {
+    DOUT("Cloning/moving ccl_qubit_timeline_resource_t");
+    return new ccl_qubit_timeline_resource_t(std::move(*this));
+}
+
+void ccl_qubit_timeline_resource_t::claims(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform,
+    std::vector<resource_claim_t> &cv,
+    size_t &duration
+) {
+    duration = ccl_get_operation_duration(ins, platform);
+    cv.clear();
+    for (auto q : ins->operands) {
+        cv.push_back(resource_claim_t{q, no_key});
+    }
+}
+
+ccl_qwg_timeline_resource_t::ccl_qwg_timeline_resource_t(
+    const ql::quantum_platform &platform,
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions
+) :
+    timeline_resource_t("qwgs", dir, platform.resources["qwgs"]["count"]),
+    instructions(instructions)
+{
+    qubit2qwg = ccl_qubit2unit(platform, name);
+    for (auto qwg : qubit2qwg) {
+        if (qwg >= count) {
+            JSON_FATAL("qwg " << qwg << " in the connection_map of resource " << name << " is out of range of its count " << count);
+        }
+    }
+}
+
+ccl_qwg_timeline_resource_t *ccl_qwg_timeline_resource_t::clone() const & {
+    DOUT("Cloning/copying ccl_qwg_timeline_resource_t");
+    return new ccl_qwg_timeline_resource_t(*this);
+}
+
+ccl_qwg_timeline_resource_t *ccl_qwg_timeline_resource_t::clone() && {
+    DOUT("Cloning/moving ccl_qwg_timeline_resource_t");
+    return new ccl_qwg_timeline_resource_t(std::move(*this));
+}
+
+void ccl_qwg_timeline_resource_t::claims(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform,
+    std::vector<resource_claim_t> &cv,
+    size_t &duration
+) {
+    const ccl_instruction_desc_t &desc = instructions->get(ins);
+    duration = ccl_get_operation_duration(ins, platform);
+    cv.clear();
+    if (desc.type == ccl_mw_type) {
+        for (auto q : ins->operands) {
+            cv.push_back(resource_claim_t{qubit2qwg[q], desc.operation});
+        }
+    }
+}
+
+ccl_meas_timeline_resource_t::ccl_meas_timeline_resource_t(
+    const ql::quantum_platform &platform,
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions
+) :
+    timeline_resource_t("meas_units", dir, platform.resources["meas_units"]["count"]),
+    instructions(instructions)
+{
+    qubit2meas = ccl_qubit2unit(platform, name);
+    for (auto meas : qubit2meas) {
+        if (meas >= count) {
+            JSON_FATAL("measurement unit " << meas << " in the connection_map of resource " << name << " is out of range of its count " << count);
+        }
+    }
+}
+
+ccl_meas_timeline_resource_t *ccl_meas_timeline_resource_t::clone() const & {
+    DOUT("Cloning/copying ccl_meas_timeline_resource_t");
+    return new ccl_meas_timeline_resource_t(*this);
+}
+
+ccl_meas_timeline_resource_t *ccl_meas_timeline_resource_t::clone() && {
+    DOUT("Cloning/moving ccl_meas_timeline_resource_t");
+    return new ccl_meas_timeline_resource_t(std::move(*this));
+}
+
+// the start cycle is the key, so that only measurements starting in the same cycle overlap
+void ccl_meas_timeline_resource_t::claims(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform,
+    std::vector<resource_claim_t> &cv,
+    size_t &duration
+) {
+    duration = ccl_get_operation_duration(ins, platform);
+    cv.clear();
+    if (instructions->get(ins).type == ccl_readout_type) {
+        for (auto q : ins->operands) {
+            cv.push_back(resource_claim_t{qubit2meas[q], op_start_cycle});
+        }
+    }
+}
+
+ccl_edge_timeline_resource_t::ccl_edge_timeline_resource_t(
+    const ql::quantum_platform &platform,
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions,
+    std::shared_ptr<const ccl_edge_table_t> edges
+) :
+    timeline_resource_t("edges", dir, 0),
+    qubits2edge(edges),
+    instructions(instructions)
+{
+    size_t edge_count = platform.resources[name]["count"];
+    edge2edges = ccl_edge2edges(platform, name, std::max(edge_count, qubits2edge->edge_count));
+    count = edge2edges.size();
+    timeline.resize(count);
+    longest.assign(count, 0);
+}
+
+ccl_edge_timeline_resource_t *ccl_edge_timeline_resource_t::clone() const & {
+    DOUT("Cloning/copying ccl_edge_timeline_resource_t");
+    return new ccl_edge_timeline_resource_t(*this);
+}
+
+ccl_edge_timeline_resource_t *ccl_edge_timeline_resource_t::clone() && {
+    DOUT("Cloning/moving ccl_edge_timeline_resource_t");
+    return new ccl_edge_timeline_resource_t(std::move(*this));
+}
+
+void ccl_edge_timeline_resource_t::claims(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform,
+    std::vector<resource_claim_t> &cv,
+    size_t &duration
+) {
+    duration = ccl_get_operation_duration(ins, platform);
+    cv.clear();
+    if (instructions->get(ins).type == ccl_flux_type) {
+        auto nopers = ins->operands.size();
+        if (nopers == 1) {
+            // single qubit flux operation does not reserve an edge resource
+        } else if (nopers == 2) {
+            auto q0 = ins->operands[0];
+            auto q1 = ins->operands[1];
+            auto edge_no = qubits2edge->get(q0, q1);
+            if (edge_no == ccl_edge_table_t::no_edge) {
+                FATAL("Use of illegal edge: " << q0 << "->" << q1 << " in operation: " << ins->name << " !");
+            }
+            cv.push_back(resource_claim_t{edge_no, no_key});
+            for (auto e : edge2edges[edge_no]) {
+                cv.push_back(resource_claim_t{e, no_key});
+            }
+        } else {
+            FATAL("Incorrect number of operands used in operation: " << ins->name << " !");
+        }
+    }
+}
+
+ccl_detuned_qubits_timeline_resource_t::ccl_detuned_qubits_timeline_resource_t(
+    const ql::quantum_platform &platform,
+    scheduling_direction_t dir,
+    std::shared_ptr<const ccl_instruction_table_t> instructions,
+    std::shared_ptr<const ccl_edge_table_t> edges
+) :
+    timeline_resource_t("detuned_qubits", dir, platform.resources["detuned_qubits"]["count"]),
+    qubitpair2edge(edges),
+    instructions(instructions)
+{
+    edge_detunes_qubits = ccl_edge_detunes_qubits(platform, name, qubitpair2edge->edge_count);
+    for (auto &qv : edge_detunes_qubits) {
+        for (auto q : qv) {
+            if (q >= count) {
+                JSON_FATAL("qubit " << q << " in the connection_map of resource " << name << " is out of range of its count " << count);
+            }
+        }
+    }
+}
+
+ccl_detuned_qubits_timeline_resource_t *ccl_detuned_qubits_timeline_resource_t::clone() const & {
+    DOUT("Cloning/copying ccl_detuned_qubits_timeline_resource_t");
+    return new ccl_detuned_qubits_timeline_resource_t(*this);
+}
+
+ccl_detuned_qubits_timeline_resource_t *ccl_detuned_qubits_timeline_resource_t::clone() && {
+    DOUT("Cloning/moving ccl_detuned_qubits_timeline_resource_t");
+    return new ccl_detuned_qubits_timeline_resource_t(std::move(*this));
+}
+
+// the operation type is the key, so that a detuned qubit can be detuned by several flux gates at the same time,
+// and a rotated qubit can do several rotations (sequentially, by the qubits resource) while not detuned
+void ccl_detuned_qubits_timeline_resource_t::claims(
+    size_t op_start_cycle,
+    ql::gate *ins,
+    const ql::quantum_platform &platform,
+    std::vector<resource_claim_t> &cv,
+    size_t &duration
+) {
+    ccl_operation_type_t operation_type = instructions->get(ins).type;
+    duration = ccl_get_operation_duration(ins, platform);
+    cv.clear();
+    if (operation_type == ccl_flux_type) {
+        auto nopers = ins->operands.size();
+        if (nopers == 1) {
+            // single qubit flux operation does not reserve a detuned qubits resource
+        } else if (nopers == 2) {
+            auto q0 = ins->operands[0];
+            auto q1 = ins->operands[1];
+            auto edge_no = qubitpair2edge->get(q0, q1);
+            if (edge_no == ccl_edge_table_t::no_edge) {
+                EOUT("Use of illegal edge: " << q0 << "->" << q1 << " in operation: " << ins->name << " !");
+                throw ql::exception("[x] Error : Use of illegal edge"+std::to_string(q0)+"->"+std::to_string(q1)+"in operation:"+ins->name+" !",false);
+            }
+            for (auto q : edge_detunes_qubits[edge_no]) {
+                cv.push_back(resource_claim_t{q, size_t(ccl_flux_type)});
+            }
+        } else {
+            FATAL("Incorrect number of operands used in operation: " << ins->name << " !");
+        }
+    } else if (operation_type == ccl_mw_type) {
+        for (auto q : ins->operands) {
+            cv.push_back(resource_claim_t{q, size_t(ccl_mw_type)});
+        }
+    }
+}
+
 // Allocate those resources that were specified in the config file.
 // Those that are not specified, are not allocatd, so are not used in scheduling/mapping.
 // The resource names tested below correspond to the names of the resources sections in the config file.
@@ -662,25 +1134,45 @@ cc_light_resource_manager_t::cc_light_resource_manager_t(
 {
     DOUT("Constructing (platform,dir) parameterized platform_resource_manager_t");
     DOUT("New one for direction " << dir << " with no of resources : " << platform.resources.size() );
+    // what the resources need of the instructions and the topology, resolved once for all of them
+    auto instructions = std::make_shared<const ccl_instruction_table_t>(platform);
+    auto edges = std::make_shared<const ccl_edge_table_t>(platform);
+    bool timeline = (ql::options::get("scheduler_resources") == "timeline");
     for (json::const_iterator it = platform.resources.begin(); it != platform.resources.end(); ++it) {
         // COUT(it.key() << " : " << it.value() << "\n");
         std::string n = it.key();
 
         // DOUT("... about to create " << n << " resource");
-        if (n == "qubits") {
+        if (timeline) {
+            resource_t * ares;
+            if (n == "qubits") {
+                ares = new ccl_qubit_timeline_resource_t(platform, dir);
+            } else if (n == "qwgs") {
+                ares = new ccl_qwg_timeline_resource_t(platform, dir, instructions);
+            } else if (n == "meas_units") {
+                ares = new ccl_meas_timeline_resource_t(platform, dir, instructions);
+            } else if (n == "edges") {
+                ares = new ccl_edge_timeline_resource_t(platform, dir, instructions, edges);
+            } else if (n == "detuned_qubits") {
+                ares = new ccl_detuned_qubits_timeline_resource_t(platform, dir, instructions, edges);
+            } else {
+                FATAL("Error : Un-modelled resource, i.e. resource not supported by implementation: '" << n << "'");
+            }
+            resource_ptrs.push_back( ares );
+        } else if (n == "qubits") {
             resource_t * ares = new ccl_qubit_resource_t(platform, dir);
             resource_ptrs.push_back( ares );
         } else if (n == "qwgs") {
-            resource_t * ares = new ccl_qwg_resource_t(platform, dir);
+            resource_t * ares = new ccl_qwg_resource_t(platform, dir, instructions);
             resource_ptrs.push_back( ares );
         } else if (n == "meas_units") {
-            resource_t * ares = new ccl_meas_resource_t(platform, dir);
+            resource_t * ares = new ccl_meas_resource_t(platform, dir, instructions);
             resource_ptrs.push_back( ares );
         } else if (n == "edges") {
-            resource_t * ares = new ccl_edge_resource_t(platform, dir);
+            resource_t * ares = new ccl_edge_resource_t(platform, dir, instructions, edges);
             resource_ptrs.push_back( ares );
         } else if (n == "detuned_qubits") {
-            resource_t * ares = new ccl_detuned_qubits_resource_t(platform, dir);
+            resource_t * ares = new ccl_detuned_qubits_resource_t(platform, dir, instructions, edges);
             resource_ptrs.push_back( ares );
         } else {
             FATAL("Error : Un-modelled resource, i.e. resource not supported by implementation: '" << n << "'");
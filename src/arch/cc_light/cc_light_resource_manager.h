@@ -12,6 +12,8 @@
 #include <fstream>
 #include <vector>
 #include <string>
+#include <memory>
+#include <unordered_map>
 #include "json.h"
 #include "resource_manager.h"
 
@@ -32,6 +34,49 @@ std::string ccl_get_operation_type(ql::gate *ins, const ql::quantum_platform &pl
 // operation name is used to know which operations are the same when one qwg steers several qubits using the vsm
 std::string ccl_get_operation_name(ql::gate *ins, const ql::quantum_platform &platform);
 
+// operation type as an enum, for the types that the resources distinguish
+typedef enum {
+    ccl_other_type,
+    ccl_mw_type,
+    ccl_flux_type,
+    ccl_readout_type
+} ccl_operation_type_t;
+
+// what the resources need to know of an instruction, resolved once from its instruction_settings
+typedef struct {
+    ccl_operation_type_t    type;           // from ccl_get_operation_type
+    size_t                  operation;      // ccl_get_operation_name interned as a small number
+} ccl_instruction_desc_t;
+
+// the descriptors of all instructions of the platform, indexed by the gate's opcode, or else by its name;
+// this is made once by a cc_light_resource_manager_t and shared by its resources and all their copies,
+// so that available and reserve don't access the instruction settings
+class ccl_instruction_table_t {
+public:
+    std::unordered_map<std::string, ccl_instruction_desc_t> desc;   // desc[gate name] == its descriptor
+    std::vector<ccl_instruction_desc_t> opdesc;                     // opdesc[opcode] == desc[name of opcode], when in desc
+    std::vector<bool> has_opdesc;                                   // whether opdesc[opcode] is valid
+    size_t operation_count;                                         // number of different operation names
+
+    explicit ccl_instruction_table_t(const ql::quantum_platform &platform);
+
+    const ccl_instruction_desc_t &get(const ql::gate *ins) const;
+};
+
+// the edge between two qubits of the topology, (q0,q1) ordered, as a dense table;
+// so that the resources on edges don't need maps from qubit pairs
+class ccl_edge_table_t {
+public:
+    size_t              nq;
+    std::vector<size_t> edge;       // edge[q0*nq+q1] == edge from q0 to q1, or no_edge
+    size_t              edge_count; // edge ids are less than this
+    static const size_t no_edge = ~size_t(0);
+
+    explicit ccl_edge_table_t(const ql::quantum_platform &platform);
+
+    size_t get(size_t q0, size_t q1) const;
+};
+
 
 // ============ classes of resources that _may_ appear in a configuration file
 // these are a superset of those allocated by the cc_light_resource_manager_t constructor below
@@ -50,6 +95,7 @@ public:
 
     bool available(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
     void reserve(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
+    size_t next_available_cycle(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
 };
 
 // Single-qubit rotation gates (instructions of 'mw' type) are controlled by qwgs.
@@ -65,16 +111,22 @@ public:
     // but a new y must wait until the last x has finished;
     // the bug was that a new x was always ok (so also when starting earlier than cycle i)
 
-    std::vector<std::string> operations;    // with operation_name==operations[qwg]
-    std::map<size_t,size_t> qubit2qwg;      // on qwg==qubit2qwg[q]
+    std::vector<size_t> operations;         // with operation (interned operation_name)==operations[qwg]
+    std::vector<size_t> qubit2qwg;          // on qwg==qubit2qwg[q]
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
 
-    ccl_qwg_resource_t(const ql::quantum_platform & platform, scheduling_direction_t dir);
+    ccl_qwg_resource_t(
+        const ql::quantum_platform & platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions
+    );
 
     ccl_qwg_resource_t* clone() const & override;
     ccl_qwg_resource_t* clone() && override;
 
     bool available(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
     void reserve(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
+    size_t next_available_cycle(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
 };
 
 // Single-qubit measurements (instructions of 'readout' type) are controlled by measurement units.
@@ -84,15 +136,21 @@ class ccl_meas_resource_t : public resource_t {
 public:
     std::vector<size_t> fromcycle;  // last measurement start cycle
     std::vector<size_t> tocycle;    // is busy till cycle
-    std::map<size_t,size_t> qubit2meas;
+    std::vector<size_t> qubit2meas; // on measurement unit==qubit2meas[q]
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
 
-    ccl_meas_resource_t(const ql::quantum_platform & platform, scheduling_direction_t dir);
+    ccl_meas_resource_t(
+        const ql::quantum_platform & platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions
+    );
 
     ccl_meas_resource_t* clone() const & override;
     ccl_meas_resource_t* clone() && override;
 
     bool available(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
     void reserve(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
+    size_t next_available_cycle(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
 };
 
 // Two-qubit flux gates only operate on neighboring qubits, i.e. qubits connected by an edge.
@@ -110,17 +168,23 @@ public:
     // fwd: edge is busy till cycle=state[edge], i.e. all cycles < state[edge] it is busy, i.e. start_cycle must be >= state[edge]
     // bwd: edge is busy from cycle=state[edge], i.e. all cycles >= state[edge] it is busy, i.e. start_cycle+duration must be <= state[edge]
     std::vector<size_t> state;                          // machine state recording the cycles that given edge is free/busy
-    typedef std::pair<size_t, size_t> qubits_pair_t;
-    std::map< qubits_pair_t, size_t > qubits2edge;      // constant helper table to find edge between a pair of qubits
-    std::map<size_t, std::vector<size_t>> edge2edges;  // constant "edges" table from configuration file
+    std::shared_ptr<const ccl_edge_table_t> qubits2edge;    // constant helper table to find edge between a pair of qubits
+    std::vector<std::vector<size_t>> edge2edges;        // constant "edges" table from configuration file
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
 
-    ccl_edge_resource_t(const ql::quantum_platform &platform, scheduling_direction_t dir);
+    ccl_edge_resource_t(
+        const ql::quantum_platform &platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions,
+        std::shared_ptr<const ccl_edge_table_t> edges
+    );
 
     ccl_edge_resource_t* clone() const & override;
     ccl_edge_resource_t* clone() && override;
 
     bool available(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
     void reserve(size_t op_start_cycle, ql::gate * ins, const ql::quantum_platform & platform) override;
+    size_t next_available_cycle(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
 };
 
 // A two-qubit flux gate lowers the frequency of its source qubit to get near the freq of its target qubit.
@@ -149,19 +213,118 @@ class ccl_detuned_qubits_resource_t : public resource_t {
 public:
     std::vector<size_t> fromcycle;                              // qubit q is busy from cycle fromcycle[q]
     std::vector<size_t> tocycle;                                // till cycle tocycle[q]
-    std::vector<std::string> operations;                        // with an operation of operation_type==operations[q]
+    std::vector<ccl_operation_type_t> operations;               // with an operation of operation_type==operations[q]
 
-    typedef std::pair<size_t, size_t> qubits_pair_t;
-    std::map<qubits_pair_t, size_t> qubitpair2edge;           // map: pair of qubits to edge (from grid configuration)
-    std::map<size_t, std::vector<size_t>> edge_detunes_qubits; // map: edge to vector of qubits that edge detunes (resource desc.)
+    std::shared_ptr<const ccl_edge_table_t> qubitpair2edge;     // pair of qubits to edge (from grid configuration)
+    std::vector<std::vector<size_t>> edge_detunes_qubits;       // edge to vector of qubits that edge detunes (resource desc.)
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
 
-    ccl_detuned_qubits_resource_t(const ql::quantum_platform &platform, scheduling_direction_t dir);
+    ccl_detuned_qubits_resource_t(
+        const ql::quantum_platform &platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions,
+        std::shared_ptr<const ccl_edge_table_t> edges
+    );
 
     ccl_detuned_qubits_resource_t* clone() const & override;
     ccl_detuned_qubits_resource_t* clone() && override;
 
     bool available(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
     void reserve(size_t op_start_cycle, ql::gate * ins, const ql::quantum_platform & platform) override;
+    size_t next_available_cycle(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform) override;
+};
+
+// ============ the same resources, as timelines of reservations, see timeline_resource_t
+// these are allocated instead of the ones above when option scheduler_resources is "timeline";
+// each describes what a gate claims of the resource, matching what the corresponding one above checks and reserves,
+// but since reservations are kept, gates can be backfilled in holes left between earlier reservations
+
+// Each qubit by a gate operating on it.
+class ccl_qubit_timeline_resource_t : public timeline_resource_t {
+public:
+    ccl_qubit_timeline_resource_t(const ql::quantum_platform &platform, scheduling_direction_t dir);
+
+    ccl_qubit_timeline_resource_t* clone() const & override;
+    ccl_qubit_timeline_resource_t* clone() && override;
+
+    void claims(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform, std::vector<resource_claim_t> &cv, size_t &duration) override;
+};
+
+// The qwg of each operand qubit by a 'mw' gate; the same operation may overlap.
+class ccl_qwg_timeline_resource_t : public timeline_resource_t {
+public:
+    std::vector<size_t> qubit2qwg;
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
+
+    ccl_qwg_timeline_resource_t(
+        const ql::quantum_platform &platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions
+    );
+
+    ccl_qwg_timeline_resource_t* clone() const & override;
+    ccl_qwg_timeline_resource_t* clone() && override;
+
+    void claims(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform, std::vector<resource_claim_t> &cv, size_t &duration) override;
+};
+
+// The measurement unit of each operand qubit by a 'readout' gate; measurements starting in the same cycle may overlap.
+class ccl_meas_timeline_resource_t : public timeline_resource_t {
+public:
+    std::vector<size_t> qubit2meas;
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
+
+    ccl_meas_timeline_resource_t(
+        const ql::quantum_platform &platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions
+    );
+
+    ccl_meas_timeline_resource_t* clone() const & override;
+    ccl_meas_timeline_resource_t* clone() && override;
+
+    void claims(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform, std::vector<resource_claim_t> &cv, size_t &duration) override;
+};
+
+// The edge of a two-qubit 'flux' gate and the edges that it blocks.
+class ccl_edge_timeline_resource_t : public timeline_resource_t {
+public:
+    std::shared_ptr<const ccl_edge_table_t> qubits2edge;
+    std::vector<std::vector<size_t>> edge2edges;
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
+
+    ccl_edge_timeline_resource_t(
+        const ql::quantum_platform &platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions,
+        std::shared_ptr<const ccl_edge_table_t> edges
+    );
+
+    ccl_edge_timeline_resource_t* clone() const & override;
+    ccl_edge_timeline_resource_t* clone() && override;
+
+    void claims(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform, std::vector<resource_claim_t> &cv, size_t &duration) override;
+};
+
+// The qubits detuned by a two-qubit 'flux' gate and the operand qubits of a 'mw' gate;
+// 'flux' gates may overlap each other and 'mw' gates may overlap each other.
+class ccl_detuned_qubits_timeline_resource_t : public timeline_resource_t {
+public:
+    std::shared_ptr<const ccl_edge_table_t> qubitpair2edge;
+    std::vector<std::vector<size_t>> edge_detunes_qubits;
+    std::shared_ptr<const ccl_instruction_table_t> instructions;
+
+    ccl_detuned_qubits_timeline_resource_t(
+        const ql::quantum_platform &platform,
+        scheduling_direction_t dir,
+        std::shared_ptr<const ccl_instruction_table_t> instructions,
+        std::shared_ptr<const ccl_edge_table_t> edges
+    );
+
+    ccl_detuned_qubits_timeline_resource_t* clone() const & override;
+    ccl_detuned_qubits_timeline_resource_t* clone() && override;
+
+    void claims(size_t op_start_cycle, ql::gate *ins, const ql::quantum_platform &platform, std::vector<resource_claim_t> &cv, size_t &duration) override;
 };
 
 // ============ platform specific resource_manager matching config file resources sections with resource classes above
@@ -67,12 +67,10 @@ static void insert_buffer_delays_kernel(
         for (auto secIt = abundle.parallel_sections.begin();
              secIt != abundle.parallel_sections.end(); ++secIt) {
             for (auto insIt = secIt->begin(); insIt != secIt->end(); ++insIt) {
-                auto &id = (*insIt)->name;
+                auto ip = platform.instructions->get(*insIt);
                 std::string op_type("none");
-                if (platform.instruction_settings.count(id) > 0) {
-                    if (platform.instruction_settings[id].count("type") > 0) {
-                        op_type = platform.instruction_settings[id]["type"].get<std::string>();
-                    }
+                if (ip != nullptr && ip->has_type) {
+                    op_type = ip->type;
                 }
                 operations_curr_bundle.push_back(op_type);
             }
@@ -107,9 +105,9 @@ void insert_buffer_delays(
     ql::report_statistics(programp, platform, "in", passname, "# ");
     ql::report_qasm(programp, platform, "in", passname);
 
-    for (size_t k = 0; k < programp->kernels.size(); ++k) {
-        insert_buffer_delays_kernel(programp->kernels[k], platform);
-    }
+    for_each_kernel(programp, [&platform](ql::quantum_kernel &kernel) {
+        insert_buffer_delays_kernel(kernel, platform);
+    });
 
     ql::report_statistics(programp, platform, "out", passname, "# ");
     ql::report_qasm(programp, platform, "out", passname);
@@ -1,9 +1,100 @@
 #include "circuit.h"
 
 #include <iostream>
+#include <iterator>
+
+#include "platform.h"
 
 namespace ql {
 
+gate_arena::gate_arena(std::shared_ptr<const instruction_table> instructions) :
+    used(block_size), instructions(instructions)
+{
+}
+
+gate_arena::~gate_arena() {
+    for (auto it = gates.rbegin(); it != gates.rend(); ++it) {
+        (*it)->~gate();
+    }
+}
+
+size_t gate_arena::size() const {
+    return gates.size();
+}
+
+void gate_arena::adopt(gate_arena &other) {
+    if (&other == this) {
+        return;
+    }
+    std::lock(mutex, other.mutex);
+    std::lock_guard<std::mutex> l1(mutex, std::adopt_lock);
+    std::lock_guard<std::mutex> l2(other.mutex, std::adopt_lock);
+    // other's blocks go before the last one, which can then still be filled
+    auto pos = (blocks.empty() ? blocks.end() : blocks.end() - 1);
+    blocks.insert(pos, std::make_move_iterator(other.blocks.begin()), std::make_move_iterator(other.blocks.end()));
+    gates.insert(gates.end(), other.gates.begin(), other.gates.end());
+    other.blocks.clear();
+    other.gates.clear();
+    other.used = block_size;
+}
+
+// bump allocation: take the next size bytes of the last block, aligned, or start a new block;
+// new char[] memory is aligned for any gate, so the start of a block is as well
+void *gate_arena::allocate(size_t size, size_t alignment) {
+    size_t offset = (used + alignment - 1) / alignment * alignment;
+    if (offset + size > block_size) {
+        if (size > block_size) {
+            // a block of its own, kept before the last one, which can then still be filled
+            auto it = blocks.emplace(blocks.empty() ? blocks.end() : blocks.end() - 1, new char[size]);
+            return it->get();
+        }
+        blocks.emplace_back(new char[block_size]);
+        offset = 0;
+    }
+    used = offset + size;
+    return blocks.back().get() + offset;
+}
+
+void gate_arena::intern(gate *gp) const {
+    if (gp->opcode < 0 && instructions) {
+        gp->opcode = instructions->find(gp->name);
+    }
+}
+
+circuit_view::circuit_view(const circuit &c) {
+    size_t n = c.size();
+    size_t noperands = 0;
+    for (auto gp : c) {
+        noperands += gp->operands.size();
+    }
+    gates.reserve(n);
+    type.reserve(n);
+    opcode.reserve(n);
+    duration.reserve(n);
+    cycle.reserve(n);
+    operand_begin.reserve(n+1);
+    operands.reserve(noperands);
+
+    for (auto gp : c) {
+        gates.push_back(gp);
+        type.push_back(gp->type());
+        opcode.push_back(gp->opcode);
+        duration.push_back(gp->duration);
+        cycle.push_back(gp->cycle);
+        operand_begin.push_back(operands.size());
+        operands.insert(operands.end(), gp->operands.begin(), gp->operands.end());
+    }
+    operand_begin.push_back(operands.size());
+}
+
+size_t circuit_view::size() const {
+    return gates.size();
+}
+
+size_t circuit_view::operand_count(size_t i) const {
+    return operand_begin[i+1] - operand_begin[i];
+}
+
 void print(const circuit &c) {
     std::cout << "-------------------" << std::endl;
     for (auto gate : c) {
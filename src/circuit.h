@@ -8,6 +8,10 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
 
 #include "gate.h"
 
@@ -15,6 +19,84 @@ namespace ql {
 
 typedef std::vector<gate*> circuit;
 
+class instruction_table;
+
+/**
+ * owner of the gates that the circuits of a kernel refer to (see quantum_kernel::arena)
+ *
+ * Gates are created in it by bump allocation in large blocks, and live until the arena is destroyed,
+ * i.e. when the last kernel sharing it is; then they are destroyed and their memory is released at once.
+ * A circuit just refers to gates, so passes can copy, reorder and drop gate pointers freely,
+ * as long as the gates are of the arena of the kernel they are put in.
+ * Creating gates is thread-safe, since kernels processed in parallel may share an arena.
+ * A gate created without an opcode gets the one of its name in the instruction table, if any.
+ * A pass that creates many gates on trial, in a scratch copy of a kernel, gives that copy an arena of its own,
+ * so that the gates of a discarded trial are released with it, and adopts the arena of the trial that it keeps.
+ */
+class gate_arena {
+public:
+    explicit gate_arena(std::shared_ptr<const instruction_table> instructions = nullptr);
+    gate_arena(const gate_arena &) = delete;
+    gate_arena &operator=(const gate_arena &) = delete;
+    ~gate_arena();
+
+    // create a gate of class G in the arena, constructed from args
+    template<class G, class... Args>
+    G *create(Args&&... args) {
+        std::lock_guard<std::mutex> l(mutex);
+        G *gp = new (allocate(sizeof(G), alignof(G))) G(std::forward<Args>(args)...);
+        gates.push_back(gp);
+        intern(gp);
+        return gp;
+    }
+
+    // number of gates created in the arena
+    size_t size() const;
+
+    // take over the gates of other, which is left empty, so that they live as long as this arena
+    void adopt(gate_arena &other);
+
+private:
+    static const size_t block_size = 64*1024;   // bytes per block; larger gates get a block of their own
+
+    void *allocate(size_t size, size_t alignment);
+    void intern(gate *gp) const;
+
+    std::vector<std::unique_ptr<char[]>> blocks;    // memory of the gates, the last one being filled
+    size_t          used;                           // number of bytes used in the last block
+    std::vector<gate*> gates;                       // the gates, in order of creation, to destroy them
+    std::mutex      mutex;
+    std::shared_ptr<const instruction_table> instructions;  // of the platform of the kernel, nullptr if none
+};
+
+/**
+ * read-only struct-of-arrays view of a circuit, for analysis passes
+ *
+ * Built in a single pass over the circuit, it has the attributes of gate i that analysis passes read
+ * in contiguous arrays, so that those passes are linear scans instead of chasing a gate pointer
+ * and doing a virtual call per gate.
+ * The operands of gate i are operands[operand_begin[i]] .. operands[operand_begin[i+1]-1].
+ * The view is a snapshot: it is invalid once the circuit or its gates change,
+ * so a pass builds it when it starts and does not keep it.
+ */
+class circuit_view {
+public:
+    explicit circuit_view(const circuit &c);
+
+    std::vector<const gate*>  gates;        // gates[i] == c[i], for what is not in the arrays
+    std::vector<gate_type_t>  type;         // gate type, as by gate::type()
+    std::vector<int>          opcode;       // index in the instruction table, -1 if none
+    std::vector<size_t>       duration;     // in ns
+    std::vector<size_t>       cycle;        // MAX_CYCLE when not scheduled
+    std::vector<size_t>       operand_begin;  // operands of gate i start at operand_begin[i]; size()+1 entries
+    std::vector<size_t>       operands;     // the qubit operands of all gates, concatenated
+
+    size_t size() const;
+
+    // number of qubit operands of gate i
+    size_t operand_count(size_t i) const;
+};
+
 void print(const circuit &c);
 
 /**
@@ -34,6 +34,7 @@ public:
         ql::circuit input_circuit = kernel.c;
         kernel.c.clear();
 
+        opcode2cs.assign(platform.instructions->size(), -2);   // -2: not yet computed
         cliffstate.resize(nq, 0);       // 0 is identity; for all qubits accumulated state is set to identity
         cliffcycles.resize(nq, 0);      // for all qubits, no accumulated cycles
         total_saved = 0;                // reset saved, just for reporting
@@ -85,8 +86,7 @@ public:
             } else {
                 // unary quantum gates like x/y/z/h/xm90/y90/s/wait/meas/prepz
                 size_t q = gp->operands[0];
-                std::string gname = gp->name;
-                int cs = string2cs(gname);
+                int cs = gate2cs(gp);
                 if (cs != -1) {
                     // unary quantum clifford gates like x/y/z/h/xm90/y90/s/...
                     // don't emit gate but accumulate gate in cliffstate
@@ -118,6 +118,7 @@ private:
     std::vector<int>    cliffstate;                    // current accumulated clifford state per qubit
     std::vector<size_t> cliffcycles;                   // current accumulated clifford cycles per qubit
     size_t  total_saved;                               // total number of cycles saved per kernel
+    std::vector<int>    opcode2cs;                     // string2cs of each instruction name by opcode, when computed
 
     // create gate sequences for all accumulated cliffords, output them and reset state
     void sync_all(quantum_kernel &k) {
@@ -200,6 +201,18 @@ private:
         else return -1;
     }
 
+    // find the clifford state of the given gate, computing it once per opcode
+    int gate2cs(const ql::gate *gp) {
+        int opcode = gp->opcode;
+        if (opcode < 0 || size_t(opcode) >= opcode2cs.size()) {
+            return string2cs(gp->name);
+        }
+        if (opcode2cs[opcode] == -2) {
+            opcode2cs[opcode] = string2cs(gp->name);
+        }
+        return opcode2cs[opcode];
+    }
+
     // find the duration of the gate sequence corresponding to given clifford state
     // should be implemented using configuration file, searching for created gates and retrieving durations
     static size_t cs2cycles(int cs) {
@@ -284,10 +297,10 @@ void clifford_optimize(
     ql::report_statistics(programp, platform, "in", passname, "# ");
     ql::report_qasm(programp, platform, "in", passname);
 
-    Clifford cliff;
-    for (auto &kernel : programp->kernels) {
+    for_each_kernel(programp, [&platform, &passname](quantum_kernel &kernel) {
+        Clifford cliff;
         cliff.clifford_optimize_kernel(kernel, platform, passname);
-    }
+    });
 
     ql::report_statistics(programp, platform, "out", passname, "# ");
     ql::report_qasm(programp, platform, "out", passname);
@@ -24,8 +24,10 @@ static void decompose_toffoli_kernel(
 
         ql::quantum_kernel toff_kernel("toff_kernel");
         toff_kernel.instruction_map = kernel.instruction_map;
+        toff_kernel.instructions = kernel.instructions;
         toff_kernel.qubit_count = kernel.qubit_count;
         toff_kernel.cycle_time = kernel.cycle_time;
+        toff_kernel.arena = kernel.arena;   // its gates are put in kernel's circuit
 
         if (gtype == __toffoli_gate__) {
             size_t cq1 = goperands[0];
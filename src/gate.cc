@@ -1,10 +1,13 @@
 #include "gate.h"
 
+#include <algorithm>
 #include <cctype>
+#include <memory>
+#include <mutex>
 
 namespace ql {
 
-identity::identity(size_t q) : m(identity_c) {
+identity::identity(size_t q) {
     name = "i";
     duration = 40;
     operands.push_back(q);
@@ -19,10 +22,10 @@ gate_type_t identity::type() const {
 }
 
 cmat_t identity::mat() const {
-    return m;
+    return cmat_t(identity_c);
 }
 
-hadamard::hadamard(size_t q) : m(hadamard_c) {
+hadamard::hadamard(size_t q) {
     name = "h";
     duration = 40;
     operands.push_back(q);
@@ -37,10 +40,10 @@ gate_type_t hadamard::type() const {
 }
 
 cmat_t hadamard::mat() const {
-    return m;
+    return cmat_t(hadamard_c);
 }
 
-phase::phase(size_t q) : m(phase_c) {
+phase::phase(size_t q) {
     name = "s";
     duration = 40;
     operands.push_back(q);
@@ -55,13 +58,13 @@ gate_type_t phase::type() const {
 }
 
 cmat_t phase::mat() const {
-    return m;
+    return cmat_t(phase_c);
 }
 
 /**
  * phase dag
  */
-phasedag::phasedag(size_t q) : m(phasedag_c) {
+phasedag::phasedag(size_t q) {
     name = "sdag";
     duration = 40;
     operands.push_back(q);
@@ -76,7 +79,7 @@ gate_type_t phasedag::type() const {
 }
 
 cmat_t phasedag::mat() const {
-    return m;
+    return cmat_t(phasedag_c);
 }
 
 rx::rx(size_t q, double theta) {
@@ -84,10 +87,6 @@ rx::rx(size_t q, double theta) {
     duration = 40;
     angle = theta;
     operands.push_back(q);
-    m(0,0) = cos(angle/2);
-    m(0,1) = complex_t(0,-sin(angle/2));
-    m(1,0) = complex_t(0,-sin(angle/2));
-    m(1,1) = cos(angle/2);
 }
 
 instruction_t rx::qasm() const {
@@ -99,6 +98,11 @@ gate_type_t rx::type() const {
 }
 
 cmat_t rx::mat() const {
+    cmat_t m;
+    m(0,0) = cos(angle/2);
+    m(0,1) = complex_t(0,-sin(angle/2));
+    m(1,0) = complex_t(0,-sin(angle/2));
+    m(1,1) = cos(angle/2);
     return m;
 }
 
@@ -107,10 +111,6 @@ ry::ry(size_t q, double theta) {
     duration = 40;
     angle = theta;
     operands.push_back(q);
-    m(0,0) = cos(angle/2);
-    m(0,1) = -sin(angle/2);
-    m(1,0) = sin(angle/2);
-    m(1,1) = cos(angle/2);
 }
 
 instruction_t ry::qasm() const {
@@ -122,6 +122,11 @@ gate_type_t ry::type() const {
 }
 
 cmat_t ry::mat() const {
+    cmat_t m;
+    m(0,0) = cos(angle/2);
+    m(0,1) = -sin(angle/2);
+    m(1,0) = sin(angle/2);
+    m(1,1) = cos(angle/2);
     return m;
 }
 
@@ -130,10 +135,6 @@ rz::rz(size_t q, double theta) {
     duration = 40;
     angle = theta;
     operands.push_back(q);
-    m(0,0) = complex_t(cos(-angle/2), sin(-angle/2));
-    m(0,1) = 0;
-    m(1,0) = 0;
-    m(1,1) =  complex_t(cos(angle/2), sin(angle/2));
 }
 
 instruction_t rz::qasm() const {
@@ -145,10 +146,15 @@ gate_type_t rz::type() const {
 }
 
 cmat_t rz::mat() const {
+    cmat_t m;
+    m(0,0) = complex_t(cos(-angle/2), sin(-angle/2));
+    m(0,1) = 0;
+    m(1,0) = 0;
+    m(1,1) =  complex_t(cos(angle/2), sin(angle/2));
     return m;
 }
 
-t::t(size_t q) : m(t_c) {
+t::t(size_t q) {
     name = "t";
     duration = 40;
     operands.push_back(q);
@@ -163,10 +169,10 @@ gate_type_t t::type() const {
 }
 
 cmat_t t::mat() const {
-    return m;
+    return cmat_t(t_c);
 }
 
-tdag::tdag(size_t q) : m(tdag_c) {
+tdag::tdag(size_t q) {
     name = "tdag";
     duration = 40;
     operands.push_back(q);
@@ -181,10 +187,10 @@ gate_type_t tdag::type() const {
 }
 
 cmat_t tdag::mat() const {
-    return m;
+    return cmat_t(tdag_c);
 }
 
-pauli_x::pauli_x(size_t q) : m(pauli_x_c) {
+pauli_x::pauli_x(size_t q) {
     name = "x";
     duration = 40;
     operands.push_back(q);
@@ -199,10 +205,10 @@ gate_type_t pauli_x::type() const {
 }
 
 cmat_t pauli_x::mat() const {
-    return m;
+    return cmat_t(pauli_x_c);
 }
 
-pauli_y::pauli_y(size_t q) : m(pauli_y_c) {
+pauli_y::pauli_y(size_t q) {
     name = "y";
     duration = 40;
     operands.push_back(q);
@@ -217,10 +223,10 @@ gate_type_t pauli_y::type() const {
 }
 
 cmat_t pauli_y::mat() const {
-    return m;
+    return cmat_t(pauli_y_c);
 }
 
-pauli_z::pauli_z(size_t q) : m(pauli_z_c) {
+pauli_z::pauli_z(size_t q) {
     name = "z";
     duration = 40;
     operands.push_back(q);
@@ -235,10 +241,10 @@ gate_type_t pauli_z::type() const {
 }
 
 cmat_t pauli_z::mat() const {
-    return m;
+    return cmat_t(pauli_z_c);
 }
 
-rx90::rx90(size_t q) : m(rx90_c) {
+rx90::rx90(size_t q) {
     name = "x90";
     duration = 40;
     operands.push_back(q);
@@ -253,10 +259,10 @@ gate_type_t rx90::type() const {
 }
 
 cmat_t rx90::mat() const {
-    return m;
+    return cmat_t(rx90_c);
 }
 
-mrx90::mrx90(size_t q) : m(mrx90_c) {
+mrx90::mrx90(size_t q) {
     name = "mx90";
     duration = 40;
     operands.push_back(q);
@@ -271,10 +277,10 @@ gate_type_t mrx90::type() const {
 }
 
 cmat_t mrx90::mat() const {
-    return m;
+    return cmat_t(mrx90_c);
 }
 
-rx180::rx180(size_t q) : m(rx180_c) {
+rx180::rx180(size_t q) {
     name = "x180";
     duration = 40;
     operands.push_back(q);
@@ -289,10 +295,10 @@ gate_type_t rx180::type() const {
 }
 
 cmat_t rx180::mat() const {
-    return m;
+    return cmat_t(rx180_c);
 }
 
-ry90::ry90(size_t q) : m(ry90_c) {
+ry90::ry90(size_t q) {
     name = "y90";
     duration = 40;
     operands.push_back(q);
@@ -307,10 +313,10 @@ gate_type_t ry90::type() const {
 }
 
 cmat_t ry90::mat() const {
-    return m;
+    return cmat_t(ry90_c);
 }
 
-mry90::mry90(size_t q) : m(mry90_c) {
+mry90::mry90(size_t q) {
     name = "my90";
     duration = 40;
     operands.push_back(q);
@@ -325,10 +331,10 @@ gate_type_t mry90::type() const {
 }
 
 cmat_t mry90::mat() const {
-    return m;
+    return cmat_t(mry90_c);
 }
 
-ry180::ry180(size_t q) : m(ry180_c) {
+ry180::ry180(size_t q) {
     name = "y180";
     duration = 40;
     operands.push_back(q);
@@ -343,16 +349,16 @@ gate_type_t ry180::type() const {
 }
 
 cmat_t ry180::mat() const {
-    return m;
+    return cmat_t(ry180_c);
 }
 
-measure::measure(size_t q) : m(identity_c) {
+measure::measure(size_t q) {
     name = "measure";
     duration = 40;
     operands.push_back(q);
 }
 
-measure::measure(size_t q, size_t c) : m(identity_c) {
+measure::measure(size_t q, size_t c) {
     name = "measure";
     duration = 40;
     operands.push_back(q);
@@ -375,10 +381,10 @@ gate_type_t measure::type() const {
 }
 
 cmat_t measure::mat() const {
-    return m;
+    return cmat_t(identity_c);
 }
 
-prepz::prepz(size_t q) : m(identity_c) {
+prepz::prepz(size_t q) {
     name = "prep_z";
     duration = 40;
     operands.push_back(q);
@@ -393,10 +399,10 @@ gate_type_t prepz::type() const {
 }
 
 cmat_t prepz::mat() const {
-    return m;
+    return cmat_t(identity_c);
 }
 
-cnot::cnot(size_t q1, size_t q2) : m(cnot_c) {
+cnot::cnot(size_t q1, size_t q2) {
     name = "cnot";
     duration = 80;
     operands.push_back(q1);
@@ -413,10 +419,10 @@ gate_type_t cnot::type() const {
 }
 
 cmat_t cnot::mat() const {
-    return m;
+    return cmat_t(cnot_c);
 }
 
-cphase::cphase(size_t q1, size_t q2) : m(cphase_c) {
+cphase::cphase(size_t q1, size_t q2) {
     name = "cz";
     duration = 80;
     operands.push_back(q1);
@@ -433,10 +439,10 @@ gate_type_t cphase::type() const {
 }
 
 cmat_t cphase::mat() const {
-    return m;
+    return cmat_t(cphase_c);
 }
 
-toffoli::toffoli(size_t q1, size_t q2, size_t q3) : m(ctoffoli_c) {
+toffoli::toffoli(size_t q1, size_t q2, size_t q3) {
     name = "toffoli";
     duration = 160;
     operands.push_back(q1);
@@ -455,10 +461,10 @@ gate_type_t toffoli::type() const {
 }
 
 cmat_t toffoli::mat() const {
-    return m;
+    return cmat_t(ctoffoli_c);
 }
 
-nop::nop() : m(nop_c) {
+nop::nop() {
     name = "wait";
     duration = 20;
 }
@@ -472,10 +478,10 @@ gate_type_t nop::type() const {
 }
 
 cmat_t nop::mat() const {
-    return m;
+    return cmat_t(nop_c);
 }
 
-swap::swap(size_t q1, size_t q2) : m(swap_c) {
+swap::swap(size_t q1, size_t q2) {
     name = "swap";
     duration = 80;
     operands.push_back(q1);
@@ -492,14 +498,14 @@ gate_type_t swap::type() const {
 }
 
 cmat_t swap::mat() const {
-    return m;
+    return cmat_t(swap_c);
 }
 
 /****************************************************************************\
 | Special gates
 \****************************************************************************/
 
-wait::wait(std::vector<size_t> qubits, size_t d, size_t dc) : m(nop_c) {
+wait::wait(std::vector<size_t> qubits, size_t d, size_t dc) {
     name = "wait";
     duration = d;
     duration_in_cycles = dc;
@@ -517,10 +523,10 @@ gate_type_t wait::type() const {
 }
 
 cmat_t wait::mat() const {
-    return m;
+    return cmat_t(nop_c);
 }
 
-SOURCE::SOURCE() : m(nop_c) {
+SOURCE::SOURCE() {
     name = "SOURCE";
     duration = 1;
 }
@@ -534,10 +540,10 @@ gate_type_t SOURCE::type() const {
 }
 
 cmat_t SOURCE::mat() const {
-    return m;
+    return cmat_t(nop_c);
 }
 
-SINK::SINK() : m(nop_c) {
+SINK::SINK() {
     name = "SINK";
     duration = 1;
 }
@@ -551,10 +557,27 @@ gate_type_t SINK::type() const {
 }
 
 cmat_t SINK::mat() const {
-    return m;
+    return cmat_t(nop_c);
 }
 
-display::display() : m(nop_c) {
+GROUP::GROUP() {
+    name = "GROUP";
+    duration = 0;
+}
+
+instruction_t GROUP::qasm() const {
+    return instruction_t("GROUP");
+}
+
+gate_type_t GROUP::type() const {
+    return __dummy_gate__;
+}
+
+cmat_t GROUP::mat() const {
+    return cmat_t(nop_c);
+}
+
+display::display() {
     name = "display";
     duration = 0;
 }
@@ -568,10 +591,30 @@ gate_type_t display::type() const {
 }
 
 cmat_t display::mat() const {
-    return m;
+    return cmat_t(nop_c);
+}
+
+/**
+ * return the shared copy of matrix m, creating it when m is seen for the first time;
+ * the copies are never freed, there are only as many as there are distinct matrices in the configurations
+ */
+const cmat_t *intern_matrix(const cmat_t &m) {
+    static std::mutex mutex;
+    static std::vector<std::unique_ptr<const cmat_t>> matrices;
+
+    std::lock_guard<std::mutex> guard(mutex);
+    for (auto &mp : matrices) {
+        if (std::equal(m.m, m.m + 4, mp->m)) {
+            return mp.get();
+        }
+    }
+    matrices.emplace_back(new cmat_t(m));
+    return matrices.back().get();
 }
 
 custom_gate::custom_gate(const std::string &name) {
+    static const cmat_t *zero_matrix = intern_matrix(cmat_t());
+    m = zero_matrix;
     this->name = name;  // just remember name, e.g. "x", "x %0" or "x q0", expansion is done by add_custom_gate_if_available().
     // FIXME: no syntax check is performed
 }
@@ -581,16 +624,14 @@ custom_gate::custom_gate(const custom_gate &g) {
     // the scheduler relies on it not doing so!
     DOUT("Custom gate copy constructor for " << g.name);
     name = g.name;
+    opcode = g.opcode;
     // operands = g.operands; FIXME
     creg_operands = g.creg_operands;
     // int_operand = g.int_operand; FIXME
     duration = g.duration;
     // angle = g.angle; FIXME
     // cycle = g.cycle; FIXME
-    m.m[0] = g.m.m[0];
-    m.m[1] = g.m.m[1];
-    m.m[2] = g.m.m[2];
-    m.m[3] = g.m.m[3];
+    m = g.m;
 }
 
 /**
@@ -645,10 +686,12 @@ void custom_gate::load(nlohmann::json &instr) {
         // FIXME: make matrix optional, default to NaN
         auto mat = instr["matrix"];
         DOUT("matrix: " << instr["matrix"]);
-        m.m[0] = complex_t(mat[0][0], mat[0][1]);
-        m.m[1] = complex_t(mat[1][0], mat[1][1]);
-        m.m[2] = complex_t(mat[2][0], mat[2][1]);
-        m.m[3] = complex_t(mat[3][0], mat[3][1]);
+        cmat_t lm;
+        lm.m[0] = complex_t(mat[0][0], mat[0][1]);
+        lm.m[1] = complex_t(mat[1][0], mat[1][1]);
+        lm.m[2] = complex_t(mat[2][0], mat[2][1]);
+        lm.m[3] = complex_t(mat[3][0], mat[3][1]);
+        m = intern_matrix(lm);
     } catch (json::exception &e) {
         EOUT("while loading instruction '" << name << "' (attr: " << l_attr
                                            << ") : " << e.what());
@@ -668,7 +711,7 @@ void custom_gate::print_info() const {
     println("    |- name     : " << name);
     utils::print_vector(operands,"[openql]     |- qubits   :"," , ");
     println("    |- duration : " << duration);
-    println("    |- matrix   : [" << m.m[0] << ", " << m.m[1] << ", " << m.m[2] << ", " << m.m[3] << "]");
+    println("    |- matrix   : [" << m->m[0] << ", " << m->m[1] << ", " << m->m[2] << ", " << m->m[3] << "]");
 }
 
 instruction_t custom_gate::qasm() const {
@@ -708,7 +751,7 @@ gate_type_t custom_gate::type() const {
 }
 
 cmat_t custom_gate::mat() const {
-    return m;
+    return *m;
 }
 
 composite_gate::composite_gate(const std::string &name) : custom_gate(name) {
@@ -737,7 +780,7 @@ gate_type_t composite_gate::type() const {
 }
 
 cmat_t composite_gate::mat() const {
-    return m;   // FIXME: never initialized
+    return *m;  // FIXME: not the product of the matrices of gs
 }
 
 } // namespace ql
@@ -182,6 +182,7 @@ public:
     std::vector<size_t> operands;
     std::vector<size_t> creg_operands;
     int int_operand = 0;
+    int opcode = -1;                         // index of name in the instruction table of the platform; see instruction_table
     size_t duration = 0;
     double angle = 0.0;                      // for arbitrary rotations
     size_t  cycle = MAX_CYCLE;               // cycle after scheduling; MAX_CYCLE indicates undefined
@@ -198,7 +199,6 @@ public:
 
 class identity : public gate {
 public:
-    cmat_t m;
     explicit identity(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -207,7 +207,6 @@ public:
 
 class hadamard : public gate {
 public:
-    cmat_t m;
     explicit hadamard(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -216,7 +215,6 @@ public:
 
 class phase : public gate {
 public:
-    cmat_t m;
     explicit phase(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -225,7 +223,6 @@ public:
 
 class phasedag : public gate {
 public:
-    cmat_t m;
     explicit phasedag(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -234,7 +231,6 @@ public:
 
 class rx : public gate {
 public:
-    cmat_t m;
     rx(size_t q, double theta);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -243,7 +239,6 @@ public:
 
 class ry : public gate {
 public:
-    cmat_t m;
     ry(size_t q, double theta);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -252,7 +247,6 @@ public:
 
 class rz : public gate {
 public:
-    cmat_t m;
     rz(size_t q, double theta);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -261,7 +255,6 @@ public:
 
 class t : public gate {
 public:
-    cmat_t m;
     explicit t(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -270,7 +263,6 @@ public:
 
 class tdag : public gate {
 public:
-    cmat_t m;
     explicit tdag(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -279,7 +271,6 @@ public:
 
 class pauli_x : public gate {
 public:
-    cmat_t m;
     explicit pauli_x(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -288,7 +279,6 @@ public:
 
 class pauli_y : public gate {
 public:
-    cmat_t m;
     explicit pauli_y(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -297,7 +287,6 @@ public:
 
 class pauli_z : public gate {
 public:
-    cmat_t m;
     explicit pauli_z(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -306,7 +295,6 @@ public:
 
 class rx90 : public gate {
 public:
-    cmat_t m;
     explicit rx90(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -315,7 +303,6 @@ public:
 
 class mrx90 : public gate {
 public:
-    cmat_t m;
     explicit mrx90(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -324,7 +311,6 @@ public:
 
 class rx180 : public gate {
 public:
-    cmat_t m;
     explicit rx180(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -333,7 +319,6 @@ public:
 
 class ry90 : public gate {
 public:
-    cmat_t m;
     explicit ry90(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -342,7 +327,6 @@ public:
 
 class mry90 : public gate {
 public:
-    cmat_t m;
     explicit mry90(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -351,7 +335,6 @@ public:
 
 class ry180 : public gate {
 public:
-    cmat_t m;
     explicit ry180(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -360,7 +343,6 @@ public:
 
 class measure : public gate {
 public:
-    cmat_t m;
     explicit measure(size_t q);
     measure(size_t q, size_t c);
     instruction_t qasm() const override;
@@ -370,7 +352,6 @@ public:
 
 class prepz : public gate {
 public:
-    cmat_t m;
     explicit prepz(size_t q);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -379,7 +360,6 @@ public:
 
 class cnot : public gate {
 public:
-    cmat_t m;
     cnot(size_t q1, size_t q2);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -388,7 +368,6 @@ public:
 
 class cphase : public gate {
 public:
-    cmat_t m;
     cphase(size_t q1, size_t q2);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -397,7 +376,6 @@ public:
 
 class toffoli : public gate {
 public:
-    cmat_t m;
     toffoli(size_t q1, size_t q2, size_t q3);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -406,7 +384,6 @@ public:
 
 class nop : public gate {
 public:
-    cmat_t m;
     nop();
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -415,7 +392,6 @@ public:
 
 class swap : public gate {
 public:
-    cmat_t m;
     swap(size_t q1, size_t q2);
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -428,7 +404,6 @@ public:
 
 class wait : public gate {
 public:
-    cmat_t m;
     size_t duration_in_cycles;
 
     wait(std::vector<size_t> qubits, size_t d, size_t dc);
@@ -439,7 +414,6 @@ public:
 
 class SOURCE : public gate {
 public:
-    cmat_t m;
     SOURCE();
     instruction_t qasm() const override;
     gate_type_t type() const override;
@@ -448,25 +422,35 @@ public:
 
 class SINK : public gate {
 public:
-    cmat_t m;
     SINK();
     instruction_t qasm() const override;
     gate_type_t type() const override;
     cmat_t mat() const override;
 };
 
+// node in the dependence graph standing for a group of commuting gates; see Scheduler::add_group
+class GROUP : public gate {
+public:
+    GROUP();
+    instruction_t qasm() const override;
+    gate_type_t type() const override;
+    cmat_t mat() const override;
+};
+
 class display : public gate {
 public:
-    cmat_t m;
     display();
     instruction_t qasm() const override;
     gate_type_t type() const override;
     cmat_t mat() const override;
 };
 
+// shared immutable copy of a matrix, for gates that take their matrix from the configuration
+const cmat_t *intern_matrix(const cmat_t &m);
+
 class custom_gate : public gate {
 public:
-    cmat_t              m;                // matrix representation
+    const cmat_t       *m;                // matrix representation, shared by all gates with that matrix; see intern_matrix
     std::string         arch_operation_name;  // name of instruction in the architecture (e.g. cc_light_instr)
     explicit custom_gate(const std::string &name);
     custom_gate(const custom_gate &g);
@@ -481,7 +465,6 @@ public:
 
 class composite_gate : public custom_gate {
 public:
-    cmat_t m;
     std::vector<gate *> gs;
     explicit composite_gate(const std::string &name);
     composite_gate(const std::string &name, const std::vector<gate*> &seq);
@@ -5,17 +5,25 @@ namespace ql {
 InteractionMatrix::InteractionMatrix() : Size(0) {
 }
 
-InteractionMatrix::InteractionMatrix(circuit ckt, size_t nqubits) {
+InteractionMatrix::InteractionMatrix(const circuit &ckt, size_t nqubits) {
     Size = nqubits;
     Matrix.resize(Size, std::vector<size_t>(Size, 0));
-    for (auto ins : ckt) {
-        std::string insName = ins->qasm();
-        if (insName.find("cnot") != std::string::npos) {
+    circuit_view v(ckt);
+    for (size_t i = 0; i < v.size(); i++) {
+        // the name up to the first space is what qasm() starts with;
+        // only a composite gate prints more, the qasm of its subgates
+        const std::string &insName = v.gates[i]->name;
+        bool is_cnot;
+        if (v.type[i] == __composite_gate__) {
+            is_cnot = v.gates[i]->qasm().find("cnot") != std::string::npos;
+        } else {
+            is_cnot = insName.find("cnot") < insName.find(' ');
+        }
+        if (is_cnot) {
             // for now the interaction matrix only for cnot
-            auto operands = ins->operands;
-            if (operands.size() == 2) {
-                size_t operand0 = operands[0];
-                size_t operand1 = operands[1];
+            if (v.operand_count(i) == 2) {
+                size_t operand0 = v.operands[v.operand_begin[i]];
+                size_t operand1 = v.operands[v.operand_begin[i]+1];
                 Matrix[operand0][operand1] += 1;
                 Matrix[operand1][operand0] += 1;
             }
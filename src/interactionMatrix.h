@@ -23,7 +23,7 @@ private:
 
 public:
     InteractionMatrix();
-    InteractionMatrix(ql::circuit ckt, size_t nqubits);
+    InteractionMatrix(const ql::circuit &ckt, size_t nqubits);
     std::string getString() const;
 };
 
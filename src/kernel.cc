@@ -26,7 +26,7 @@ static int uint64_log2(uint64_t n) {
 
 
 quantum_kernel::quantum_kernel(const std::string &name) :
-    name(name), iterations(1), type(kernel_type_t::STATIC)
+    name(name), iterations(1), type(kernel_type_t::STATIC), arena(std::make_shared<gate_arena>())
 {
 }
 
@@ -40,7 +40,9 @@ quantum_kernel::quantum_kernel(
     iterations(1),
     qubit_count(qcount),
     creg_count(ccount),
-    type(kernel_type_t::STATIC)
+    type(kernel_type_t::STATIC),
+    arena(std::make_shared<gate_arena>(platform.instructions)),
+    instructions(platform.instructions)
 {
     instruction_map = platform.instruction_map;
     cycle_time = platform.cycle_time;
@@ -105,17 +107,17 @@ void quantum_kernel::h(size_t qubit) {
 }
 
 void quantum_kernel::rx(size_t qubit, double angle) {
-    c.push_back(new ql::rx(qubit,angle));
+    c.push_back(arena->create<ql::rx>(qubit,angle));
     cycles_valid = false;
 }
 
 void quantum_kernel::ry(size_t qubit, double angle) {
-    c.push_back(new ql::ry(qubit,angle));
+    c.push_back(arena->create<ql::ry>(qubit,angle));
     cycles_valid = false;
 }
 
 void quantum_kernel::rz(size_t qubit, double angle) {
-    c.push_back(new ql::rz(qubit,angle));
+    c.push_back(arena->create<ql::rz>(qubit,angle));
     cycles_valid = false;
 }
 
@@ -193,7 +195,7 @@ void quantum_kernel::cphase(size_t qubit1, size_t qubit2) {
 
 void quantum_kernel::toffoli(size_t qubit1, size_t qubit2, size_t qubit3) {
     // TODO add custom gate check if needed
-    c.push_back(new ql::toffoli(qubit1, qubit2, qubit3));
+    c.push_back(arena->create<ql::toffoli>(qubit1, qubit2, qubit3));
     cycles_valid = false;
 }
 
@@ -206,7 +208,7 @@ void quantum_kernel::wait(const std::vector<size_t> &qubits, size_t duration) {
 }
 
 void quantum_kernel::display() {
-    c.push_back(new ql::display());
+    c.push_back(arena->create<ql::display>());
     cycles_valid = false;
 }
 
@@ -352,80 +354,80 @@ bool quantum_kernel::add_default_gate_if_available(
     }
 
     if (gname == "identity" || gname == "i") {
-        c.push_back(new ql::identity(qubits[0]));
+        c.push_back(arena->create<ql::identity>(qubits[0]));
         result = true;
     } else if (gname == "hadamard" || gname == "h") {
-        c.push_back(new ql::hadamard(qubits[0]));
+        c.push_back(arena->create<ql::hadamard>(qubits[0]));
         result = true;
     } else if (gname == "pauli_x" || gname == "x") {
-        c.push_back(new ql::pauli_x(qubits[0]));
+        c.push_back(arena->create<ql::pauli_x>(qubits[0]));
         result = true;
     } else if( gname == "pauli_y" || gname == "y") {
-        c.push_back(new ql::pauli_y(qubits[0]));
+        c.push_back(arena->create<ql::pauli_y>(qubits[0]));
         result = true;
     } else if (gname == "pauli_z" || gname == "z") {
-        c.push_back(new ql::pauli_z(qubits[0]));
+        c.push_back(arena->create<ql::pauli_z>(qubits[0]));
         result = true;
     } else if (gname == "s" || gname == "phase") {
-        c.push_back(new ql::phase(qubits[0]));
+        c.push_back(arena->create<ql::phase>(qubits[0]));
         result = true;
     } else if (gname == "sdag" || gname == "phasedag") {
-        c.push_back(new ql::phasedag(qubits[0]));
+        c.push_back(arena->create<ql::phasedag>(qubits[0]));
         result = true;
     } else if (gname == "t") {
-        c.push_back(new ql::t(qubits[0]));
+        c.push_back(arena->create<ql::t>(qubits[0]));
         result = true;
     } else if (gname == "tdag") {
-        c.push_back(new ql::tdag(qubits[0]));
+        c.push_back(arena->create<ql::tdag>(qubits[0]));
         result = true;
     } else if (gname == "rx") {
-        c.push_back(new ql::rx(qubits[0], angle));
+        c.push_back(arena->create<ql::rx>(qubits[0], angle));
         result = true;
     } else if (gname == "ry") {
-        c.push_back(new ql::ry(qubits[0], angle));
+        c.push_back(arena->create<ql::ry>(qubits[0], angle));
         result = true;
     } else if( gname == "rz") {
-        c.push_back(new ql::rz(qubits[0], angle));
+        c.push_back(arena->create<ql::rz>(qubits[0], angle));
         result = true;
     } else if (gname == "rx90") {
-        c.push_back(new ql::rx90(qubits[0]));
+        c.push_back(arena->create<ql::rx90>(qubits[0]));
         result = true;
     } else if (gname == "mrx90") {
-        c.push_back(new ql::mrx90(qubits[0]));
+        c.push_back(arena->create<ql::mrx90>(qubits[0]));
         result = true;
     } else if (gname == "rx180") {
-        c.push_back(new ql::rx180(qubits[0]));
+        c.push_back(arena->create<ql::rx180>(qubits[0]));
         result = true;
     } else if (gname == "ry90") {
-        c.push_back(new ql::ry90(qubits[0]));
+        c.push_back(arena->create<ql::ry90>(qubits[0]));
         result = true;
     } else if (gname == "mry90") {
-        c.push_back(new ql::mry90(qubits[0]));
+        c.push_back(arena->create<ql::mry90>(qubits[0]));
         result = true;
     } else if (gname == "ry180") {
-        c.push_back(new ql::ry180(qubits[0]));
+        c.push_back(arena->create<ql::ry180>(qubits[0]));
         result = true;
     } else if (gname == "measure") {
         if (cregs.empty()) {
-            c.push_back(new ql::measure(qubits[0]));
+            c.push_back(arena->create<ql::measure>(qubits[0]));
         } else {
-            c.push_back(new ql::measure(qubits[0], cregs[0]));
+            c.push_back(arena->create<ql::measure>(qubits[0], cregs[0]));
         }
         result = true;
     } else if (gname == "prepz") {
-        c.push_back(new ql::prepz(qubits[0]));
+        c.push_back(arena->create<ql::prepz>(qubits[0]));
         result = true;
     } else if (gname == "cnot") {
-        c.push_back(new ql::cnot(qubits[0], qubits[1]));
+        c.push_back(arena->create<ql::cnot>(qubits[0], qubits[1]));
         result = true;
     } else if (gname == "cz" || gname == "cphase") {
-        c.push_back(new ql::cphase(qubits[0], qubits[1]) );
+        c.push_back(arena->create<ql::cphase>(qubits[0], qubits[1]) );
         result = true;
     } else if (gname == "toffoli") {
-        c.push_back(new ql::toffoli(qubits[0], qubits[1], qubits[2]));
+        c.push_back(arena->create<ql::toffoli>(qubits[0], qubits[1], qubits[2]));
         result = true;
     } else if (gname == "swap") {
-        c.push_back(new ql::swap(qubits[0], qubits[1]));
+        c.push_back(arena->create<ql::swap>(qubits[0], qubits[1]));
         result = true;
     } else if (gname == "barrier") {
         /*
@@ -437,9 +439,9 @@ bool quantum_kernel::add_default_gate_if_available(
             for (size_t q = 0; q < qubit_count; q++) {
                 all_qubits.push_back(q);
             }
-            c.push_back(new ql::wait(all_qubits, 0, 0));
+            c.push_back(arena->create<ql::wait>(all_qubits, 0, 0));
         } else {
-            c.push_back(new ql::wait(qubits, 0, 0));
+            c.push_back(arena->create<ql::wait>(qubits, 0, 0));
         }
         result = true;
     } else if (gname == "wait") {
@@ -453,9 +455,9 @@ bool quantum_kernel::add_default_gate_if_available(
             for (size_t q = 0; q < qubit_count; q++) {
                 all_qubits.push_back(q);
             }
-            c.push_back(new ql::wait(all_qubits, duration, duration_in_cycles));
+            c.push_back(arena->create<ql::wait>(all_qubits, duration, duration_in_cycles));
         } else {
-            c.push_back(new ql::wait(qubits, duration, duration_in_cycles));
+            c.push_back(arena->create<ql::wait>(qubits, duration, duration_in_cycles));
         }
         result = true;
     } else {
@@ -485,34 +487,20 @@ bool quantum_kernel::add_custom_gate_if_available(
         return false;   // return, so a default gate will be attempted
     }
 #endif
-    // construct canonical name
-    std::string instr = "";
-    for (auto qubit : qubits) {
-        if (!instr.empty()) {
-            instr += ",";
-        }
-        instr += "q" + std::to_string(qubit);
-    }
-    instr = gname + " " + instr;
-
     // first check if a specialized custom gate is available
-    // a specialized custom gate is of the form: "cz q0 q3"
-    instruction_map_t::iterator it = instruction_map.find(instr);
-    if (it == instruction_map.end()) {
-        it = instruction_map.find(gname);
+    // a specialized custom gate is of the form: "cz q0,q3"
+    const custom_gate *prototype = find_specialized_gate(gname, qubits);
+    if (prototype == nullptr) {
+        prototype = find_custom_gate(gname);
     }
-    if (it == instruction_map.end()) {
+    if (prototype == nullptr) {
         DOUT("custom gate not added for " << gname);
         return false;
     }
 
-    custom_gate *g = new custom_gate(*(it->second));
-    for (auto qubit : qubits) {
-        g->operands.push_back(qubit);
-    }
-    for (auto &cop : cregs) {
-        g->creg_operands.push_back(cop);
-    }
+    custom_gate *g = arena->create<custom_gate>(*prototype);
+    g->operands.assign(qubits.begin(), qubits.end());
+    g->creg_operands.insert(g->creg_operands.end(), cregs.begin(), cregs.end());
     if (duration > 0) {
         g->duration = duration;
     }
@@ -524,6 +512,61 @@ bool quantum_kernel::add_custom_gate_if_available(
     return true;
 }
 
+// the gate definition named "gname q<qubits[0]>,q<qubits[1]>,...", e.g. "cz q0,q3"
+const custom_gate *quantum_kernel::find_specialized_gate(
+    const std::string &gname,
+    const std::vector<size_t> &qubits
+) const {
+    if (instructions) {
+        int base = instructions->find(gname);
+        int opcode = (base < 0 ? -1 : instructions->find_specialized(base, qubits));
+        return (opcode < 0 ? nullptr : (*instructions)[opcode].prototype);
+    }
+
+    // construct canonical name
+    std::string instr = "";
+    for (auto qubit : qubits) {
+        if (!instr.empty()) {
+            instr += ",";
+        }
+        instr += "q" + std::to_string(qubit);
+    }
+    instr = gname + " " + instr;
+    auto it = instruction_map.find(instr);
+    return (it == instruction_map.end() ? nullptr : it->second);
+}
+
+// the gate definition named "gname %0,%1,...", e.g. "cz %0,%1"
+const custom_gate *quantum_kernel::find_parameterized_gate(const std::string &gname, size_t nparams) const {
+    if (instructions) {
+        int base = instructions->find(gname);
+        int opcode = (base < 0 ? -1 : instructions->find_parameterized(base, nparams));
+        return (opcode < 0 ? nullptr : (*instructions)[opcode].prototype);
+    }
+
+    // construct instruction name from gname and the parameters
+    std::string instr = "";
+    for (size_t i = 0; i < nparams; i++) {
+        if (!instr.empty()) {
+            instr += ",";
+        }
+        instr += "%" + std::to_string(i);
+    }
+    instr = gname + " " + instr;
+    auto it = instruction_map.find(instr);
+    return (it == instruction_map.end() ? nullptr : it->second);
+}
+
+// the gate definition named gname, e.g. "cz"
+const custom_gate *quantum_kernel::find_custom_gate(const std::string &gname) const {
+    if (instructions) {
+        int opcode = instructions->find(gname);
+        return (opcode < 0 ? nullptr : (*instructions)[opcode].prototype);
+    }
+    auto it = instruction_map.find(gname);
+    return (it == instruction_map.end() ? nullptr : it->second);
+}
+
 // FIXME: move to class composite_gate?
 // return the subinstructions of a composite gate
 // while doing, test whether the subinstructions have a definition (so they cannot be specialized or default ones!)
@@ -559,23 +602,12 @@ bool quantum_kernel::add_spec_decomposed_gate_if_available(
     bool added = false;
     DOUT("Checking if specialized decomposition is available for " << gate_name);
 
-    // construct canonical name
-    std::string instr_parameterized = "";
-    for (auto qubit : all_qubits) {
-        if (!instr_parameterized.empty()) {
-            instr_parameterized += ",";
-        }
-        instr_parameterized += "q" + std::to_string(qubit);
-    }
-    instr_parameterized = gate_name + " " + instr_parameterized;
-    DOUT("specialized instruction name: " << instr_parameterized);
-
-    // find the name
-    auto it = instruction_map.find(instr_parameterized);
-    if (it != instruction_map.end()) {
+    // find the specialized gate, e.g. "cz q0,q3"
+    const custom_gate *prototype = find_specialized_gate(gate_name, all_qubits);
+    if (prototype != nullptr) {
         // check gate type
-        DOUT("specialized composite gate found for " << instr_parameterized);
-        composite_gate * gptr = (composite_gate *)(it->second);
+        DOUT("specialized composite gate found for " << prototype->name);
+        const composite_gate *gptr = (const composite_gate *)prototype;
         if (gptr->type() == __composite_gate__) {
             DOUT("composite gate type");
         } else {
@@ -632,7 +664,7 @@ bool quantum_kernel::add_spec_decomposed_gate_if_available(
         }
         added = true;
     } else {
-        DOUT("composite gate not found for " << instr_parameterized);
+        DOUT("composite gate not found for " << gate_name << " with " << ql::utils::to_string(all_qubits, "qubits"));
     }
 
     return added;
@@ -652,22 +684,12 @@ bool quantum_kernel::add_param_decomposed_gate_if_available(
     bool added = false;
     DOUT("Checking if parameterized composite gate is available for " << gate_name);
 
-    // construct instruction name from gate_name and actual qubit parameters
-    std::string instr_parameterized = "";
-    for (size_t i = 0; i < all_qubits.size(); i++) {
-        if (!instr_parameterized.empty()) {
-            instr_parameterized += ",";
-        }
-        instr_parameterized += "%" + std::to_string(i);
-    }
-    instr_parameterized = gate_name + " " + instr_parameterized;
-    DOUT("parameterized instruction name: " << instr_parameterized);
-
-    // check for composite ins
-    auto it = instruction_map.find(instr_parameterized);
-    if (it != instruction_map.end()) {
+    // check for composite ins, e.g. "cz %0,%1"
+    const custom_gate *prototype = find_parameterized_gate(gate_name, all_qubits.size());
+    if (prototype != nullptr) {
+        const std::string &instr_parameterized = prototype->name;
         DOUT("parameterized gate found for " << instr_parameterized);
-        composite_gate * gptr = (composite_gate *)(it->second);
+        const composite_gate *gptr = (const composite_gate *)prototype;
         if (gptr->type() == __composite_gate__) {
             DOUT("composite gate type");
         } else {
@@ -728,7 +750,7 @@ bool quantum_kernel::add_param_decomposed_gate_if_available(
         }
         added = true;
     } else {
-        DOUT("composite gate not found for " << instr_parameterized);
+        DOUT("composite gate not found for " << gate_name << " with " << all_qubits.size() << " parameters");
     }
     return added;
 }
@@ -928,9 +950,9 @@ int quantum_kernel::recursiveRelationsForUnitaryDecomposition(
     } else { //n=1
         // DOUT("Adding the zyz decomposition gates at index: "<< i);
         // zyz gates happen on the only qubit in the list.
-        c.push_back(new ql::rz(qubits.back(), u.instructionlist[i]));
-        c.push_back(new ql::ry(qubits.back(), u.instructionlist[i + 1]));
-        c.push_back(new ql::rz(qubits.back(), u.instructionlist[i + 2]));
+        c.push_back(arena->create<ql::rz>(qubits.back(), u.instructionlist[i]));
+        c.push_back(arena->create<ql::ry>(qubits.back(), u.instructionlist[i + 1]));
+        c.push_back(arena->create<ql::rz>(qubits.back(), u.instructionlist[i + 2]));
         // How many gates this took
         return 3;
     }
@@ -946,16 +968,16 @@ void quantum_kernel::multicontrolled_rz(
     // DOUT("Adding a multicontrolled rz-gate at start index " << start_index << ", to " << ql::utils::to_string(qubits, "qubits: "));
     int idx;
     //The first one is always controlled from the last to the first qubit.
-    c.push_back(new ql::rz(qubits.back(),-instruction_list[start_index]));
-    c.push_back(new ql::cnot(qubits[0], qubits.back()));
+    c.push_back(arena->create<ql::rz>(qubits.back(),-instruction_list[start_index]));
+    c.push_back(arena->create<ql::cnot>(qubits[0], qubits.back()));
     for (int i = 1; i < end_index - start_index; i++) {
         idx = uint64_log2(((i)^((i)>>1))^((i+1)^((i+1)>>1)));
-        c.push_back(new ql::rz(qubits.back(),-instruction_list[i+start_index]));
-        c.push_back(new ql::cnot(qubits[idx], qubits.back()));
+        c.push_back(arena->create<ql::rz>(qubits.back(),-instruction_list[i+start_index]));
+        c.push_back(arena->create<ql::cnot>(qubits[idx], qubits.back()));
     }
     // The last one is always controlled from the next qubit to the first qubit
-    c.push_back(new ql::rz(qubits.back(),-instruction_list[end_index]));
-    c.push_back(new ql::cnot(qubits.end()[-2], qubits.back()));
+    c.push_back(arena->create<ql::rz>(qubits.back(),-instruction_list[end_index]));
+    c.push_back(arena->create<ql::cnot>(qubits.end()[-2], qubits.back()));
     cycles_valid = false;
 }
 
@@ -970,17 +992,17 @@ void quantum_kernel::multicontrolled_ry(
     int idx;
 
     //The first one is always controlled from the last to the first qubit.
-    c.push_back(new ql::ry(qubits.back(),-instruction_list[start_index]));
-    c.push_back(new ql::cnot(qubits[0], qubits.back()));
+    c.push_back(arena->create<ql::ry>(qubits.back(),-instruction_list[start_index]));
+    c.push_back(arena->create<ql::cnot>(qubits[0], qubits.back()));
 
     for (int i = 1; i < end_index - start_index; i++) {
         idx = uint64_log2 (((i)^((i)>>1))^((i+1)^((i+1)>>1)));
-        c.push_back(new ql::ry(qubits.back(),-instruction_list[i+start_index]));
-        c.push_back(new ql::cnot(qubits[idx], qubits.back()));
+        c.push_back(arena->create<ql::ry>(qubits.back(),-instruction_list[i+start_index]));
+        c.push_back(arena->create<ql::cnot>(qubits[idx], qubits.back()));
     }
     // Last one is controlled from the next qubit to the first one.
-    c.push_back(new ql::ry(qubits.back(),-instruction_list[end_index]));
-    c.push_back(new ql::cnot(qubits.end()[-2], qubits.back()));
+    c.push_back(arena->create<ql::ry>(qubits.back(),-instruction_list[end_index]));
+    c.push_back(arena->create<ql::cnot>(qubits.end()[-2], qubits.back()));
     cycles_valid = false;
 }
 
@@ -1071,12 +1093,12 @@ void quantum_kernel::classical(const creg &destination, const operation &oper) {
         }
     }
 
-    c.push_back(new ql::classical(destination, oper));
+    c.push_back(arena->create<ql::classical>(destination, oper));
     cycles_valid = false;
 }
 
 void quantum_kernel::classical(const std::string &operation) {
-    c.push_back(new ql::classical(operation));
+    c.push_back(arena->create<ql::classical>(operation));
     cycles_valid = false;
 }
 
@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "circuit.h"
 #include "classical.h"
 #include "hardware_configuration.h"
@@ -33,10 +35,12 @@ public: // FIXME: should be private
     size_t        creg_count;
     kernel_type_t type;
     circuit       c;
+    std::shared_ptr<gate_arena> arena;  // owns the gates of c, shared by copies of the kernel; see gate_arena
     bool          cycles_valid; // used in bundler to check if kernel has been scheduled
     operation     br_condition;
     size_t        cycle_time;   // FIXME HvS just a copy of platform.cycle_time
     instruction_map_t instruction_map;
+    std::shared_ptr<const instruction_table> instructions;  // of the platform, to find gate definitions; nullptr if none
 
 public:
     quantum_kernel(const std::string &name);
@@ -146,6 +150,13 @@ private:
         const std::vector<size_t> &cregs = {}
     );
 
+    // the gate definition in the instruction map for gname with the given qubits, e.g. "cz q0,q3" ('specialized'),
+    // for gname with nparams parameters, e.g. "cz %0,%1" ('parameterized'), and for gname itself, e.g. "cz";
+    // nullptr if there is none; with a platform, these are found by opcode without constructing these names
+    const custom_gate *find_specialized_gate(const std::string &gname, const std::vector<size_t> &qubits) const;
+    const custom_gate *find_parameterized_gate(const std::string &gname, size_t nparams) const;
+    const custom_gate *find_custom_gate(const std::string &gname) const;
+
 public:
 
     void gate(const std::string &gname, size_t q0);
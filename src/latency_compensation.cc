@@ -41,16 +41,15 @@ void latency_compensation_kernel(
         // DOUT("Latency compensating instruction: " << id);
         long latency_cycles = 0;
 
-        if (platform.instruction_settings.count(id) > 0) {
-            if (platform.instruction_settings[id].count("latency") > 0) {
-                float latency_ns = platform.instruction_settings[id]["latency"];
-                latency_cycles = long(std::ceil( static_cast<float>(std::abs(latency_ns)) / platform.cycle_time)) *
-                                      ql::utils::sign_of(latency_ns);
-                compensated_one = true;
-
-                gp->cycle = gp->cycle + latency_cycles;
-                DOUT( "... compensated to @" << gp->cycle << " <- " << id << " with " << latency_cycles );
-            }
+        auto ip = platform.instructions->get(gp);
+        if (ip != nullptr && ip->has_latency) {
+            float latency_ns = ip->latency;
+            latency_cycles = long(std::ceil( static_cast<float>(std::abs(latency_ns)) / platform.cycle_time)) *
+                                  ql::utils::sign_of(latency_ns);
+            compensated_one = true;
+
+            gp->cycle = gp->cycle + latency_cycles;
+            DOUT( "... compensated to @" << gp->cycle << " <- " << id << " with " << latency_cycles );
         }
     }
 
@@ -76,9 +75,9 @@ void latency_compensation(
     ql::report_statistics(programp, platform, "in", passname, "# ");
     ql::report_qasm(programp, platform, "in", passname);
 
-    for (size_t k = 0; k < programp->kernels.size(); ++k) {
-        latency_compensation_kernel(programp->kernels[k], platform);
-    }
+    for_each_kernel(programp, [&platform](ql::quantum_kernel &kernel) {
+        latency_compensation_kernel(kernel, platform);
+    });
 
     ql::report_statistics(programp, platform, "out", passname, "# ");
     ql::report_qasm(programp, platform, "out", passname);
@@ -1,8 +1,11 @@
 #include "mapper.h"
-
-#ifdef INITIALPLACE
 #include <thread>
 #include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <limits>
+
+#ifdef INITIALPLACE
 #include <condition_variable>
 #include <lemon/lp.h>
 #endif
@@ -43,6 +46,7 @@ void Grid::Init(const ql::quantum_platform *p) {
     InitNbs();
     SortNbs();
     ComputeDist();
+    paths = std::make_shared<GridPaths>();
     DPRINTGrid();
 }
 
@@ -64,9 +68,9 @@ bool Grid::IsInterCoreHop(size_t qs, size_t qt) const {
 // formulae for convex (hole free) topologies with underlying grid and with bidirectional edges:
 //      gf_cross:   std::max( std::abs( x[to_realqi] - x[from_realqi] ), std::abs( y[to_realqi] - y[from_realqi] ))
 //      gf_plus:    std::abs( x[to_realqi] - x[from_realqi] ) + std::abs( y[to_realqi] - y[from_realqi] )
-// when the neighbor relation is defined (topology.edges in config file), Floyd-Warshall is used, which currently is always
+// when the neighbor relation is defined (topology.edges in config file), BFS is used, which currently is always
 size_t Grid::Distance(size_t from_realqi, size_t to_realqi) const {
-    return dist[from_realqi][to_realqi];
+    return (*dist)[from_realqi*nq + to_realqi];
 }
 
 // coredistance between two qubits
@@ -158,35 +162,58 @@ void Grid::Normalize(size_t src, neighbors_t &nbl) const {
     // for (auto dn : nbl) { std::cout << dn << " "; } std::cout << std::endl;
 }
 
-// Floyd-Warshall dist[i][j] = shortest distances between all nq qubits i and j
+// (*dist)[i*nq+j] = shortest distances between all nq qubits i and j
+// the edges are unweighted, so a BFS from each qubit i over nbs gives the distances from i in O(nq+nedges),
+// i.e. O(nq*(nq+nedges)) for all, instead of the O(nq^3) of Floyd-Warshall;
+// the distances only depend on the platform, so they are computed once and kept in it (see topology_distances),
+// and a next program or kernel on the same platform finds them computed already
 void Grid::ComputeDist() {
-    // initialize all distances to maximum value, to neighbors to 1, to itself to 0
-    dist.resize(nq); for (size_t i=0; i<nq; i++) dist[i].resize(nq, MAX_CYCLE);
-    for (size_t i = 0; i < nq; i++) {
-        dist[i][i] = 0;
-        for (size_t j : nbs[i]) {
-            dist[i][j] = 1;
+    std::shared_ptr<ql::topology_distances> distances = platformp->distances;
+    std::call_once(distances->computed, [this, &distances]() {
+        // neighbor lists flattened: qubit i has neighbors nbv[nbstart[i]] .. nbv[nbstart[i+1]-1]
+        std::vector<size_t> nbstart(nq+1, 0);
+        std::vector<size_t> nbv;
+        for (size_t i = 0; i < nq; i++) {
+            nbstart[i] = nbv.size();
+            for (size_t j : nbs[i]) {
+                nbv.push_back(j);
+            }
         }
-    }
+        nbstart[nq] = nbv.size();
 
-    // find shorter distances by gradually including more qubits (k) in path
-    for (size_t k = 0; k < nq; k++) {
+        // initialize all distances to maximum value (i.e. unreachable); each BFS from i then fills row i
+        std::vector<size_t> &newdist = distances->dist;
+        newdist.assign(nq*nq, MAX_CYCLE);
+        std::vector<size_t> queue(nq);
         for (size_t i = 0; i < nq; i++) {
-            for (size_t j = 0; j < nq; j++) {
-                if (dist[i][j] > dist[i][k] + dist[k][j]) {
-                    dist[i][j] = dist[i][k] + dist[k][j];
+            size_t *row = newdist.data() + i*nq;
+            size_t head = 0;
+            size_t tail = 0;
+            row[i] = 0;
+            queue[tail++] = i;
+            while (head < tail) {
+                size_t k = queue[head++];
+                for (size_t n = nbstart[k]; n < nbstart[k+1]; n++) {
+                    size_t j = nbv[n];
+                    if (row[j] == MAX_CYCLE) {
+                        row[j] = row[k] + 1;
+                        queue[tail++] = j;
+                    }
                 }
             }
         }
-    }
+    });
+    // share the platform's distances; this keeps them alive as long as this grid
+    dist = std::shared_ptr<const std::vector<size_t>>(distances, &distances->dist);
+    DOUT("Grid::ComputeDist: using the distances of the platform");
 #ifdef debug
     for (size_t i = 0; i < nq; i++) {
         for (size_t j = 0; j < nq; j++) {
             if (form == gf_cross) {
-                ASSERT (dist[i][j] == (std::max(std::abs(x[i] - x[j]),
+                ASSERT ((*dist)[i*nq+j] == (std::max(std::abs(x[i] - x[j]),
                                                       std::abs(y[i] - y[j]))));
             } else if (form == gf_plus) {
-                ASSERT (dist[i][j] ==
+                ASSERT ((*dist)[i*nq+j] ==
                               (std::abs(x[i] - x[j]) + std::abs(y[i] - y[j])));
             }
 
@@ -195,6 +222,23 @@ void Grid::ComputeDist() {
 #endif
 }
 
+// return the path set with the given key from the path cache;
+// when it is not there yet, gen is called to compute it, and it is added;
+// gen is called without holding the lock, so concurrent callers may both compute it and the first one to add wins
+std::shared_ptr<const GridPaths::paths_t> Grid::Paths(size_t key, const std::function<void(GridPaths::paths_t &)> &gen) {
+    {
+        std::lock_guard<std::mutex> guard(paths->m);
+        auto it = paths->sets.find(key);
+        if (it != paths->sets.end()) {
+            return it->second;
+        }
+    }
+    auto newpaths = std::make_shared<GridPaths::paths_t>();
+    gen(*newpaths);
+    std::lock_guard<std::mutex> guard(paths->m);
+    return paths->sets.emplace(key, newpaths).first->second;
+}
+
 void Grid::DPRINTGrid() const {
     if (ql::utils::logger::LOG_LEVEL >= ql::utils::logger::log_level_t::LOG_DEBUG) {
         PrintGrid();
@@ -359,15 +403,9 @@ void Grid::SortNbs() {
 
 // map real qubit to the virtual qubit index that is mapped to it (i.e. backward map);
 // when none, return UNDEFINED_QUBIT;
-// a second vector next to v2rMap (i.e. an r2vMap) would speed this up;
 size_t Virt2Real::GetVirt(size_t r) const {
-    ASSERT(r != UNDEFINED_QUBIT);
-    for (size_t v = 0; v < nq; v++) {
-        if (v2rMap[v] == r) {
-            return v;
-        }
-    }
-    return UNDEFINED_QUBIT;
+    ASSERT(r < nq);   // implies r != UNDEFINED_QUBIT
+    return r2vMap[r];
 }
 
 realstate_t Virt2Real::GetRs(size_t q) const {
@@ -407,12 +445,15 @@ void Virt2Real::Init(size_t n) {
         DOUT("Virt2Real::Init(n=" << nq << "), assume all qubits in garbage state");
     }
     v2rMap.resize(nq);
+    r2vMap.resize(nq);
     rs.resize(nq);
     for (size_t i = 0; i < nq; i++) {
         if (mapinitone2oneopt == "yes") {
             v2rMap[i] = i;
+            r2vMap[i] = i;
         } else {
             v2rMap[i] = UNDEFINED_QUBIT;
+            r2vMap[i] = UNDEFINED_QUBIT;
         }
         if (mapassumezeroinitstateopt == "yes") {
             rs[i] = rs_wasinited;
@@ -423,33 +464,40 @@ void Virt2Real::Init(size_t n) {
 }
 
 // map virtual qubit index to real qubit index
-size_t &Virt2Real::operator[](size_t v) {
+const size_t &Virt2Real::operator[](size_t v) const {
     ASSERT(v < nq);   // implies v != UNDEFINED_QUBIT
     return v2rMap[v];
 }
 
-const size_t &Virt2Real::operator[](size_t v) const {
+// map virtual qubit v to real qubit r (UNDEFINED_QUBIT unmaps v), updating the reverse map as well;
+// r should not be mapped to by an other virtual qubit
+void Virt2Real::SetReal(size_t v, size_t r) {
     ASSERT(v < nq);   // implies v != UNDEFINED_QUBIT
-    return v2rMap[v];
+    size_t oldr = v2rMap[v];
+    if (oldr != UNDEFINED_QUBIT) {
+        r2vMap[oldr] = UNDEFINED_QUBIT;
+    }
+    v2rMap[v] = r;
+    if (r != UNDEFINED_QUBIT) {
+        ASSERT(r < nq);
+        ASSERT(r2vMap[r] == UNDEFINED_QUBIT);
+        r2vMap[r] = v;
+    }
 }
 
 // allocate a new real qubit for an unmapped virtual qubit v (i.e. v2rMap[v] == UNDEFINED_QUBIT);
 // note that this may consult the grid or future gates to find a best real
 // and thus should not be in Virt2Real but higher up
 size_t Virt2Real::AllocQubit(size_t v) {
-    // check all real indices for being in v2rMap
+    // check all real indices for being in v2rMap, i.e. for having a virtual qubit in r2vMap
     // first one that isn't, is free and is returned
     for (size_t r = 0; r < nq; r++) {
-        size_t vt;
-        for (vt = 0; vt < nq; vt++) {
-            if (v2rMap[vt] == r) {
-                break;
-            }
-        }
-        if (vt >= nq) {
+        if (r2vMap[r] == UNDEFINED_QUBIT) {
             // real qubit r was not found in v2rMap
             // use it to map v
+            ASSERT(v2rMap[v] == UNDEFINED_QUBIT);
             v2rMap[v] = r;
+            r2vMap[r] = v;
             ASSERT(rs[r] == rs_wasinited || rs[r] == rs_nostate);
             DOUT("AllocQubit(v=" << v << ") in r=" << r);
             return r;
@@ -477,6 +525,7 @@ void Virt2Real::Swap(size_t r0, size_t r1) {
         ASSERT(v0 < nq);
         v2rMap[v0] = r1;
     }
+    r2vMap[r1] = v0;
 
     if (v1 == UNDEFINED_QUBIT) {
         ASSERT(rs[r1] != rs_hasstate);
@@ -484,6 +533,7 @@ void Virt2Real::Swap(size_t r0, size_t r1) {
         ASSERT(v1 < nq);
         v2rMap[v1] = r0;
     }
+    r2vMap[r0] = v1;
 
     realstate_t ts = rs[r0];
     rs[r0] = rs[r1];
@@ -610,17 +660,14 @@ FreeCycle::FreeCycle() {
 
 void FreeCycle::Init(const ql::quantum_platform *p) {
     DOUT("FreeCycle::Init()");
-    ql::arch::resource_manager_t lrm(*p, ql::forward_scheduling);   // allocated here and copied below to rm because of platform parameter
-    DOUT("... created FreeCycle Init local resource_manager");
     platformp = p;
     nq = platformp->qubit_number;
     ct = platformp->cycle_time;
     DOUT("... FreeCycle: nq=" << nq << ", ct=" << ct << "), initializing to all 0 cycles");
     fcv.clear();
     fcv.resize(nq, 1);   // this 1 implies that cycle of first gate will be 1 and not 0; OpenQL convention!?!?
-    DOUT("... about to copy FreeCycle Init local resource_manager to FreeCycle member rm");
-    rm = lrm;
-    DOUT("... done copy FreeCycle Init local resource_manager to FreeCycle member rm");
+    rmp = std::make_shared<ql::arch::resource_manager_t>(*p, ql::forward_scheduling);
+    DOUT("... created FreeCycle Init resource_manager");
 }
 
 // depth of the FreeCycle map
@@ -728,18 +775,14 @@ size_t FreeCycle::StartCycle(ql::gate *g) {
 
     auto mapopt = ql::options::get("mapper");
     if (mapopt == "baserc" || mapopt == "minextendrc") {
+        // available may update the resource manager's maps (see above), so clone a shared one first
+        if (rmp.use_count() > 1) {
+            rmp = std::make_shared<ql::arch::resource_manager_t>(*rmp);
+        }
         size_t baseStartCycle = startCycle;
 
-        while (startCycle < MAX_CYCLE) {
-            // DOUT("Startcycle for " << g->qasm() << ": available? at startCycle=" << startCycle);
-            if (rm.available(startCycle, g, *platformp)) {
-                // DOUT(" ... [" << startCycle << "] resources available for " << g->qasm());
-                break;
-            } else {
-                // DOUT(" ... [" << startCycle << "] Busy resource for " << g->qasm());
-                startCycle++;
-            }
-        }
+        // instead of trying cycle by cycle, continue at the cycle that a busy resource may be available
+        startCycle = rmp->earliest_available_cycle(startCycle, g, *platformp);
         if (baseStartCycle != startCycle) {
             // DOUT(" ... from [" << baseStartCycle << "] to [" << startCycle-1 << "] busy resource(s) for " << g->qasm());
         }
@@ -770,13 +813,125 @@ void FreeCycle::AddNoRc(ql::gate *g, size_t startCycle) {
 // gate operands are real qubit indices
 // both the FreeCycle map and the resource map are updated
 // startcycle must be the result of an earlier StartCycle call (with rc!)
+// when the resource map is shared with other FreeCycle maps, it is cloned first (copy-on-write)
 void FreeCycle::Add(ql::gate *g, size_t startCycle) {
     AddNoRc(g, startCycle);
 
     auto mapopt = ql::options::get("mapper");
     if (mapopt == "baserc" || mapopt == "minextendrc") {
-        rm.reserve(startCycle, g, *platformp);
+        if (rmp.use_count() > 1) {
+            rmp = std::make_shared<ql::arch::resource_manager_t>(*rmp);
+        }
+        rmp->reserve(startCycle, g, *platformp);
+    }
+}
+
+SharedGateList::SharedGateList() {
+    ordered = false;
+}
+
+SharedGateList::SharedGateList(const SharedGateList &other) {
+    ordered = other.ordered;
+    base = other.base;
+    delta = other.delta;
+}
+
+SharedGateList &SharedGateList::operator=(const SharedGateList &other) {
+    if (this != &other) {
+        ordered = other.ordered;
+        base = other.base;
+        delta = other.delta;
+    }
+    return *this;
+}
+
+// fold the delta into the base when the base is not shared; the logical list is not changed by this
+void SharedGateList::Fold() {
+    if (delta.empty()) {
+        return;
+    }
+    if (!base) {
+        base = std::make_shared<std::list<gate_p>>();
+    } else if (base.use_count() > 1) {
+        return;
+    }
+    if (ordered) {
+        // list::merge is stable: with equal cycle values, the gates of base come first
+        base->merge(delta, [](gate_p gp1, gate_p gp2) { return gp1->cycle < gp2->cycle; });
+    } else {
+        base->splice(base->end(), delta);
+    }
+}
+
+// make the list empty and set whether it is ordered by cycle
+void SharedGateList::Init(bool is_ordered) {
+    ordered = is_ordered;
+    base.reset();
+    delta.clear();
+}
+
+bool SharedGateList::empty() const {
+    return (!base || base->empty()) && delta.empty();
+}
+
+size_t SharedGateList::size() const {
+    return (base ? base->size() : 0) + delta.size();
+}
+
+// add gate gp to the list;
+// when ordered, gp is inserted in order of its cycle value, and inside this order, as late as possible
+void SharedGateList::Add(gate_p gp) {
+    if (!ordered) {
+        delta.push_back(gp);
+        return;
+    }
+
+    // reverse iterate because the insertion is near the end of the list
+    // insert so that cycle values are in order afterwards and the new one is nearest to the end
+    auto rigp = delta.rbegin();
+    for (; rigp != delta.rend(); rigp++) {
+        if ((*rigp)->cycle <= gp->cycle) {
+            // rigp.base() because insert doesn't work with reverse iteration
+            // rigp.base points after the element that rigp is pointing at
+            // which is lucky because insert only inserts before the given element
+            // the end effect is inserting after rigp
+            delta.insert(rigp.base(), gp);
+            break;
+        }
+    }
+    // when list was empty or no element was found, just put it in front
+    // gates of base with the same cycle value come before it when merging
+    if (rigp == delta.rend()) {
+        delta.push_front(gp);
+    }
+}
+
+// append the gates of the logical list to l, in order, and make the list empty
+void SharedGateList::Take(std::list<gate_p> &l) {
+    Fold();
+    if (base && base.use_count() == 1) {
+        l.splice(l.end(), *base);
+        l.splice(l.end(), delta);
+    } else {
+        Get(l);
+    }
+    base.reset();
+    delta.clear();
+}
+
+// append the gates of the logical list to l, in order
+void SharedGateList::Get(std::list<gate_p> &l) const {
+    std::list<gate_p> dl = delta;
+    if (base) {
+        std::list<gate_p> bl = *base;
+        if (ordered) {
+            bl.merge(dl, [](gate_p gp1, gate_p gp2) { return gp1->cycle < gp2->cycle; });
+        } else {
+            bl.splice(bl.end(), dl);
+        }
+        l.splice(l.end(), bl);
     }
+    l.splice(l.end(), dl);
 }
 
 // explicit Past constructor
@@ -786,11 +941,13 @@ Past::Past() {
 }
 
 // past initializer
-void Past::Init(const ql::quantum_platform *p, ql::quantum_kernel *k, Grid *g) {
+void Past::Init(const ql::quantum_platform *p, ql::quantum_kernel *k, Grid *g, const std::string &mapusemoves) {
     DOUT("Past::Init");
     platformp = p;
     kernelp = k;
+    kernelmutexp = std::make_shared<std::mutex>();
     gridp = g;
+    mapusemovesopt = mapusemoves;
 
     nq = platformp->qubit_number;
     ct = platformp->cycle_time;
@@ -799,11 +956,17 @@ void Past::Init(const ql::quantum_platform *p, ql::quantum_kernel *k, Grid *g) {
     v2r.Init(nq);               // v2r initializtion until v2r is imported from context
     fc.Init(platformp);         // fc starts off with all qubits free, is updated after schedule of each gate
     waitinglg.clear();          // no gates pending to be scheduled in; Add of gate to past entered here
-    lg.clear();                 // no gates scheduled yet in this past; after schedule of gate, it gets here
-    outlg.clear();              // no gates output yet by flushing from or bypassing this past
+    lg.Init(true);              // no gates scheduled yet in this past; after schedule of gate, it gets here
+    outlg.Init(false);          // no gates output yet by flushing from or bypassing this past
     nswapsadded = 0;            // no swaps or moves added yet to this past; AddSwap adds one here
     nmovesadded = 0;            // no moves added yet to this past; AddSwap may add one here
-    cycle.clear();              // no gates have cycles assigned in this past; scheduling gate updates this
+}
+
+// fold the gates scheduled and output until now into the bases of lg and outlg,
+// so that copies of this Past made after this only copy what they add to it
+void Past::Fold() {
+    lg.Fold();
+    outlg.Fold();
 }
 
 // import Past's v2r from v2r_value
@@ -831,8 +994,10 @@ void Past::Print(const std::string &s) const {
     v2r.Print("");
     fc.Print("");
     // DOUT("... list of gates in past");
-    for (auto &gp : lg) {
-        DOUT("[" << cycle.at(gp) << "] " << gp->qasm());
+    std::list<gate_p> l;
+    lg.Get(l);
+    for (auto &gp : l) {
+        DOUT("[" << gp->cycle << "] " << gp->qasm());
     }
 }
 
@@ -840,70 +1005,43 @@ void Past::Print(const std::string &s) const {
 // note that these gates all are mapped and so have real operand qubit indices
 // the FreeCycle map reflects for each qubit the first free cycle
 // all new gates, now in waitinglist, get such a cycle assigned below, increased gradually, until definitive
+//
+// IMPORTANT: this assumes that the waitinglg gates list is in topological order,
+// which is ok because the pair of swap lists use distict qubits and
+// the gates of each are added to the back of the list in the order of execution.
+//
+// The schedule is ASAP and the gate scheduled next is the one that can start first, and when several can,
+// the first of those in waitinglg. This is the same as scheduling the gates one by one in waitinglg order,
+// each in the first cycle that its operand qubits and resources are free:
+// - a gate doesn't start before the gates before it in waitinglg on the same qubits;
+// - with resource constraints, a gate doesn't start before the gates before it in waitinglg
+//   that use the same resource either, since each resource only allows a next gate from the cycle
+//   that its last reservation starts (in forward scheduling);
+//   so the reservations on each resource are done in the same order in both, and leave the same resource state;
+//   timeline resources (see resource_manager.h) may fit a later gate in a hole before an earlier one,
+//   but it then doesn't overlap it, and their state doesn't depend on the order of the reservations;
+// - the gate is inserted in lg in cycle order and, within a cycle, after the gates already in it,
+//   so that the gates of a cycle are ordered in the same way too.
+// So each gate's start cycle is computed once against fc itself,
+// and no copy of fc (with its resource manager) is made and no rescan of waitinglg is done.
 void Past::Schedule() {
-    // the copy includes the resource manager.
     // DOUT("Schedule ...");
-
-    while (!waitinglg.empty()) {
-        size_t      startCycle = MAX_CYCLE;
-        gate_p      gp = nullptr;
-
-        // find the gate with the minimum startCycle
-        //
-        // IMPORTANT: this assumes that the waitinglg gates list is in topological order,
-        // which is ok because the pair of swap lists use distict qubits and
-        // the gates of each are added to the back of the list in the order of execution.
-        // Using tryfc.Add, the tryfc (try FreeCycle map) reflects the earliest startCycle per qubit,
-        // and so dependences are respected, so we can find the gate that can start first ...
-        // Note that tryfc includes the free cycle vector AND the resource map,
-        // so using tryfc.StartCycle/tryfc.Add we get a realistic ASAP rc schedule.
-        // We use a copy of fc and not fc itself, since the latter reflects the really scheduled gates
-        // and that shouldn't be changed.
-        //
-        // This search is really a hack to avoid
-        // the construction of a dependence graph and a set of schedulable gates
-        FreeCycle   tryfc = fc;
-        for (auto &trygp : waitinglg) {
-            size_t tryStartCycle = tryfc.StartCycle(trygp);
-            tryfc.Add(trygp, tryStartCycle);
-
-            if (tryStartCycle < startCycle) {
-                startCycle = tryStartCycle;
-                gp = trygp;
-            }
-        }
+    for (auto gp : waitinglg) {
+        size_t  startCycle = fc.StartCycle(gp);
 
         // add this gate to the maps, scheduling the gate (doing the cycle assignment)
         // DOUT("... add " << gp->qasm() << " startcycle=" << startCycle << " cycles=" << ((gp->duration+ct-1)/ct) );
         fc.Add(gp, startCycle);
-        cycle[gp] = startCycle; // cycle[gp] is private to this past but gp->cycle is private to gp
-        gp->cycle = startCycle; // so gp->cycle gets assigned for each alter' Past and finally definitively for mainPast
+        gp->cycle = startCycle; // gp is only scheduled in this past; copies of it share gp in their lg
         // DOUT("... set " << gp->qasm() << " at cycle " << startCycle);
 
-        // insert gate gp in lg, the list of gates, in cycle[gp] order, and inside this order, as late as possible
-        //
-        // reverse iterate because the insertion is near the end of the list
-        // insert so that cycle values are in order afterwards and the new one is nearest to the end
-        auto rigp = lg.rbegin();
-        for (; rigp != lg.rend(); rigp++) {
-            if (cycle[*rigp] <= startCycle) {
-                // rigp.base() because insert doesn't work with reverse iteration
-                // rigp.base points after the element that rigp is pointing at
-                // which is lucky because insert only inserts before the given element
-                // the end effect is inserting after rigp
-                lg.insert(rigp.base(), gp);
-                break;
-            }
-        }
-        // when list was empty or no element was found, just put it in front
-        if (rigp == lg.rend()) {
-            lg.push_front(gp);
-        }
-
-        // having added it to the main list, remove it from the waiting list
-        waitinglg.remove(gp);
+        // insert gate gp in lg, the list of gates, in gp->cycle order, and inside this order, as late as possible
+        lg.Add(gp);
     }
 
+    // having added them to the main list, remove them from the waiting list
+    waitinglg.clear();
+
     // DPRINT("Schedule:");
 }
 
@@ -962,6 +1100,7 @@ bool Past::new_gate(
     double angle
 ) const {
     bool added;
+    std::lock_guard<std::mutex> l(*kernelmutexp);
     ASSERT(circ.empty());
     ASSERT(kernelp->c.empty());
     added = kernelp->gate_nonfatal(gname, qubits, cregs, duration, angle);   // creates gates in kernelp->c
@@ -1057,7 +1196,6 @@ void Past::GenMove(ql::circuit &circ, size_t &r0, size_t &r1) {
         // is less equal than threshold cycles (0 would mean scheduling initcirc was for free),
         // commit to it, otherwise abort
         int threshold;
-        std::string mapusemovesopt = ql::options::get("mapusemoves");
         if (mapusemovesopt == "yes") {
             threshold = 0;
         } else {
@@ -1107,7 +1245,6 @@ void Past::AddSwap(size_t r0, size_t r1) {
     }
 
     ql::circuit circ;   // current kernel copy, clear circuit
-    std::string mapusemovesopt = ql::options::get("mapusemoves");
     if (mapusemovesopt != "no" && (v2r.GetRs(r0) != rs_hasstate || v2r.GetRs(r1) != rs_hasstate)) {
         GenMove(circ, r0, r1);
         created = circ.size()!=0;
@@ -1189,15 +1326,6 @@ size_t Past::MapQubit(size_t v) {
     return r;
 }
 
-void Past::stripname(std::string &name) {
-    DOUT("stripname(name=" << name << ")");
-    size_t p = name.find(" ");
-    if (p != std::string::npos) {
-        name = name.substr(0,p);
-    }
-    DOUT("... after stripname name=" << name);
-}
-
 // MakeReal gp
 // assume gp points to a virtual gate with virtual qubit indices as operands;
 // when a gate can be created with the same name but with "_real" appended, with the real qubits as operands, then create that gate
@@ -1228,8 +1356,8 @@ void Past::stripname(std::string &name) {
 void Past::MakeReal(ql::gate *gp, ql::circuit &circ) {
     DOUT("MakeReal: " << gp->qasm());
 
-    std::string gname = gp->name;
-    stripname(gname);
+    std::string namebuf;
+    const std::string &gname = platformp->instructions->base_name(gp, namebuf);
 
     std::vector<size_t> real_qubits  = gp->operands;// starts off as copy of virtual qubits!
     for (auto &qi : real_qubits) {
@@ -1265,8 +1393,8 @@ void Past::MakeReal(ql::gate *gp, ql::circuit &circ) {
 // make primitives of all gates that also have an entry with _prim appended to its name
 // and decomposing it according to the .json file gate decomposition
 void Past::MakePrimitive(ql::gate *gp, ql::circuit &circ) const {
-    std::string gname = gp->name;
-    stripname(gname);
+    std::string namebuf;
+    const std::string &gname = platformp->instructions->base_name(gp, namebuf);
     std::string prim_gname = gname;
     prim_gname.append("_prim");
     bool created = new_gate(circ, prim_gname, gp->operands, gp->creg_operands, gp->duration, gp->angle);
@@ -1289,10 +1417,11 @@ size_t Past::MaxFreeCycle() const {
 // - nonq gates first cause lg to be flushed/cleared to output before the nonq gate is output
 // all gates in outlg are out of view for scheduling/mapping optimization and can be taken out to elsewhere
 void Past::FlushAll() {
-    for (auto &gp : lg) {
-        outlg.push_back(gp);
+    std::list<gate_p> flushedlg;
+    lg.Take(flushedlg); // so effectively, lg's content is moved to outlg
+    for (auto &gp : flushedlg) {
+        outlg.Add(gp);
     }
-    lg.clear();         // so effectively, lg's content was moved to outlg
 
     // fc.Init(platformp); // needed?
     // cycle.clear();      // needed?
@@ -1305,15 +1434,16 @@ void Past::ByPass(ql::gate *gp) {
     if (!lg.empty()) {
         FlushAll();
     }
-    outlg.push_back(gp);
+    outlg.Add(gp);
 }
 
 // mainPast flushes outlg to parameter oc
 void Past::Out(ql::circuit &oc) {
-    for (auto &gp : outlg) {
+    std::list<gate_p> takenlg;
+    outlg.Take(takenlg);
+    for (auto &gp : takenlg) {
         oc.push_back(gp);
     }
-    outlg.clear();
 }
 
 // explicit Alter constructor
@@ -1333,7 +1463,7 @@ void Alter::Init(const ql::quantum_platform *p, ql::quantum_kernel *k, Grid *g)
     nq = platformp->qubit_number;
     ct = platformp->cycle_time;
     // total, fromSource and fromTarget start as empty vectors
-    past.Init(platformp, kernelp, gridp);      // initializes past to empty
+    // past is left virgin; Extend clones the past to be extended into it when evaluating this alternative
     didscore = false;                   // will not print score for now
 }
 
@@ -1574,50 +1704,53 @@ void Future::Init(const ql::quantum_platform *p) {
 }
 
 // Set/switch input to the provided circuit
-// nq and nc are parameters because nc may not be provided by platform but by kernel
-// the latter should be updated when mapping multiple kernels
-void Future::SetCircuit(ql::quantum_kernel &kernel, Scheduler &sched, size_t nq, size_t nc) {
+// graph is the dependence graph of kernel.c, nullptr with maplookahead=no
+void Future::SetCircuit(ql::quantum_kernel &kernel, std::shared_ptr<Scheduler> graph) {
     DOUT("Future::SetCircuit ...");
-    schedp = &sched;
     std::string maplookaheadopt = ql::options::get("maplookahead");
     if (maplookaheadopt == "no") {
         input_gatepv = kernel.c;                                // copy to free original circuit to allow outputing to
-        input_gatepp = input_gatepv.begin();                    // iterator set to start of input circuit copy
+        input_gatepi = 0;                                       // index set to start of input circuit copy
     } else {
-        schedp->init(kernel.c, *platformp, nq, nc);             // fills schedp->graph (dependence graph) from all of circuit
+        schedp = graph;                                         // dependence graph of all of circuit
+        // the graph may be shared with the Futures of other members of a portfolio (see MapPortfolio)
+        std::lock_guard<std::mutex> l(schedp->mutex);
         // and so also the original circuit can be output to after this
-        for (auto &gp : kernel.c) {
-            scheduled[gp] = false;   // none were scheduled
-        }
-        scheduled[schedp->instruction[schedp->s]] = false;      // also the dummy nodes not
-        scheduled[schedp->instruction[schedp->t]] = false;
-        avlist.clear();
-        avlist.push_back(schedp->s);
         schedp->set_remaining(ql::forward_scheduling);          // to know criticality
 
-        if (ql::options::get("print_dot_graphs") == "yes") {
-            std::string     map_dot;
-            std::stringstream fname;
-
-            schedp->get_dot(map_dot);
-
-            fname << ql::options::get("output_dir") << "/" << kernel.name << "_" << "mapper" << ".dot";
-            IOUT("writing " << "mapper" << " dependence graph dot file to '" << fname.str() << "' ...");
-            ql::utils::write_file(fname.str(), map_dot);
-        }
+        // give each node a dense index, its node index; and rank them on deep-criticality, once and for all,
+        // so that avlist can be kept in the order in which the Scheduler keeps its avlist
+        auto fi = std::make_shared<FutureIndex>();
+        size_t  n = schedp->graph.NumNodes();
+        fi->gates = schedp->graph.instruction;
+        fi->remaining = schedp->remaining;
+        fi->index.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            fi->index[fi->gates[i]] = i;
+        }
+        schedp->rank_criticality(ql::forward_scheduling, fi->critrank);
+        fip = fi;
+
+        scheduled.assign(n, false);                             // none were scheduled, also the dummy nodes not
+        avseq.assign(n, std::numeric_limits<size_t>::max());   // none were made available
+        avlist.clear();
+        size_t  si = schedp->s;
+        avseq[si] = 0;                                          // SOURCE is available from the start
+        avlist.insert({fip->critrank[si], avseq[si], si});
+        nextseq = 1;
     }
     DOUT("Future::SetCircuit [DONE]");
 }
 
 // Get from avlist all gates that are non-quantum into nonqlg
-// Non-quantum gates include: classical, and dummy (SOURCE/SINK)
+// Non-quantum gates include: classical, and dummy (SOURCE/SINK/GROUP)
 // Return whether some non-quantum gate was found
 bool Future::GetNonQuantumGates(std::list<ql::gate*> &nonqlg) const {
     nonqlg.clear();
     std::string maplookaheadopt = ql::options::get("maplookahead");
     if (maplookaheadopt == "no") {
-        ql::gate* gp = *input_gatepp;
-        if (input_gatepp != input_gatepv.end()) {
+        if (input_gatepi < input_gatepv.size()) {
+            ql::gate* gp = input_gatepv[input_gatepi];
             if (
                 gp->type() == ql::__classical_gate__
                 || gp->type() == ql::__dummy_gate__
@@ -1626,8 +1759,8 @@ bool Future::GetNonQuantumGates(std::list<ql::gate*> &nonqlg) const {
             }
         }
     } else {
-        for (auto n : avlist) {
-            ql::gate*  gp = schedp->instruction[n];
+        for (auto &av : avlist) {
+            ql::gate*  gp = fip->gates[av.index];
             if (
                 gp->type() == ql::__classical_gate__
                 || gp->type() == ql::__dummy_gate__
@@ -1645,16 +1778,16 @@ bool Future::GetGates(std::list<ql::gate*> &qlg) const {
     qlg.clear();
     std::string maplookaheadopt = ql::options::get("maplookahead");
     if (maplookaheadopt == "no") {
-        if (input_gatepp != input_gatepv.end()) {
-            ql::gate *gp = *input_gatepp;
+        if (input_gatepi < input_gatepv.size()) {
+            ql::gate *gp = input_gatepv[input_gatepi];
             if (gp->operands.size() > 2) {
                 FATAL(" gate: " << gp->qasm() << " has more than 2 operand qubits; please decompose such gates first before mapping.");
             }
             qlg.push_back(gp);
         }
     } else {
-        for (auto n : avlist) {
-            ql::gate *gp = schedp->instruction[n];
+        for (auto &av : avlist) {
+            ql::gate *gp = fip->gates[av.index];
             if (gp->operands.size() > 2) {
                 FATAL(" gate: " << gp->qasm() << " has more than 2 operand qubits; please decompose such gates first before mapping.");
             }
@@ -1664,14 +1797,44 @@ bool Future::GetGates(std::list<ql::gate*> &qlg) const {
     return !qlg.empty();
 }
 
+// Add the gate with index i to avlist, unless it was made available before
+// (a gate can be made available more than once when there are multiple arcs to it from the same gate);
+// unlike Scheduler::MakeAvailable, the cycle attribute of the gate is not updated: the input gates and the graph
+// are shared with the copies of this Future, and the mapper doesn't use their cycle values
+void Future::MakeAvailable(size_t i) {
+    if (avseq[i] != std::numeric_limits<size_t>::max()) {
+        return;
+    }
+    avseq[i] = nextseq++;
+    avlist.insert({fip->critrank[i], avseq[i], i});
+}
+
 // Indicate that a gate currently in avlist has been mapped, can be taken out of the avlist
-// and its successors can be made available
+// and its successors can be made available;
+// this is Scheduler::TakeAvailable on the dense state
 void Future::DoneGate(ql::gate *gp) {
     std::string maplookaheadopt = ql::options::get("maplookahead");
     if (maplookaheadopt == "no") {
-        input_gatepp = std::next(input_gatepp);
+        input_gatepi++;
     } else {
-        schedp->TakeAvailable(schedp->node[gp], avlist, scheduled, ql::forward_scheduling);
+        size_t  i = fip->index.at(gp);
+        scheduled[i] = true;
+        avlist.erase({fip->critrank[i], avseq[i], i});
+
+        const auto &graph = schedp->graph;
+        for (size_t sa = graph.succBegin[i]; sa < graph.succBegin[i+1]; sa++) {
+            size_t succNode = graph.succNode[sa];
+            bool schedulable = true;
+            for (size_t pa = graph.predBegin[succNode]; pa < graph.predBegin[succNode+1]; pa++) {
+                if (!scheduled[graph.predNode[pa]]) {
+                    schedulable = false;
+                    break;
+                }
+            }
+            if (schedulable) {
+                MakeAvailable(succNode);
+            }
+        }
     }
 }
 
@@ -1682,7 +1845,17 @@ ql::gate *Future::MostCriticalIn(std::list<ql::gate*> &lag) const {
     if (maplookaheadopt == "no") {
         return lag.front();
     } else {
-        return schedp->find_mostcritical(lag);
+        // as Scheduler::find_mostcritical: the first one with the highest remaining, none when all are 0
+        size_t maxRemain = 0;
+        ql::gate *mostCriticalGate = nullptr;
+        for (auto gp : lag) {
+            size_t gr = fip->remaining[fip->index.at(gp)];
+            if (gr > maxRemain) {
+                mostCriticalGate = gp;
+                maxRemain = gr;
+            }
+        }
+        return mostCriticalGate;
     }
 }
 
@@ -1748,6 +1921,7 @@ using namespace lemon;
 //  10s     run ip max for 10 seconds; when timed out, just use heuristics
 //  1sx     run ip max for 1 second; when timed out, stop the compiler
 //  1s      run ip max for 1 second; when timed out, just use heuristics
+// Option value sabre is not handled by InitialPlace but by Mapper::SabrePlace, which doesn't need the MIP solver.
 
 typedef enum InitialPlaceResults {
     ipr_any,            // any mapping will do because there are no two-qubit gates in the circuit
@@ -2104,7 +2278,7 @@ public:
         DOUT("... interpret result and copy to Virt2Real, nvq=" << nvq);
         for (size_t v = 0; v < nvq; v++) {
             DOUT("... about to set v2r to undefined for v " << v);
-            v2r[v] = UNDEFINED_QUBIT;      // i.e. undefined, i.e. v is not an index of a used virtual qubit
+            v2r.SetReal(v, UNDEFINED_QUBIT);   // i.e. undefined, i.e. v is not an index of a used virtual qubit
         }
         for (size_t i = 0; i < nfac; i++) {
             size_t v;   // found virtual qubit index v represented by facility i
@@ -2119,7 +2293,7 @@ public:
             size_t k;   // location to which facility i being virtual qubit index v was allocated
             for (k = 0; k < nlocs; k++) {
                 if (mip.sol(x[i][k]) == 1) {
-                    v2r[v] = k;
+                    v2r.SetReal(v, k);
                     // v2r.rs[] is not updated because no gates were really mapped yet
                     break;
                 }
@@ -2140,20 +2314,14 @@ public:
                     // v is unused by this kernel; find an unused location k
                     size_t k;   // location k that is checked for having been allocated to some virtual qubit w
                     for (k = 0; k < nlocs; k++) {
-                        size_t w;
-                        for (w = 0; w < nvq; w++) {
-                            if (v2r[w] == k) {
-                                break;
-                            }
-                        }
-                        if (w >= nvq) {
+                        if (v2r.GetVirt(k) == UNDEFINED_QUBIT) {
                             // no w found for which v2r[w] == k
                             break;     // k is an unused location
                         }
                         // k is a used location, so continue with next k to check whether it is hopefully unused
                     }
                     ASSERT(k < nlocs);  // when a virtual qubit is not used, there must be a location that is not used
-                    v2r[v] = k;
+                    v2r.SetReal(v, k);
                 }
                 DOUT("... end loop body over nvq when mapinitone2oneopt");
             }
@@ -2273,25 +2441,15 @@ public:
 // Find shortest paths between src and tgt in the grid, bounded by a particular strategy (which);
 // budget is the maximum number of hops allowed in the path from src and is at least distance to tgt;
 // it can be higher when not all hops qualify for doing a two-qubit gate or to find more than just the shortest paths.
-void Mapper::GenShortestPaths(ql::gate *gp, size_t src, size_t tgt, size_t budget, std::list<Alter> &resla, whichpaths_t which) {
-    std::list<Alter> genla;    // list that will get the result of a recursive Gen call
-
+void Mapper::GenShortestPaths(size_t src, size_t tgt, size_t budget, std::vector<size_t> &path, GridPaths::paths_t &resps, whichpaths_t which) {
     // DOUT("GenShortestPaths: " << "src=" << src << " tgt=" << tgt << " budget=" << budget << " which=" << which);
-    ASSERT(resla.empty());
+    path.push_back(src);
 
     if (src == tgt) {
         // found target
-        // create a virgin Alter and initialize it to become an empty path
-        // add src to this path (so that it becomes a distance 0 path with one qubit, src)
-        // and add the Alter to the result list
-        Alter a;
-        a.Init(platformp, kernelp, &grid);
-        a.targetgp = gp;
-        a.Add2Front(src);
-        resla.push_back(a);
-        // a.DPRINT("... empty path after adding to result list");
-        // Alter::DPRINT("... result list after adding empty path", resla);
-        // DOUT("... will return now");
+        // the path thisfar is a complete path to tgt, add it to the result
+        resps.push_back(path);
+        path.pop_back();
         return;
     }
 
@@ -2303,7 +2461,7 @@ void Mapper::GenShortestPaths(ql::gate *gp, size_t src, size_t tgt, size_t budge
     // src=>tgt is distance d, budget>=d is allowed, attempt src->n=>tgt
     // src->n is one hop, budget from n is one less so distance(n,tgt) <= budget-1 (i.e. distance < budget)
     // when budget==d, this defaults to distance(n,tgt) <= d-1
-    auto nbl = grid.nbs[src];
+    auto nbl = grid.nbs.at(src);
     nbl.remove_if([this,budget,tgt](const size_t& n) { return grid.Distance(n,tgt) >= budget; });
 
     // rotate neighbor list nbl such that largest difference between angles of adjacent elements is beyond back()
@@ -2333,16 +2491,10 @@ void Mapper::GenShortestPaths(ql::gate *gp, size_t src, size_t tgt, size_t budge
                 newwhich = wp_right_shortest;
             }
         }
-        GenShortestPaths(gp, n, tgt, budget-1, genla, newwhich);  // get list of possible paths in budget-1 from n to tgt in genla
-        resla.splice(resla.end(), genla);           // moves all of genla to resla; makes genla empty
-    }
-    // resla contains all paths starting from a neighbor of src, to tgt
-
-    // add src to front of all to-be-returned paths from src's neighbors to tgt
-    for (auto &a : resla) {
-        // DOUT("... GenShortestPaths, about to add src=" << src << "in front of path");
-        a.Add2Front(src);
+        GenShortestPaths(n, tgt, budget-1, path, resps, newwhich);  // add paths in budget-1 from n to tgt to resps
     }
+    // resps contains all paths starting with the path thisfar, src, and a neighbor of src, to tgt
+    path.pop_back();
     // DOUT("... GenShortestPaths: returning from call of:" << "src=" << src << " tgt=" << tgt << " budget=" << budget << " which=" << which);
 }
 
@@ -2357,20 +2509,28 @@ void Mapper::GenShortestPaths(ql::gate *gp, size_t src, size_t tgt, size_t budge
 //      all result alternatives are such that a two-qubit gate can be placed at the split
 // End result is a list of alternatives (in resla) suitable for being evaluated for any routing metric.
 void Mapper::GenShortestPaths(ql::gate *gp, size_t src, size_t tgt, std::list<Alter> &resla) {
-    std::list<Alter> directla;  // list that will hold all not-yet-split Alters directly from src to tgt
-
-    size_t budget = grid.MinHops(src, tgt);
-    std::string mappathselectopt = ql::options::get("mappathselect");
+    whichpaths_t which;
     if (mappathselectopt == "all") {
-        GenShortestPaths(gp, src, tgt, budget, directla, wp_all_shortest);
+        which = wp_all_shortest;
     } else if (mappathselectopt == "borders") {
-        GenShortestPaths(gp, src, tgt, budget, directla, wp_leftright_shortest);
+        which = wp_leftright_shortest;
     } else {
         FATAL("Unknown value of mapppathselect option " << mappathselectopt);
     }
 
+    // the paths only depend on src, tgt and which (budget depends on src and tgt), so they are generated once
+    // for the grid, and for a next gate with the same real operands, these are found in the grid's path cache
+    auto ps = grid.Paths((src*nq + tgt)*4 + which, [this, src, tgt, which](GridPaths::paths_t &resps) {
+        std::vector<size_t> path;
+        GenShortestPaths(src, tgt, grid.MinHops(src, tgt), path, resps, which);
+    });
+
     // DOUT("about to split the paths");
-    for (auto &a : directla) {
+    Alter a;                    // the alternative directly from src to tgt of each path, before splitting
+    a.Init(platformp, kernelp, &grid);
+    a.targetgp = gp;
+    for (auto &p : *ps) {
+        a.total = p;
         a.Split(grid, resla);
     }
     // Alter::DPRINT("... after generating and splitting the paths", resla);
@@ -2430,7 +2590,6 @@ Alter Mapper::ChooseAlter(std::list<Alter> &la, Future &future) {
         return la.front();
     }
 
-    std::string maptiebreakopt = ql::options::get("maptiebreak");
     if (maptiebreakopt == "critical") {
         std::list<ql::gate*> lag;
         for (auto &a : la) {
@@ -2450,7 +2609,11 @@ Alter Mapper::ChooseAlter(std::list<Alter> &la, Future &future) {
     if (maptiebreakopt == "random") {
         Alter res;
         std::uniform_int_distribution<> dis(0, (la.size()-1));
-        size_t choice = dis(gen);
+        size_t choice;
+        {
+            std::lock_guard<std::mutex> l(threads.genmutex);
+            choice = dis(gen);
+        }
         size_t i = 0;
         for (auto &a : la) {
             if (i == choice) {
@@ -2546,7 +2709,7 @@ bool Mapper::MapMappableGates(Future &future, Past &past, std::list<ql::gate*> &
             DOUT("MapMappableGates, there is a set of non-quantum gates");
             for (auto gp : nonqlg) {
                 // here add code to map qubit use of any non-quantum instruction????
-                // dummy gates are nonq gates internal to OpenQL such as SOURCE/SINK; don't output them
+                // dummy gates are nonq gates internal to OpenQL such as SOURCE/SINK/GROUP; don't output them
                 if (gp->type() != ql::__dummy_gate__) {
                     // past only can contain quantum gates, so non-quantum gates must by-pass Past
                     past.ByPass(gp);    // this flushes past.lg first to outlg
@@ -2622,6 +2785,37 @@ bool Mapper::MapMappableGates(Future &future, Past &past, std::list<ql::gate*> &
     }
 }
 
+// apply evaluate to each alternative in la;
+// at recursion level 0 and when option mapthreads allows more than one thread, this is done by the threads
+// of the Mapper's pool, that each repeatedly take the next alternative that was not evaluated yet;
+// evaluate only updates its own alternative and objects private to it, and reads shared objects,
+// so the results do not depend on the number of threads nor on the order of evaluation;
+// deeper levels of recursion are evaluated sequentially by the thread that evaluates the alternative at level 0
+void Mapper::EvaluateAlters(std::list<Alter> &la, int level, const std::function<void(Alter &)> &evaluate) {
+    size_t nthreads = 1;
+    if (level == 0) {
+        nthreads = ql::utils::thread_pool::threads_option(ql::options::get("mapthreads"));
+    }
+    if (nthreads <= 1 || la.size() <= 1) {
+        for (auto &a : la) {
+            evaluate(a);
+        }
+        return;
+    }
+
+    // the pool is created once per Mapper, and again only when option mapthreads was changed
+    if (!threads.pool || threads.pool->size() != nthreads) {
+        threads.pool.reset(new ql::utils::thread_pool(nthreads));
+    }
+    std::vector<Alter *> va;
+    for (auto &a : la) {
+        va.push_back(&a);
+    }
+    DOUT("EvaluateAlters: evaluating " << va.size() << " alternatives by " << nthreads << " threads");
+    // the failure of the first alternative in la that failed is reported, as would have happened sequentially
+    threads.pool->run(va.size(), [&va, &evaluate](size_t i) { evaluate(*va[i]); });
+}
+
 // select Alter determined by strategy defined by mapper options
 // - if base[rc], select from whole list of Alters, of which all 'remain'
 // - if minextend[rc], select Alter from list of Alters with minimal cycle extension of given past
@@ -2648,12 +2842,16 @@ void Mapper::SelectAlter(std::list<Alter> &la, Alter &resa, Future &future, Past
     }
     ASSERT(mapperopt == "minextend" || mapperopt == "minextendrc" || mapperopt == "maxfidelity");
 
+    // Fold past's gate lists into bases that are then shared by all copies made while evaluating the alternatives;
+    // these copies, possibly made in parallel (see EvaluateAlters), only read past
+    past.Fold();
+
     // Compute a.score of each alternative relative to basePast, and sort la on it, minimum first
-    for (auto &a : la) {
+    EvaluateAlters(la, level, [&past, &basePast](Alter &a) {
         a.DPRINT("Considering extension by alternative: ...");
         a.Extend(past, basePast);           // locally here, past will be cloned and kept in alter
         // and the extension stored into the a.score
-    }
+    });
     la.sort([this](const Alter &a1, const Alter &a2) { return a1.score < a2.score; });
     Alter::DPRINT("... SelectAlter sorted all entry alternatives after extension:", la);
 
@@ -2728,7 +2926,7 @@ void Mapper::SelectAlter(std::list<Alter> &la, Alter &resa, Future &future, Past
     // This means that recursion always goes to maxlevel or end-of-circuit.
     // This anomaly may need correction.
     // DOUT("... SelectAlter level=" << level << " entering recursion with " << gla.size() << " good alternatives");
-    for (auto &a : gla) {
+    EvaluateAlters(gla, level, [this, &future, &past, &basePast, level](Alter &a) {
         a.DPRINT("... ... considering alternative:");
         Future future_copy = future;            // copy!
         Past   past_copy = past;                // copy!
@@ -2773,7 +2971,7 @@ void Mapper::SelectAlter(std::list<Alter> &la, Alter &resa, Future &future, Past
             a.DPRINT("... ... SelectAlter, after committing this alternative, mapped easy gates, no gates to evaluate next; RECURSION BOTTOM");
         }
         a.DPRINT("... ... DONE considering alternative:");
-    }
+    });
     // Sort list of good alternatives (gla) on score resulting after recursion
     gla.sort([this](const Alter &a1, const Alter &a2) { return a1.score < a2.score; });
     Alter::DPRINT("... SelectAlter sorted alternatives after recursion:", gla);
@@ -2795,6 +2993,10 @@ void Mapper::SelectAlter(std::list<Alter> &la, Alter &resa, Future &future, Past
 // during recursion, comparison is done with the base past (bottom of recursion stack),
 // and past is the last past (top of recursion stack) relative to which the mapping is done.
 void Mapper::MapGates(Future &future, Past &past, Past &basePast) {
+    if (ql::options::get("mapper") == "beam") {
+        MapGatesBeam(future, past);
+        return;
+    }
     std::list<ql::gate*> lg;              // list of non-mappable gates taken from avlist, as returned from MapMappableGates
     std::string maplookaheadopt = ql::options::get("maplookahead");
     bool alsoNN2q = (maplookaheadopt == "noroutingfirst" || maplookaheadopt == "all");
@@ -2818,18 +3020,211 @@ void Mapper::MapGates(Future &future, Past &past, Past &basePast) {
     }
 }
 
+// compute s.cost from the latency of s.past and the distances between the operands of the gates in s.lg,
+// each hop still to be made being estimated to take hopcycles cycles
+void Mapper::BeamCost(BeamState &s, size_t hopcycles) {
+    size_t hops = 0;
+    for (auto gp : s.lg) {
+        auto &q = gp->operands;
+        hops += grid.MinHops(s.past.MapQubit(q[0]), s.past.MapQubit(q[1])) - 1;
+    }
+    s.cost = s.past.MaxFreeCycle() + hops * hopcycles;
+}
+
+// mapper=beam: map all gates from future into past by a beam search over partial routings;
+// in each step, each routing in the beam is extended by each of its alternatives,
+// and only the mapbeamwidth ones with lowest cost of the resulting ones are kept, duplicates removed;
+// this continues until all routings in the beam have mapped all gates; the one with lowest cost is the result
+//
+// The cost of the routing resulting from an alternative is estimated before it is created,
+// from a copy of the past of the routing it extends only; so per step only the kept routings copy a future
+//
+// Compared to minextend, which commits to one alternative in each step (possibly after looking ahead by recursion),
+// this keeps several routings alive and so can recover from a step that looked best but wasn't;
+// the amount of work per step is bounded by mapbeamwidth times the number of alternatives of a routing.
+void Mapper::MapGatesBeam(Future &future, Past &past) {
+    std::string maplookaheadopt = ql::options::get("maplookahead");
+    bool alsoNN2q = (maplookaheadopt == "noroutingfirst" || maplookaheadopt == "all");
+    size_t beamwidth = atoi(ql::options::get("mapbeamwidth").c_str());
+
+    // each hop still to be made requires a swap, so estimate its duration by the one of a swap, when configured
+    size_t hopcycles = 1;
+    if (platformp->instruction_settings.count("swap") > 0) {
+        size_t duration = platformp->instruction_settings["swap"]["duration"];
+        hopcycles = (duration + cycle_time - 1) / cycle_time;
+    }
+    DOUT("MapGatesBeam: mapbeamwidth=" << beamwidth << " hopcycles=" << hopcycles);
+
+    std::vector<BeamState> beam(1);
+    beam[0].future = future;
+    beam[0].past = past;
+    beam[0].havegates = MapMappableGates(beam[0].future, beam[0].past, beam[0].lg, alsoNN2q);
+    BeamCost(beam[0], hopcycles);
+
+    bool havegates = beam[0].havegates;
+    while (havegates) {
+        // generate the alternatives of all routings that still have gates to route;
+        // the routings that have mapped all gates are carried over as they are
+        std::list<Alter> la;                // alternatives of all routings in the beam
+        std::vector<size_t> parent;         // parent[i]: index in beam of the routing that the i-th alternative extends
+        std::vector<size_t> finished;       // indices in beam of the routings that have mapped all gates
+        for (size_t b = 0; b < beam.size(); b++) {
+            if (beam[b].havegates) {
+                GenAlters(beam[b].lg, la, beam[b].past);
+                parent.resize(la.size(), b);
+                // the alternatives below copy this past, possibly in parallel, so it must not change while they do
+                beam[b].past.Fold();
+            } else {
+                finished.push_back(b);
+            }
+        }
+        std::vector<Alter *> va;
+        for (auto &a : la) {
+            va.push_back(&a);
+        }
+        std::map<const Alter*, size_t> index;   // index[&a]: position of a in la
+        for (size_t i = 0; i < va.size(); i++) {
+            index[va[i]] = i;
+        }
+
+        // score each alternative without copying the future of the routing it extends:
+        // add all its swaps to a copy of the routing's past, and estimate the cost of the routing after it
+        // from the latency of that past and the hops still to be made by the gates that the routing faces;
+        // the copy is then discarded, so memory is not taken by routings that are not kept
+        std::vector<size_t> estimate(va.size());
+        std::vector<size_t> nswaps(va.size());
+        std::vector<std::vector<size_t>> v2rkey(va.size());
+        EvaluateAlters(la, 0, [this, &beam, &parent, &index, &estimate, &nswaps, &v2rkey, hopcycles](Alter &a) {
+            size_t i = index.at(&a);
+            Past p = beam[parent[i]].past;
+            a.AddSwaps(p, "all");
+            size_t hops = 0;
+            for (auto gp : beam[parent[i]].lg) {
+                auto &q = gp->operands;
+                hops += grid.MinHops(p.MapQubit(q[0]), p.MapQubit(q[1])) - 1;
+            }
+            estimate[i] = p.MaxFreeCycle() + hops * hopcycles;
+            nswaps[i] = p.NumberOfSwapsAdded();
+            Virt2Real v2r;
+            p.ExportV2r(v2r);
+            v2r.Export(v2rkey[i]);
+        });
+
+        // rank the finished routings and the alternatives together on cost,
+        // then on number of swaps added, then on the order in which they were generated
+        size_t nfinished = finished.size();
+        auto cost = [&beam, &finished, &estimate, nfinished](size_t x) { return x < nfinished ? beam[finished[x]].cost : estimate[x-nfinished]; };
+        auto swaps = [&beam, &finished, &nswaps, nfinished](size_t x) {
+            return x < nfinished ? beam[finished[x]].past.NumberOfSwapsAdded() : nswaps[x-nfinished];
+        };
+        std::vector<size_t> order(nfinished + va.size());
+        for (size_t x = 0; x < order.size(); x++) {
+            order[x] = x;
+        }
+        std::stable_sort(order.begin(), order.end(), [&cost, &swaps](size_t x, size_t y) {
+            if (cost(x) != cost(y)) {
+                return cost(x) < cost(y);
+            }
+            return swaps(x) < swaps(y);
+        });
+
+        // keep the best beamwidth of these, skipping alternatives that duplicate a better one:
+        // resulting in the same mapping, with the same cost and the same number of swaps,
+        // from routings with the same gates still to map and for the same target gate;
+        // these usually are the result of the same swaps being added in a different order
+        std::vector<std::vector<size_t>> futurekey(beam.size());
+        for (size_t b = 0; b < beam.size(); b++) {
+            futurekey[b].push_back(beam[b].future.input_gatepi);
+            for (auto &av : beam[b].future.avlist) {
+                futurekey[b].push_back(av.index);
+            }
+        }
+        std::set<std::vector<size_t>> seen;
+        std::vector<size_t> kept;           // indices in order of the kept ones
+        for (auto x : order) {
+            if (kept.size() >= beamwidth) {
+                break;
+            }
+            if (x >= nfinished) {
+                size_t i = x - nfinished;
+                std::vector<size_t> key = v2rkey[i];
+                key.push_back(cost(x));
+                key.push_back(swaps(x));
+                key.push_back(size_t(va[i]->targetgp));
+                key.insert(key.end(), futurekey[parent[i]].begin(), futurekey[parent[i]].end());
+                if (!seen.insert(key).second) {
+                    continue;
+                }
+            }
+            kept.push_back(x);
+        }
+
+        // only now create the kept routings: commit each kept alternative in a copy of the routing it extends,
+        // and map the gates that became mappable
+        std::vector<BeamState> next(kept.size());
+        std::list<Alter> kla;               // the kept alternatives
+        std::map<const Alter*, size_t> knext;   // knext[&a]: position in next of the routing that a creates
+        for (size_t k = 0; k < kept.size(); k++) {
+            if (kept[k] < nfinished) {
+                next[k] = beam[finished[kept[k]]];
+            } else {
+                kla.push_back(*va[kept[k] - nfinished]);
+                knext[&kla.back()] = k;
+            }
+        }
+        EvaluateAlters(kla, 0, [this, &beam, &next, &kept, &knext, &parent, nfinished, alsoNN2q, hopcycles](Alter &a) {
+            size_t k = knext.at(&a);
+            BeamState &s = next[k];
+            s.future = beam[parent[kept[k] - nfinished]].future;
+            s.past = beam[parent[kept[k] - nfinished]].past;
+            CommitAlter(a, s.future, s.past);
+            s.havegates = MapMappableGates(s.future, s.past, s.lg, alsoNN2q);
+            BeamCost(s, hopcycles);
+        });
+
+        // order the new beam on its actual cost, so that its front is the best routing
+        std::stable_sort(next.begin(), next.end(), [](const BeamState &x, const BeamState &y) {
+            if (x.cost != y.cost) {
+                return x.cost < y.cost;
+            }
+            return x.past.NumberOfSwapsAdded() < y.past.NumberOfSwapsAdded();
+        });
+        beam.swap(next);
+        havegates = false;
+        for (auto &s : beam) {
+            havegates = havegates || s.havegates;
+        }
+        DOUT("MapGatesBeam: step from " << la.size() << " alternatives and " << nfinished << " finished routings to "
+            << beam.size() << " routings; best cost=" << beam.front().cost);
+    }
+
+    future = beam.front().future;
+    past = beam.front().past;
+}
+
+// the dependence graph of circuit ckt for Future::SetCircuit, nullptr with maplookahead=no
+// with the mapper's nq and nc, since nc may not be provided by platform but by kernel
+std::shared_ptr<Scheduler> Mapper::DependenceGraph(ql::circuit &ckt) {
+    if (ql::options::get("maplookahead") == "no") {
+        return nullptr;
+    }
+    auto graph = std::make_shared<Scheduler>();
+    graph->init(ckt, *platformp, nq, nc);
+    graph->circp = nullptr;     // ckt may be a temporary, see circuit_binding
+    return graph;
+}
+
 // Map the circuit's gates in the provided context (v2r maps), updating circuit and v2r maps
-void Mapper::MapCircuit(ql::quantum_kernel &kernel, Virt2Real &v2r) {
+void Mapper::MapCircuit(ql::quantum_kernel &kernel, Virt2Real &v2r, std::shared_ptr<Scheduler> graph) {
     Future  future;         // future window, presents input in avlist
     Past    mainPast;       // past window, contains output schedule, storing all gates until taken out
-    Scheduler sched;        // new scheduler instance (from src/scheduler.h) used for its dependence graph
 
     future.Init(platformp);
-    future.SetCircuit(kernel, sched, nq, nc); // constructs depgraph, initializes avlist, ready for producing gates
+    future.SetCircuit(kernel, graph); // takes depgraph, initializes avlist, ready for producing gates
     kernel.c.clear();       // future has copied kernel.c to private data; kernel.c ready for use by new_gate
     kernelp = &kernel;      // keep kernel to call kernelp->gate() inside Past.new_gate(), to create new gates
 
-    mainPast.Init(platformp, kernelp, &grid);  // mainPast and Past clones inside Alters ready for generating output schedules into
+    mainPast.Init(platformp, kernelp, &grid, mapusemovesopt);  // mainPast and Past clones inside Alters ready for generating output schedules into
     mainPast.ImportV2r(v2r);    // give it the current mapping/state
     // mainPast.DPRINT("start mapping");
 
@@ -2848,6 +3243,151 @@ void Mapper::MapCircuit(ql::quantum_kernel &kernel, Virt2Real &v2r) {
     nmovesadded = mainPast.NumberOfMovesAdded();
 }
 
+// initialplace=sabre: compute an initial mapping by routing the circuit back and forth with the heuristic mapper;
+// each pass starts from the mapping in which the previous pass ended, on a scratch copy of the kernel,
+// the backward passes on the circuit reversed, so that the mapping in which the final backward pass ends,
+// is one that suits the start of the circuit; since only the mapping is taken over and not the states
+// of the real qubits (which the trial passes changed by executing gates), v2r is updated in place;
+// each pass is a single heuristic mapping of the circuit, so the time taken is linear in that
+void Mapper::SabrePlace(ql::quantum_kernel &kernel, Virt2Real &v2r, std::shared_ptr<Scheduler> &graph) {
+    const size_t nroundtrips = 2;   // each a forward and a backward pass
+
+    ql::circuit forwardCirc = kernel.c;
+    ql::circuit backwardCirc(forwardCirc.rbegin(), forwardCirc.rend());
+
+    Virt2Real   passv2r = v2r;
+    graph = DependenceGraph(forwardCirc);       // the dependence graphs are built once for all passes
+    std::shared_ptr<Scheduler> backwardGraph = DependenceGraph(backwardCirc);
+    for (size_t t = 0; t < nroundtrips; t++) {
+        for (auto circp : { &forwardCirc, &backwardCirc }) {
+            ql::quantum_kernel scratch = kernel;    // new gates of the pass go to its circuit, leaving kernel as is
+            scratch.arena = std::make_shared<ql::gate_arena>(kernel.instructions);   // and are released with it
+            scratch.c = *circp;
+            MapCircuit(scratch, passv2r, (circp == &forwardCirc ? graph : backwardGraph));
+            DOUT("SabrePlace: " << (circp == &forwardCirc ? "forward" : "backward") << " pass " << t << " added " << nswapsadded << " swaps");
+        }
+    }
+    kernelp = NULL;             // scratch kernel is gone
+
+    for (size_t v = 0; v < nq; v++) {
+        v2r.SetReal(v, UNDEFINED_QUBIT);
+    }
+    for (size_t v = 0; v < nq; v++) {
+        v2r.SetReal(v, passv2r[v]);
+    }
+}
+
+// mapportfolio: map the circuit by several members in parallel, each with its own configuration, and take the best;
+// member 0 uses the configuration given by the options, so that a portfolio never does worse than a single mapping;
+// with mapportfolio=configs, the other members take the next combinations of values
+// of maptiebreak, mappathselect (only on a grid with x/y coordinates) and mapusemoves;
+// with mapportfolio=seeds, they use maptiebreak=random, each with a different fixed seed;
+// mapportfolio=all does configs first and fills up the portfolio with seeds;
+// the fixed seeds make the result reproducible, which the time-based seed of member 0 (when random) is not
+void Mapper::MapPortfolio(ql::quantum_kernel &kernel, Virt2Real &v2r, std::shared_ptr<Scheduler> graph) {
+    struct PortfolioConfig {
+        std::string maptiebreak;
+        std::string mappathselect;
+        std::string mapusemoves;
+        size_t      seed;           // 0 when using the seed from RandomInit
+    };
+
+    std::string mapportfolioopt = ql::options::get("mapportfolio");
+    size_t      size = atoi(ql::options::get("mapportfoliosize").c_str());
+    std::vector<PortfolioConfig> configs;
+    configs.push_back({maptiebreakopt, mappathselectopt, mapusemovesopt, 0});
+    if (mapportfolioopt == "configs" || mapportfolioopt == "all") {
+        std::vector<std::string> usemovesvals = { mapusemovesopt, (mapusemovesopt == "no" ? "yes" : "no") };
+        std::vector<std::string> pathselectvals = { mappathselectopt };
+        if (grid.form == gf_xy) {
+            pathselectvals.push_back(mappathselectopt == "all" ? "borders" : "all");
+        }
+        std::vector<std::string> tiebreakvals = { maptiebreakopt };
+        for (auto &tb : { "first", "critical", "last", "random" }) {
+            if (tb != maptiebreakopt) {
+                tiebreakvals.push_back(tb);
+            }
+        }
+        for (auto &um : usemovesvals) {
+            for (auto &ps : pathselectvals) {
+                for (auto &tb : tiebreakvals) {
+                    if (configs.size() < size && (tb != maptiebreakopt || ps != mappathselectopt || um != mapusemovesopt)) {
+                        configs.push_back({tb, ps, um, (tb == "random" ? configs.size() : 0)});
+                    }
+                }
+            }
+        }
+    }
+    if (mapportfolioopt == "seeds" || mapportfolioopt == "all") {
+        while (configs.size() < size) {
+            configs.push_back({"random", mappathselectopt, mapusemovesopt, configs.size()});
+        }
+    }
+
+    size_t n = configs.size();
+    std::vector<Mapper> mappers(n, *this);
+    std::vector<ql::quantum_kernel> kernels(n, kernel);
+    std::vector<Virt2Real> v2rs(n, v2r);
+    for (size_t i = 0; i < n; i++) {
+        // each member creates its gates in an arena of its own, so that only those of the best one are kept
+        kernels[i].arena = std::make_shared<ql::gate_arena>(kernel.instructions);
+        mappers[i].maptiebreakopt = configs[i].maptiebreak;
+        mappers[i].mappathselectopt = configs[i].mappathselect;
+        mappers[i].mapusemovesopt = configs[i].mapusemoves;
+        if (configs[i].seed != 0) {
+            mappers[i].gen.seed(configs[i].seed);
+        }
+    }
+
+    DOUT("MapPortfolio: mapping kernel " << kernel.name << " by " << n << " members");
+    ql::utils::thread_pool pool(n);
+    pool.run(n, [&mappers, &kernels, &v2rs, &graph](size_t i) {
+        mappers[i].MapCircuit(kernels[i], v2rs[i], graph);    // all members share the one dependence graph
+    });
+
+    // select the member with lowest depth or number of swaps, with the other as secondary criterion;
+    // on a tie, the member with the lowest index is taken
+    bool byswaps = (ql::options::get("mapportfoliometric") == "swaps");
+    size_t best = 0;
+    std::vector<size_t> depths(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        for (auto gp : kernels[i].c) {
+            // only the gates that the member scheduled: the non-quantum ones that Past::ByPass passed through
+            // have no cycle (MAX_CYCLE) or one from before mapping
+            if (gp->type() == ql::__classical_gate__ || gp->type() == ql::__dummy_gate__ || gp->cycle == MAX_CYCLE) {
+                continue;
+            }
+            depths[i] = std::max(depths[i], gp->cycle + (gp->duration+cycle_time-1)/cycle_time);
+        }
+        auto key = [&](size_t j) {
+            return byswaps ? std::make_pair(mappers[j].nswapsadded, depths[j])
+                           : std::make_pair(depths[j], mappers[j].nswapsadded);
+        };
+        DOUT("MapPortfolio: member " << i << " depth=" << depths[i] << " swaps=" << mappers[i].nswapsadded);
+        if (key(i) < key(best)) {
+            best = i;
+        }
+    }
+
+    std::stringstream ss;
+    ss << "member " << best << " of " << n << ": maptiebreak=" << configs[best].maptiebreak;
+    if (configs[best].seed != 0) {
+        ss << " (seed " << configs[best].seed << ")";
+    }
+    ss << " mappathselect=" << configs[best].mappathselect << " mapusemoves=" << configs[best].mapusemoves
+       << ", depth=" << depths[best];
+    portfoliowinner = ss.str();
+    DOUT("MapPortfolio: took " << portfoliowinner);
+
+    kernel.c.swap(kernels[best].c);
+    kernel.arena->adopt(*kernels[best].arena);
+    kernel.cycles_valid = true;
+    kernelp = &kernel;          // as MapCircuit would leave it
+    v2r = v2rs[best];
+    nswapsadded = mappers[best].nswapsadded;
+    nmovesadded = mappers[best].nmovesadded;
+}
+
 // decompose all gates that have a definition with _prim appended to its name
 void Mapper::MakePrimitives(ql::quantum_kernel &kernel) {
     DOUT("MakePrimitives circuit ...");
@@ -2856,7 +3396,7 @@ void Mapper::MakePrimitives(ql::quantum_kernel &kernel) {
     kernel.c.clear();                           // kernel.c ready for use by new_gate
 
     Past            mainPast;                   // output window in which gates are scheduled
-    mainPast.Init(platformp, kernelp, &grid);
+    mainPast.Init(platformp, kernelp, &grid, mapusemovesopt);
 
     for (auto & gp : input_gatepv) {
         ql::circuit tmpCirc;
@@ -2883,6 +3423,7 @@ void Mapper::Map(ql::quantum_kernel& kernel) {
     kernelp = NULL;             // no new_gates until kernel.c has been copied
 
     Virt2Real   v2r;            // current mapping while mapping this kernel
+    std::shared_ptr<Scheduler> graph;   // dependence graph of the input circuit, shared by SabrePlace and mapping
 
     auto mapassumezeroinitstateopt = ql::options::get("mapassumezeroinitstate");
     DOUT("Mapper::Map before v2r.Init: mapassumezeroinitstateopt=" << mapassumezeroinitstateopt);
@@ -2890,13 +3431,20 @@ void Mapper::Map(ql::quantum_kernel& kernel) {
     // unify all incoming v2rs into v2r to compute kernel input mapping;
     // but until inter-kernel mapping is implemented, take program initial mapping for it
     v2r.Init(nq);               // v2r now contains program initial mapping
+    maptiebreakopt = ql::options::get("maptiebreak");
+    mappathselectopt = ql::options::get("mappathselect");
+    mapusemovesopt = ql::options::get("mapusemoves");
     v2r.DPRINT("After initialization");
 
     v2r.Export(v2r_in);  // from v2r to caller for reporting
     v2r.Export(rs_in);   // from v2r to caller for reporting
 
     std::string initialplaceopt = ql::options::get("initialplace");
-    if (initialplaceopt != "no") {
+    if (initialplaceopt == "sabre") {
+        DOUT("SabrePlace: kernel=" << kernel.name << " [START]");
+        SabrePlace(kernel, v2r, graph); // compute mapping (in v2r) by heuristic mapping passes forward and backward
+        DOUT("SabrePlace: kernel=" << kernel.name << " [DONE]");
+    } else if (initialplaceopt != "no") {
 #ifdef INITIALPLACE
         std::string initialplace2qhorizonopt = ql::options::get("initialplace2qhorizon");
         DOUT("InitialPlace: kernel=" << kernel.name << " initialplace=" << initialplaceopt << " initialplace2qhorizon=" << initialplace2qhorizonopt << " [START]");
@@ -2920,7 +3468,25 @@ void Mapper::Map(ql::quantum_kernel& kernel) {
     mapassumezeroinitstateopt = ql::options::get("mapassumezeroinitstate");
     DOUT("Mapper::Map before MapCircuit: mapassumezeroinitstateopt=" << mapassumezeroinitstateopt);
 
-    MapCircuit(kernel, v2r);        // updates kernel.c with swaps, maps all gates, updates v2r map
+    if (!graph) {
+        graph = DependenceGraph(kernel.c);
+    }
+    // written once here and not by each member of a portfolio, which would all write the same file
+    if (graph && graph->print_dot_enabled(kernel.name)) {
+        std::stringstream fname;
+        fname << ql::options::get("output_dir") << "/" << kernel.name << "_" << "mapper" << ".dot";
+        IOUT("writing " << "mapper" << " dependence graph dot file to '" << fname.str() << "' ...");
+        ql::circuit_binding binding(*graph, kernel.c);
+        graph->write_dot(fname.str(), true);
+    }
+
+    portfoliowinner = "";
+    if (ql::options::get("mapportfolio") == "no") {
+        MapCircuit(kernel, v2r, graph);     // updates kernel.c with swaps, maps all gates, updates v2r map
+    } else {
+        MapPortfolio(kernel, v2r, graph);   // same, but by a portfolio of mappers of which the best result is taken
+    }
+    graph.reset();                  // the dependence graph of the input circuit is no longer of use
     v2r.DPRINT("After heuristics");
 
     MakePrimitives(kernel);         // decompose to primitives as specified in the config file
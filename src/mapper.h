@@ -8,6 +8,11 @@
 #pragma once
 
 #include <random>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <mutex>
 #include <chrono>
 #include <ctime>
 #include <ratio>
@@ -17,6 +22,7 @@
 #include "resource_manager.h"
 #include "gate.h"
 #include "scheduler.h"
+#include "thread_pool.h"
 //#include "metrics.h"
 
 namespace ql {
@@ -53,7 +59,7 @@ namespace ql {
 // Grid public members (apart from nq):
 //  form:               how relation between neighbors is specified
 //  Distance(qi,qj):    distance in physical connection hops from real qubit qi to real qubit qj;
-//                      - computing it relies on nbs (and Floyd-Warshall) (gf_xy and gf_irregular)
+//                      - computing it relies on nbs (and BFS) (gf_xy and gf_irregular)
 //  nbs[qi]:            list of neighbor real qubits of real qubit qi
 //                      - nbs can be derived from topology.edges (gf_xy and gf_irregular)
 //  Normalize(qi, neighborlist):    rotate neighborlist such that largest angle diff around qi is behind last element
@@ -85,6 +91,14 @@ typedef enum GridForms {
     gf_irregular    // nodes have explicit neighbor definitions, qubits don't have x/y coordinates
 } gridform_t;
 
+// path sets of a grid, see Grid::Paths
+class GridPaths {
+public:
+    typedef std::vector<std::vector<size_t>> paths_t;   // each path is a vector of qubits, from source to target
+    std::mutex  m;                                      // guards sets; paths are looked up by concurrent alternatives
+    std::unordered_map<size_t, std::shared_ptr<const paths_t>> sets;    // sets[key] is the path set of key
+};
+
 class Grid {
 public:
     const ql::quantum_platform* platformp;    // current platform: topology
@@ -100,7 +114,9 @@ public:
     std::map<size_t,neighbors_t> nbs;   // nbs[i] is list of neighbor qubits of qubit i
     std::map<size_t,int> x;             // x[i] is x coordinate of qubit i
     std::map<size_t,int> y;             // y[i] is y coordinate of qubit i
-    std::vector<std::vector<size_t>>  dist; // dist[i][j] is computed distance between qubits i and j;
+    std::shared_ptr<const std::vector<size_t>> dist; // (*dist)[i*nq+j] is computed distance between qubits i and j;
+                                        // those of the platform, shared by all grids on it, see ComputeDist
+    std::shared_ptr<GridPaths> paths;   // path sets found thisfar, shared by copies of this grid, see Paths
 
     // Grid initializer
     // initialize mapper internal grid maps from configuration
@@ -118,7 +134,7 @@ public:
     // formulae for convex (hole free) topologies with underlying grid and with bidirectional edges:
     //      gf_cross:   std::max( std::abs( x[to_realqi] - x[from_realqi] ), std::abs( y[to_realqi] - y[from_realqi] ))
     //      gf_plus:    std::abs( x[to_realqi] - x[from_realqi] ) + std::abs( y[to_realqi] - y[from_realqi] )
-    // when the neighbor relation is defined (topology.edges in config file), Floyd-Warshall is used, which currently is always
+    // when the neighbor relation is defined (topology.edges in config file), BFS is used, which currently is always
     size_t Distance(size_t from_realqi, size_t to_realqi) const;
 
     // coredistance between two qubits
@@ -146,7 +162,13 @@ public:
     // and this can only be computed when there is an underlying x/y grid (so not for form==gf_irregular)
     void Normalize(size_t src, neighbors_t &nbl) const;
 
-    // Floyd-Warshall dist[i][j] = shortest distances between all nq qubits i and j
+    // return the path set with the given key from the path cache;
+    // when it is not there yet, gen is called to compute it, and it is added;
+    // since the paths depend only on the topology, the key need only identify source, target and kind of paths
+    std::shared_ptr<const GridPaths::paths_t> Paths(size_t key, const std::function<void(GridPaths::paths_t &)> &gen);
+
+    // (*dist)[i*nq+j] = shortest distances between all nq qubits i and j, by a BFS from each qubit i;
+    // the result is cached by topology, so that a grid on the same topology finds it computed already
     void ComputeDist();
 
     void DPRINTGrid() const;
@@ -182,7 +204,7 @@ public:
 // - a map (v2rMap[]) for each virtual qubit that is in use to its current real qubit index.
 //      Virtual qubits are in use as soon as they have been encountered as operands in the program.
 //      When a virtual qubit is not in use, it maps to UNDEFINED_QUBIT, the undefined real index.
-//      The reverse map (GetVirt()) is implemented by a reverse look-up:
+//      The reverse map (GetVirt()) is kept next to it (r2vMap[]) and updated with it:
 //      when there is no virtual qubit that maps to a particular real qubit,
 //      the reverse map maps the real qubit index to UNDEFINED_QUBIT, the undefined virtual index.
 //      At any time, the virtual to real and reverse maps are 1-1 for qubits that are in use.
@@ -222,13 +244,13 @@ private:
 
     size_t              nq;                 // size of the map; after initialization, will always be the same
     std::vector<size_t> v2rMap;             // v2rMap[virtual qubit index] -> real qubit index | UNDEFINED_QUBIT
+    std::vector<size_t> r2vMap;             // r2vMap[real qubit index] -> virtual qubit index | UNDEFINED_QUBIT
     std::vector<realstate_t>rs;             // rs[real qubit index] -> {nostate|wasinited|hasstate}
 
 public:
 
     // map real qubit to the virtual qubit index that is mapped to it (i.e. backward map);
     // when none, return UNDEFINED_QUBIT;
-    // a second vector next to v2rMap (i.e. an r2vMap) would speed this up;
     size_t GetVirt(size_t r) const;
     realstate_t GetRs(size_t q) const;
     void SetRs(size_t q, realstate_t rsvalue);
@@ -246,9 +268,12 @@ public:
     void Init(size_t n);
 
     // map virtual qubit index to real qubit index
-    size_t &operator[](size_t v);
     const size_t &operator[](size_t v) const;
 
+    // map virtual qubit v to real qubit r (UNDEFINED_QUBIT unmaps v), updating the reverse map as well;
+    // r should not be mapped to by an other virtual qubit
+    void SetReal(size_t v, size_t r);
+
     // allocate a new real qubit for an unmapped virtual qubit v (i.e. v2rMap[v] == UNDEFINED_QUBIT);
     // note that this may consult the grid or future gates to find a best real
     // and thus should not be in Virt2Real but higher up
@@ -298,7 +323,8 @@ private:
     size_t                  nq;      // size of the map; after initialization, will always be the same
     size_t                  ct;      // multiplication factor from cycles to nano-seconds (unit of duration)
     std::vector<size_t>     fcv;     // fcv[real qubit index i]: qubit i is free from this cycle on
-    ql::arch::resource_manager_t rm;  // actual resources occupied by scheduled gates
+    std::shared_ptr<ql::arch::resource_manager_t> rmp;  // actual resources occupied by scheduled gates
+                                    // shared by copies of this FreeCycle map until one of them reserves a resource
 
 
     // access free cycle value of qubit i
@@ -358,10 +384,59 @@ public:
     // gate operands are real qubit indices
     // both the FreeCycle map and the resource map are updated
     // startcycle must be the result of an earlier StartCycle call (with rc!)
+    // when the resource map is shared with other FreeCycle maps, it is cloned first (copy-on-write)
     void Add(ql::gate *g, size_t startCycle);
 
 };
 
+// =========================================================================================
+// SharedGateList: list of gates of a Past that is shared with its copies
+//
+// While evaluating alternatives, the main Past is copied to the Past of each Alter and to the
+// Past used for lookahead in recursion; each copy then only adds a few gates to it (swaps, moves, lookahead gates).
+// To make such copies cheap, the list is kept in two parts:
+// - base: a list of gates that can be shared by several copies; it is never changed while it is shared
+// - delta: a private list of the gates that were added since the list was copied
+// The logical list is the base followed by the delta (unordered) or the base merged with the delta (ordered),
+// in which with equal cycle values the gates of the base come first since these were added earlier.
+// A copy shares the base and copies the delta; so after folding the delta into the base (see Fold),
+// copying a list costs time and memory in proportion to the gates added since, and not to the whole list.
+// Copying only reads the list that is copied, so copies of it can be made by several threads at the same time.
+class SharedGateList {
+public:
+    typedef ql::gate *      gate_p;
+
+private:
+    bool                                ordered;// gates are ordered by their cycle value, otherwise in order of adding
+    std::shared_ptr<std::list<gate_p>>  base;   // gates shared with copies of this list; may be nullptr
+    std::list<gate_p>                   delta;  // gates added since the base was last shared
+
+public:
+
+    SharedGateList();
+    SharedGateList(const SharedGateList &other);
+    SharedGateList &operator=(const SharedGateList &other);
+
+    // make the list empty and set whether it is ordered by cycle
+    void Init(bool is_ordered);
+
+    // fold the delta into the base when the base is not shared; the logical list is not changed by this
+    void Fold();
+
+    bool empty() const;
+    size_t size() const;
+
+    // add gate gp to the list;
+    // when ordered, gp is inserted in order of its cycle value, and inside this order, as late as possible
+    void Add(gate_p gp);
+
+    // append the gates of the logical list to l, in order, and make the list empty
+    void Take(std::list<gate_p> &l);
+
+    // append the gates of the logical list to l, in order
+    void Get(std::list<gate_p> &l) const;
+};
+
 // =========================================================================================
 // Past: state of the mapper while somewhere in the mapping process
 //
@@ -399,7 +474,9 @@ private:
     size_t                  ct;         // cycle time, multiplier from cycles to nano-seconds
     const ql::quantum_platform    *platformp; // platform describing resources for scheduling
     ql::quantum_kernel      *kernelp;   // current kernel for creating gates
+    std::shared_ptr<std::mutex> kernelmutexp;   // guards kernelp->c in new_gate; shared by the copies of this Past
     Grid                    *gridp;     // pointer to grid to know which hops are inter-core
+    std::string             mapusemovesopt; // value of option mapusemoves, see Mapper
 
     Virt2Real               v2r;        // state: current Virt2Real map, imported/exported to kernel
     FreeCycle               fc;         // state: FreeCycle map (including resource_manager) of this Past
@@ -407,16 +484,13 @@ private:
     std::list<gate_p>       waitinglg;  // . . .  list of q gates in this Past, topological order, waiting to be scheduled in
     //        waitinglg only contains gates from Add and final Schedule call
     //        when evaluating alternatives, it is empty when Past is cloned; so no state
-public:
-    std::list<gate_p>       lg;         // state: list of q gates in this Past, scheduled by their (start) cycle values
+    SharedGateList          lg;         // state: list of q gates in this Past, scheduled by their (start) cycle values
     //        so this is the result list of this Past, to compare with other Alters
-private:
-    std::list<gate_p>       outlg;      // . . .  list of gates flushed out of this Past, not yet put in outCirc
+    //        the gates of the Past it was copied from are shared with it
+    //        gp->cycle is the startCycle value of each gate gp in lg;
+    //        each gate is scheduled in only one Past, since waitinglg is empty when a Past is copied
+    SharedGateList          outlg;      // . . .  list of gates flushed out of this Past, not yet put in outCirc
     //        when evaluating alternatives, outlg stays constant; so no state
-    std::map<gate_p,size_t> cycle;      // state: gate to cycle map, startCycle value of each past gatecycle[gp]
-    //        cycle[gp] can be different for each gp for each past
-    //        gp->cycle is not used by MapGates
-    //        although updated by set_cycle called from MakeAvailable/TakeAvailable
     size_t                  nswapsadded;// number of swaps (including moves) added to this past
     size_t                  nmovesadded;// number of moves added to this past
 
@@ -427,7 +501,14 @@ public:
     Past();
 
     // past initializer
-    void Init(const ql::quantum_platform *p, ql::quantum_kernel *k, Grid *g);
+    // mapusemoves is the value of option mapusemoves to use when adding swaps
+    void Init(const ql::quantum_platform *p, ql::quantum_kernel *k, Grid *g, const std::string &mapusemoves);
+
+    // fold the gates scheduled and output until now into the bases of lg and outlg (see SharedGateList::Fold),
+    // so that copies of this Past made after this only copy what they add to it;
+    // copying a Past only reads it, so the copies can be made by several threads at the same time,
+    // but this Past must not be changed (neither folded) by any thread while they do
+    void Fold();
 
     // import Past's v2r from v2r_value
     void ImportV2r(const Virt2Real &v2r_value);
@@ -507,8 +588,6 @@ public:
     // if not yet mapped, allocate a new real qubit index and map to it
     size_t MapQubit(size_t v);
 
-    static void stripname(std::string &name);
-
     // MakeReal gp
     // assume gp points to a virtual gate with virtual qubit indices as operands;
     // when a gate can be created with the same name but with "_real" appended, with the real qubits as operands, then create that gate
@@ -606,7 +685,7 @@ public:
     std::vector<size_t>     fromSource; // partial path after split, starting at source
     std::vector<size_t>     fromTarget; // partial path after split, starting at target, backward
 
-    Past                    past;       // cloned main past, extended with swaps from this path
+    Past                    past;       // cloned main past (by Extend), extended with swaps from this path
     double                  score;      // e.g. latency extension caused by the path
     bool                    didscore;   // initially false, true after assignment to score
 
@@ -701,28 +780,59 @@ public:
 // Later implementations may become more sophisticated.
 //
 // With option maplookaheadopt=="no", the future window's dependence graph (scheduled and avlist) are not used.
-// Instead a copy of the input circuit (input_gatepv) is created and iterated over (input_gatepp).
+// Instead a copy of the input circuit (input_gatepv) is created and iterated over (input_gatepi).
+//
+// Each gate/node of the dependence graph gets a dense index (its node index in the Scheduler's DepGraph) in SetCircuit;
+// what doesn't change while mapping (gate of index, index of gate, remaining, criticality rank) is in a FutureIndex
+// that is shared by all copies of a Future; the state is kept in vectors indexed by it and in the ordered avlist;
+// so DoneGate and MostCriticalIn don't need to scan lists and copying a Future is cheap.
+
+// ordering of the avlist, the same as the Scheduler keeps its avlist in (see avlist_t):
+// on deep-criticality from high to low, and on the order of becoming available when equally critical
+typedef struct {
+    size_t  critrank;   // rank of the gate in deep-criticality, 0 is most critical
+    size_t  seq;        // sequence number of becoming available
+    size_t  index;      // the gate's index
+} avitem_t;
+
+struct avitem_lessthan {
+    bool operator()(const avitem_t &a, const avitem_t &b) const {
+        return a.critrank < b.critrank || (a.critrank == b.critrank && a.seq < b.seq);
+    }
+};
+
+class FutureIndex {
+public:
+    std::vector<ql::gate*>          gates;          // gates[index] == gate*, including SOURCE, SINK and GROUP
+    std::unordered_map<ql::gate*,size_t> index;     // index[gate*] == index
+    std::vector<size_t>             remaining;      // remaining[index] == schedp->remaining of its node
+    std::vector<size_t>             critrank;       // critrank[index] == rank in deep-criticality, equally critical share it
+};
 
 class Future {
 public:
     const ql::quantum_platform            *platformp;
-    Scheduler                       *schedp;        // a pointer, since dependence graph doesn't change
+    std::shared_ptr<Scheduler>      schedp;         // shared, since dependence graph doesn't change
     ql::circuit                     input_gatepv;   // input circuit when not using scheduler based avlist
 
-    std::map<ql::gate*,bool>        scheduled;      // state: has gate been scheduled, here: done from future?
-    std::list<lemon::ListDigraph::Node> avlist;         // state: which nodes/gates are available for mapping now?
-    ql::circuit::iterator           input_gatepp;   // state: alternative iterator in input_gatepv
+    std::shared_ptr<const FutureIndex> fip;         // dense indexing of the dependence graph, shared by copies
+    std::vector<bool>               scheduled;      // state: scheduled[index]: has gate been done from future?
+    std::vector<size_t>             avseq;          // state: avseq[index]: seq when it became available, max size_t if not yet
+    std::set<avitem_t,avitem_lessthan> avlist;      // state: which gates are available for mapping now, ordered?
+    size_t                          nextseq;        // state: seq to give to the next gate that becomes available
+    size_t                          input_gatepi;   // state: alternative index of next gate in input_gatepv,
+                                                    // an index instead of an iterator to keep copies of Future valid
 
     // just program wide initialization
     void Init(const ql::quantum_platform *p);
 
     // Set/switch input to the provided circuit
-    // nq and nc are parameters because nc may not be provided by platform but by kernel
-    // the latter should be updated when mapping multiple kernels
-    void SetCircuit(ql::quantum_kernel &kernel, Scheduler &sched, size_t nq, size_t nc);
+    // graph is the dependence graph of kernel.c (see Mapper::DependenceGraph), nullptr with maplookahead=no;
+    // the Futures of the mappings of copies of the circuit share it, and its remaining and criticality ranks
+    void SetCircuit(ql::quantum_kernel &kernel, std::shared_ptr<Scheduler> graph);
 
     // Get from avlist all gates that are non-quantum into nonqlg
-    // Non-quantum gates include: classical, and dummy (SOURCE/SINK)
+    // Non-quantum gates include: classical, and dummy (SOURCE/SINK/GROUP)
     // Return whether some non-quantum gate was found
     bool GetNonQuantumGates(std::list<ql::gate*> &nonqlg) const;
 
@@ -730,6 +840,9 @@ public:
     // Return whether some gate was found
     bool GetGates(std::list<ql::gate*> &qlg) const;
 
+    // Add the gate with index i to avlist, unless it was made available before
+    void MakeAvailable(size_t i);
+
     // Indicate that a gate currently in avlist has been mapped, can be taken out of the avlist
     // and its successors can be made available
     void DoneGate(ql::gate *gp);
@@ -740,6 +853,22 @@ public:
 
 };
 
+// =========================================================================================
+// BeamState: one partial routing in the beam of routings that mapper=beam maintains
+//
+// Each has its own future and past, so the routing steps taken are those committed in past
+// and the gates still to map are those available in future.
+// When past of a state is copied to create its successor states, its gate lists are shared by them,
+// so that the common prefix of routings that have developed from the same state is stored only once.
+class BeamState {
+public:
+    Future                  future;     // gates still to map in this routing
+    Past                    past;       // gates mapped in this routing, with its v2r map
+    std::list<ql::gate*>    lg;         // non-mappable 2q gates this routing faces next, as returned by MapMappableGates
+    bool                    havegates;  // false when all gates have been mapped; then lg is empty
+    size_t                  cost;       // MaxFreeCycle of past plus estimated cycles of routing the gates in lg
+};
+
 // =========================================================================================
 // Mapper: map operands of gates and insert swaps so that two-qubit gate operands are NN.
 // All gates must be unary or two-qubit gates. The operands are virtual qubit indices.
@@ -823,6 +952,19 @@ private:
 
                                     // Initialized by Mapper.Map
     std::mt19937    gen;            // Standard mersenne_twister_engine, not yet seeded
+    std::string     maptiebreakopt; // values of options maptiebreak, mappathselect and mapusemoves in use;
+    std::string     mappathselectopt;// these are read once per kernel, and members of a portfolio set their own,
+    std::string     mapusemovesopt; // see MapPortfolio
+
+    // state of a Mapper that is not copied with it, so that members of a portfolio each have their own
+    struct MapperThreads {
+        std::mutex      genmutex;   // guards gen while alternatives are evaluated in parallel
+        std::unique_ptr<ql::utils::thread_pool> pool; // evaluates alternatives in parallel, see EvaluateAlters
+        MapperThreads() {}
+        MapperThreads(const MapperThreads &) {}
+        MapperThreads &operator=(const MapperThreads &) { return *this; }
+    };
+    MapperThreads   threads;
 
 public:
                                     // Passed back by Mapper::Map to caller for reporting
@@ -834,6 +976,7 @@ public:
     std::vector<int>    rs_ip;      // rs[real qubit index] -> {nostate|wasinited|hasstate}
     std::vector<size_t> v2r_out;    // v2r[virtual qubit index] -> real qubit index | UNDEFINED_QUBIT
     std::vector<int>    rs_out;     // rs[real qubit index] -> {nostate|wasinited|hasstate}
+    std::string     portfoliowinner;// with mapportfolio, configuration of the member whose result was taken, else empty
 
 
     // Mapper constructor is default synthesized
@@ -854,8 +997,9 @@ private:
 
     // Find shortest paths between src and tgt in the grid, bounded by a particular strategy (which);
     // budget is the maximum number of hops allowed in the path from src and is at least distance to tgt;
-    // it can be higher when not all hops qualify for doing a two-qubit gate or to find more than just the shortest paths.
-    void GenShortestPaths(ql::gate *gp, size_t src, size_t tgt, size_t budget, std::list<Alter> &resla, whichpaths_t which);
+    // it can be higher when not all hops qualify for doing a two-qubit gate or to find more than just the shortest paths;
+    // each path found is appended to resps as the path thisfar (which ends just before src) followed by the path from src
+    void GenShortestPaths(size_t src, size_t tgt, size_t budget, std::vector<size_t> &path, GridPaths::paths_t &resps, whichpaths_t which);
 
     // Generate shortest paths in the grid for making gate gp NN, from qubit src to qubit tgt, with an alternative for each one
     // - compute budget; usually it is distance but it can be higher such as for multi-core
@@ -917,6 +1061,14 @@ private:
     //
     bool MapMappableGates(Future &future, Past &past, std::list<ql::gate*> &lg, bool alsoNN2q);
 
+    // apply evaluate to each alternative in la;
+    // at recursion level 0 and when option mapthreads allows more than one thread, this is done by the threads
+    // of the Mapper's pool, that each repeatedly take the next alternative that was not evaluated yet;
+    // evaluate only updates its own alternative and objects private to it, and reads shared objects,
+    // so the results do not depend on the number of threads nor on the order of evaluation;
+    // deeper levels of recursion are evaluated sequentially by the thread that evaluates the alternative at level 0
+    void EvaluateAlters(std::list<Alter> &la, int level, const std::function<void(Alter &)> &evaluate);
+
     // select Alter determined by strategy defined by mapper options
     // - if base[rc], select from whole list of Alters, of which all 'remain'
     // - if minextend[rc], select Alter from list of Alters with minimal cycle extension of given past
@@ -934,8 +1086,34 @@ private:
     // and past is the last past (top of recursion stack) relative to which the mapping is done.
     void MapGates(Future &future, Past &past, Past &basePast);
 
+    // compute s.cost from the latency of s.past and the distances between the operands of the gates in s.lg,
+    // each hop still to be made being estimated to take hopcycles cycles
+    void BeamCost(BeamState &s, size_t hopcycles);
+
+    // mapper=beam: map all gates from future into past by a beam search over partial routings;
+    // in each step, each routing in the beam is extended by each of its alternatives,
+    // and only the mapbeamwidth ones with lowest estimated cost of the resulting ones are created, duplicates removed;
+    // this continues until all routings in the beam have mapped all gates; the one with lowest cost is the result
+    void MapGatesBeam(Future &future, Past &past);
+
+    // the dependence graph of circuit ckt for Future::SetCircuit, nullptr with maplookahead=no;
+    // it isn't bound to ckt (its circp is nullptr), so that the mappings of copies of ckt can share it
+    std::shared_ptr<Scheduler> DependenceGraph(ql::circuit &ckt);
+
     // Map the circuit's gates in the provided context (v2r maps), updating circuit and v2r maps
-    void MapCircuit(ql::quantum_kernel& kernel, Virt2Real& v2r);
+    // graph is the dependence graph of kernel.c, see DependenceGraph
+    void MapCircuit(ql::quantum_kernel& kernel, Virt2Real& v2r, std::shared_ptr<Scheduler> graph);
+
+    // initialplace=sabre: compute an initial mapping in v2r
+    // by mapping the kernel's circuit alternatingly forward and backward, starting each pass from where the previous ended;
+    // graph is set to the dependence graph of kernel.c, which the passes built for their forward mappings
+    void SabrePlace(ql::quantum_kernel& kernel, Virt2Real& v2r, std::shared_ptr<Scheduler> &graph);
+
+    // mapportfolio: map the circuit as MapCircuit does, but by mapportfoliosize members in parallel, one per thread,
+    // each with its own configuration of maptiebreak/random seed, mappathselect and mapusemoves,
+    // each in its own copy of this Mapper and on its own copy of the kernel;
+    // the result of the member with lowest depth or number of swaps (see mapportfoliometric) is taken
+    void MapPortfolio(ql::quantum_kernel& kernel, Virt2Real& v2r, std::shared_ptr<Scheduler> graph);
 
 public:
 
@@ -150,32 +150,35 @@ double Metrics::bounded_fidelity(const ql::circuit &circ, std::vector<double> &f
     IOUT("\n\n");
 
     IOUT("Entered loop");
-    for (auto &gate : circ) {
+    circuit_view v(circ);
+    for (size_t i = 0; i < v.size(); i++) {
+        const std::string &name = v.gates[i]->name;
+        const size_t *operands = v.operands.data() + v.operand_begin[i];
 
         IOUT("Next gate\n");
 
-        if (gate->name == "measure") {
+        if (name == "measure") {
             continue;
-        } else if (gate->name == "prepz") {
-            size_t qubit = gate->operands[0];
+        } else if (name == "prepz") {
+            size_t qubit = operands[0];
             fids[qubit] = 1.0;
-            last_op_endtime[qubit] = gate->cycle + gate->duration / CYCLE_TIME;
+            last_op_endtime[qubit] = v.cycle[i] + v.duration[i] / CYCLE_TIME;
             continue;
         }
 
-        if (gate->duration > CYCLE_TIME*2 && gate->name != "prep_z" && gate->name != "measure") {
-            EOUT("Gate with duration larger than CYCLE_TIME*20 detected! Non primitive?: " << gate->name );
-            throw ql::exception("Check for non primitive gates at cycle "  + std::to_string(gate->cycle) + "!", false);
+        if (v.duration[i] > CYCLE_TIME*2 && name != "prep_z" && name != "measure") {
+            EOUT("Gate with duration larger than CYCLE_TIME*20 detected! Non primitive?: " << name );
+            throw ql::exception("Check for non primitive gates at cycle "  + std::to_string(v.cycle[i]) + "!", false);
         }
 
-        unsigned char type_op = gate->operands.size(); // type of operation (1-qubit/2-qubit)
+        unsigned char type_op = v.operand_count(i); // type of operation (1-qubit/2-qubit)
         if (type_op == 1) {
-            size_t qubit = gate->operands[0];
+            size_t qubit = operands[0];
             size_t last_time = last_op_endtime[qubit];
-            IOUT("Gate " + gate->name + "("+ std::to_string(gate->operands[0]) +") at cycle " + std::to_string(gate->cycle) + " with duration " + std::to_string(gate->duration));
-            size_t idled_time = gate->cycle - last_time; //get idlying time to introduce decoherence. This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
+            IOUT("Gate " + name + "("+ std::to_string(operands[0]) +") at cycle " + std::to_string(v.cycle[i]) + " with duration " + std::to_string(v.duration[i]));
+            size_t idled_time = v.cycle[i] - last_time; //get idlying time to introduce decoherence. This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
 
-            last_op_endtime[qubit] = gate->cycle  + gate->duration / CYCLE_TIME; //This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
+            last_op_endtime[qubit] = v.cycle[i]  + v.duration[i] / CYCLE_TIME; //This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
 
             IOUT("Idled time:" + std::to_string(idled_time));
 
@@ -187,19 +190,19 @@ double Metrics::bounded_fidelity(const ql::circuit &circ, std::vector<double> &f
 
         } else if (type_op == 2) {
             IOUT("METRICS - TWO qubit gate");
-            size_t qubit_c = gate->operands[0];
-            size_t qubit_t = gate->operands[1];
+            size_t qubit_c = operands[0];
+            size_t qubit_t = operands[1];
 
             size_t last_time_c = last_op_endtime[qubit_c];
             size_t last_time_t = last_op_endtime[qubit_t];
-            size_t idled_time_c = gate->cycle - last_time_c;
-            size_t idled_time_t = gate->cycle - last_time_t; //get idlying time to introduce decoherence. This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
-            last_op_endtime[qubit_c] = gate->cycle  + gate->duration / CYCLE_TIME; //This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
-            last_op_endtime[qubit_t] = gate->cycle  + gate->duration / CYCLE_TIME ; //This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
+            size_t idled_time_c = v.cycle[i] - last_time_c;
+            size_t idled_time_t = v.cycle[i] - last_time_t; //get idlying time to introduce decoherence. This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
+            last_op_endtime[qubit_c] = v.cycle[i]  + v.duration[i] / CYCLE_TIME; //This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
+            last_op_endtime[qubit_t] = v.cycle[i]  + v.duration[i] / CYCLE_TIME ; //This assumes "cycle" starts at zero, otherwise gate->cycle-> (gate->cycle - 1)
 
-            IOUT("Gate " + gate->name + "("+ std::to_string(gate->operands[0]) + ", " + std::to_string(gate->operands[1]) +") at cycle " + std::to_string(gate->cycle) + " with duration " + std::to_string(gate->duration));
+            IOUT("Gate " + name + "("+ std::to_string(operands[0]) + ", " + std::to_string(operands[1]) +") at cycle " + std::to_string(v.cycle[i]) + " with duration " + std::to_string(v.duration[i]));
             IOUT("Idled time q_c:" + std::to_string(idled_time_c));
-            IOUT("Idled time q_t:" + std::to_string(idled_time_t) + " gate cycle=" + std::to_string(gate->cycle) + ". last_time_t=" + std::to_string(last_time_t));
+            IOUT("Idled time q_t:" + std::to_string(idled_time_t) + " gate cycle=" + std::to_string(v.cycle[i]) + ". last_time_t=" + std::to_string(last_time_t));
 
             fids[qubit_c] *= std::exp(-(double) idled_time_c/decoherence_time); // Update fidelity with idling-caused decoherence
             fids[qubit_t] *= std::exp(-(double)idled_time_t/decoherence_time); // Update fidelity with idling-caused decoherence
@@ -218,7 +221,7 @@ double Metrics::bounded_fidelity(const ql::circuit &circ, std::vector<double> &f
         IOUT("\n NEXT GATE");
 
     }
-    size_t end_cycle = circ.back()->cycle + circ.back()->duration/CYCLE_TIME;
+    size_t end_cycle = v.cycle.back() + v.duration.back()/CYCLE_TIME;
     for (size_t i = 0; i < Nqubits; i++) {
         size_t idled_time_final = end_cycle - last_op_endtime[i];
         fids[i] *= std::exp(-(double) idled_time_final/decoherence_time);
@@ -198,9 +198,9 @@ void rotation_optimize(
 ) {
     if (ql::options::get("optimize") == "yes") {
         IOUT("optimizing quantum kernels...");
-        for (size_t k=0; k<programp->kernels.size(); ++k) {
-            rotation_optimize_kernel(programp->kernels[k], platform);
-        }
+        for_each_kernel(programp, [&platform](ql::quantum_kernel &kernel) {
+            rotation_optimize_kernel(kernel, platform);
+        });
     }
 }
 
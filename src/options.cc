@@ -28,12 +28,17 @@ private:
         opt_name2opt_val["scheduler"] = "ALAP";
         opt_name2opt_val["scheduler_uniform"] = "no";
         opt_name2opt_val["scheduler_commute"] = "no";
+        opt_name2opt_val["scheduler_resources"] = "state";
+        opt_name2opt_val["scheduler_resources_window"] = "1024";
+        opt_name2opt_val["kernelthreads"] = "1";
         opt_name2opt_val["prescheduler"] = "yes";
         opt_name2opt_val["scheduler_post179"] = "yes";
         opt_name2opt_val["backend_cc_map_input_file"] = "";
 
         opt_name2opt_val["cz_mode"] = "manual";
         opt_name2opt_val["print_dot_graphs"] = "no";
+        opt_name2opt_val["print_dot_kernels"] = "all";
+        opt_name2opt_val["print_dot_maxnodes"] = "100000";
 
         opt_name2opt_val["clifford_prescheduler"] = "no";
         opt_name2opt_val["clifford_postscheduler"] = "no";
@@ -55,6 +60,11 @@ private:
         opt_name2opt_val["maptiebreak"] = "random";
         opt_name2opt_val["mapusemoves"] = "yes";
         opt_name2opt_val["mapreverseswap"] = "yes";
+        opt_name2opt_val["mapthreads"] = "1";
+        opt_name2opt_val["mapbeamwidth"] = "4";
+        opt_name2opt_val["mapportfolio"] = "no";
+        opt_name2opt_val["mapportfoliosize"] = "4";
+        opt_name2opt_val["mapportfoliometric"] = "depth";
 
         // add options with default values and list of possible values
         app->add_set_ignore_case("--log_level", opt_name2opt_val["log_level"],
@@ -64,9 +74,14 @@ private:
         app->add_set_ignore_case("--prescheduler", opt_name2opt_val["prescheduler"], {"no", "yes"}, "Run qasm (first) scheduler?", true);
         app->add_set_ignore_case("--scheduler_post179", opt_name2opt_val["scheduler_post179"], {"no", "yes"}, "Issue 179 solution included", true);
         app->add_set_ignore_case("--print_dot_graphs", opt_name2opt_val["print_dot_graphs"], {"no", "yes"}, "Print (un-)scheduled graphs in DOT format", true);
+        app->add_option("--print_dot_kernels", opt_name2opt_val["print_dot_kernels"], "Names of the kernels, separated by commas, of which to print graphs, or all", true);
+        app->add_set_ignore_case("--print_dot_maxnodes", opt_name2opt_val["print_dot_maxnodes"], {"100","1000","10000","100000","1000000","inf"}, "Print no graphs of kernels with more nodes than this", true);
         app->add_set_ignore_case("--scheduler", opt_name2opt_val["scheduler"], {"ASAP", "ALAP"}, "scheduler type", true);
         app->add_set_ignore_case("--scheduler_uniform", opt_name2opt_val["scheduler_uniform"], {"yes", "no"}, "Do uniform scheduling or not", true);
         app->add_set_ignore_case("--scheduler_commute", opt_name2opt_val["scheduler_commute"], {"yes", "no"}, "Commute gates when possible, or not", true);
+        app->add_set_ignore_case("--scheduler_resources", opt_name2opt_val["scheduler_resources"], {"state", "timeline"}, "Resources keep just their latest state, or timelines of reservations allowing backfilling", true);
+        app->add_set_ignore_case("--scheduler_resources_window", opt_name2opt_val["scheduler_resources_window"], {"256","512","1024","2048","4096","16384","65536","inf"}, "Number of cycles before the latest reservation that timeline resources keep", true);
+        app->add_set_ignore_case("--kernelthreads", opt_name2opt_val["kernelthreads"], {"1","2","3","4","5","6","7","8","12","16","24","32","64","max"}, "Number of threads doing the kernels in parallel in per-kernel passes such as the schedulers", true);
         app->add_set_ignore_case("--use_default_gates", opt_name2opt_val["use_default_gates"], {"yes", "no"}, "Use default gates or not", true);
         app->add_set_ignore_case("--optimize", opt_name2opt_val["optimize"], {"yes", "no"}, "optimize or not", true);
         app->add_set_ignore_case("--clifford_prescheduler", opt_name2opt_val["clifford_prescheduler"], {"yes", "no"}, "clifford optimize before prescheduler yes or not", true);
@@ -79,11 +94,11 @@ private:
         app->add_option("--backend_cc_map_input_file", opt_name2opt_val["backend_cc_map_input_file"], "Name of CC input map file", true);
         app->add_set_ignore_case("--cz_mode", opt_name2opt_val["cz_mode"], {"manual", "auto"}, "CZ mode", true);
 
-        app->add_set_ignore_case("--mapper", opt_name2opt_val["mapper"], {"no", "base", "baserc", "minextend", "minextendrc", "maxfidelity"}, "Mapper heuristic", true);
+        app->add_set_ignore_case("--mapper", opt_name2opt_val["mapper"], {"no", "base", "baserc", "minextend", "minextendrc", "maxfidelity", "beam"}, "Mapper heuristic", true);
         app->add_set_ignore_case("--mapinitone2one", opt_name2opt_val["mapinitone2one"], {"no", "yes"}, "Initialize mapping of virtual qubits one to one to real qubits", true);
         app->add_set_ignore_case("--mapprepinitsstate", opt_name2opt_val["mapprepinitsstate"], {"no", "yes"}, "Prep gate leaves qubit in zero state", true);
         app->add_set_ignore_case("--mapassumezeroinitstate", opt_name2opt_val["mapassumezeroinitstate"], {"no", "yes"}, "Assume that qubits are initialized to zero state", true);
-        app->add_set_ignore_case("--initialplace", opt_name2opt_val["initialplace"], {"no","yes","1s","10s","1m","10m","1h","1sx","10sx","1mx","10mx","1hx"}, "Initialplace qubits before mapping", true);
+        app->add_set_ignore_case("--initialplace", opt_name2opt_val["initialplace"], {"no","yes","sabre","1s","10s","1m","10m","1h","1sx","10sx","1mx","10mx","1hx"}, "Initialplace qubits before mapping", true);
         app->add_set_ignore_case("--initialplace2qhorizon", opt_name2opt_val["initialplace2qhorizon"], {"0","1","2","3","4","5","6","7","8","9", "10","11","12","13","14","15","16","17","18","19","20","30","40","50","60","70","80","90","100"}, "Initialplace considers only this number of initial two-qubit gates", true);
         app->add_set_ignore_case("--maplookahead", opt_name2opt_val["maplookahead"], {"no", "1qfirst", "noroutingfirst", "all"}, "Strategy wrt selecting next gate(s) to map", true);
         app->add_set_ignore_case("--mappathselect", opt_name2opt_val["mappathselect"], {"all", "borders"}, "Which paths: all or borders", true);
@@ -94,6 +109,11 @@ private:
         app->add_set_ignore_case("--maptiebreak", opt_name2opt_val["maptiebreak"], {"first", "last", "random", "critical"}, "Tie break method", true);
         app->add_set_ignore_case("--mapusemoves", opt_name2opt_val["mapusemoves"], {"no", "yes", "0","1","2","3","4","5","6","7","8","9","10","11","12","13","14","15","16","17","18","19","20"}, "Use unused qubit to move thru", true);
         app->add_set_ignore_case("--mapreverseswap", opt_name2opt_val["mapreverseswap"], {"no", "yes"}, "Reverse swap operands when better", true);
+        app->add_set_ignore_case("--mapthreads", opt_name2opt_val["mapthreads"], {"1","2","3","4","5","6","7","8","12","16","24","32","64","max"}, "Number of threads evaluating routing alternatives", true);
+        app->add_set_ignore_case("--mapbeamwidth", opt_name2opt_val["mapbeamwidth"], {"1","2","3","4","6","8","12","16","24","32","64"}, "Number of routings kept by mapper=beam", true);
+        app->add_set_ignore_case("--mapportfolio", opt_name2opt_val["mapportfolio"], {"no", "seeds", "configs", "all"}, "Map each kernel by a portfolio of mapper configurations in parallel and take the best", true);
+        app->add_set_ignore_case("--mapportfoliosize", opt_name2opt_val["mapportfoliosize"], {"1","2","3","4","5","6","7","8","12","16","24","32"}, "Maximum number of members (and threads) of the mapper portfolio", true);
+        app->add_set_ignore_case("--mapportfoliometric", opt_name2opt_val["mapportfoliometric"], {"depth", "swaps"}, "Which result of the mapper portfolio is taken: lowest depth or lowest number of swaps", true);
 
         app->add_set_ignore_case("--write_qasm_files", opt_name2opt_val["write_qasm_files"], {"yes", "no"}, "write (un-)scheduled (with and without resource-constraint) qasm files", true);
         app->add_set_ignore_case("--write_report_files", opt_name2opt_val["write_report_files"], {"yes", "no"}, "write report files on circuit characteristics and pass results", true);
@@ -129,14 +149,24 @@ public:
                   << "maptiebreak: "      << opt_name2opt_val["maptiebreak"] << std::endl
                   << "mapusemoves: "      << opt_name2opt_val["mapusemoves"] << std::endl
                   << "mapreverseswap: "   << opt_name2opt_val["mapreverseswap"] << std::endl
+                  << "mapthreads: "       << opt_name2opt_val["mapthreads"] << std::endl
+                  << "mapbeamwidth: "     << opt_name2opt_val["mapbeamwidth"] << std::endl
+                  << "mapportfolio: "     << opt_name2opt_val["mapportfolio"] << std::endl
+                  << "mapportfoliosize: " << opt_name2opt_val["mapportfoliosize"] << std::endl
+                  << "mapportfoliometric: "<< opt_name2opt_val["mapportfoliometric"] << std::endl
                   << "mapselectswaps: "   << opt_name2opt_val["mapselectswaps"] << std::endl
                   << "clifford_postmapper: " << opt_name2opt_val["clifford_postmapper"] << std::endl
                   << "scheduler_post179: " << opt_name2opt_val["scheduler_post179"] << std::endl
                   << "scheduler_commute: " << opt_name2opt_val["scheduler_commute"] << std::endl
+                  << "scheduler_resources: " << opt_name2opt_val["scheduler_resources"] << std::endl
+                  << "scheduler_resources_window: " << opt_name2opt_val["scheduler_resources_window"] << std::endl
+                  << "kernelthreads: " << opt_name2opt_val["kernelthreads"] << std::endl
                   << "cz_mode: " << opt_name2opt_val["cz_mode"] << std::endl
                   << "write_qasm_files: " << opt_name2opt_val["write_qasm_files"] << std::endl
                   << "write_report_files: " << opt_name2opt_val["write_report_files"] << std::endl
-                  << "print_dot_graphs: " << opt_name2opt_val["print_dot_graphs"] << std::endl;
+                  << "print_dot_graphs: " << opt_name2opt_val["print_dot_graphs"] << std::endl
+                  << "print_dot_kernels: " << opt_name2opt_val["print_dot_kernels"] << std::endl
+                  << "print_dot_maxnodes: " << opt_name2opt_val["print_dot_maxnodes"] << std::endl;
         // FIXME: incomplete, function seems unused
     }
 
@@ -163,8 +193,9 @@ public:
 
     std::string get(const std::string &opt_name) {
         std::string opt_value("UNKNOWN");
-        if (opt_name2opt_val.find(opt_name) != opt_name2opt_val.end()) {
-            opt_value = opt_name2opt_val[opt_name];
+        auto it = opt_name2opt_val.find(opt_name);
+        if (it != opt_name2opt_val.end()) {
+            opt_value = it->second;     // doesn't modify the map, so get can be called by concurrent threads
         } else {
             EOUT("Un-known option:" << opt_name);
         }
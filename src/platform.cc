@@ -13,8 +13,140 @@
 
 namespace ql {
 
+int instruction_table::find(const std::string &name) const {
+    auto it = opcodes.find(name);
+    return (it == opcodes.end() ? -1 : it->second);
+}
+
+size_t instruction_table::size() const {
+    return instructions.size();
+}
+
+const instruction_table::instruction &instruction_table::operator[](int opcode) const {
+    return instructions[opcode];
+}
+
+const instruction_table::instruction *instruction_table::get(const gate *g) const {
+    int opcode = g->opcode;
+    if (opcode < 0 || size_t(opcode) >= instructions.size()) {
+        opcode = find(g->name);     // not created by a kernel of the platform
+        if (opcode < 0) {
+            return nullptr;
+        }
+    }
+    return &instructions[opcode];
+}
+
+const std::string &instruction_table::base_name(const gate *g, std::string &buf) const {
+    const instruction *ip = get(g);
+    if (ip != nullptr) {
+        return instructions[ip->base].name;
+    }
+    size_t p = g->name.find(' ');
+    if (p == std::string::npos) {
+        return g->name;
+    }
+    buf = g->name.substr(0, p);
+    return buf;
+}
+
+// intern name when not yet in the table, returning its opcode
+int instruction_table::add(const std::string &name) {
+    auto it = opcodes.find(name);
+    if (it != opcodes.end()) {
+        return it->second;
+    }
+    int opcode = int(instructions.size());
+    instruction ins;
+    ins.name = name;
+    ins.base = opcode;
+    ins.prototype = nullptr;
+    ins.has_settings = false;
+    ins.has_type = false;
+    ins.has_latency = false;
+    ins.latency = 0.0;
+    ins.nparams = -1;
+    instructions.push_back(ins);
+    opcodes[name] = opcode;
+    return opcode;
+}
+
+int instruction_table::find_specialized(int base, const std::vector<size_t> &qubits) const {
+    if (qubits.empty()) {
+        return -1;
+    }
+    auto range = specialized.equal_range(specialized_hash(base, qubits));
+    for (auto it = range.first; it != range.second; ++it) {
+        const instruction &ins = instructions[it->second];
+        if (ins.base == base && ins.qubits == qubits) {
+            return it->second;
+        }
+    }
+    return -1;
+}
+
+int instruction_table::find_parameterized(int base, size_t nparams) const {
+    auto it = parameterized.find(uint64_t(base) << 32 | nparams);
+    return (it == parameterized.end() ? -1 : it->second);
+}
+
+size_t instruction_table::specialized_hash(int base, const std::vector<size_t> &qubits) {
+    size_t h = size_t(base);
+    for (auto q : qubits) {
+        h = h * 1000003 + q;
+    }
+    return h;
+}
+
+// the operands of each name of the instruction map that has them, as in "cz q0,q3" or "cz %0,%1", are parsed;
+// when they are exactly in the form that quantum_kernel constructs to look up a gate, the instruction is indexed
+void instruction_table::index(int opcode) {
+    instruction &ins = instructions[opcode];
+    size_t p = ins.name.find(' ');
+    if (ins.prototype == nullptr || p == std::string::npos) {
+        return;
+    }
+
+    std::vector<size_t> operands;
+    char kind = 0;
+    size_t start = p + 1;
+    while (true) {
+        size_t end = ins.name.find(',', start);
+        std::string op = ins.name.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (op.size() < 2 || (op[0] != 'q' && op[0] != '%') || (kind != 0 && op[0] != kind)) {
+            return;
+        }
+        kind = op[0];
+        std::string digits = op.substr(1);
+        if (digits.find_first_not_of("0123456789") != std::string::npos || digits.size() > 9) {
+            return;
+        }
+        size_t v = std::stoul(digits);
+        if (std::to_string(v) != digits || (kind == '%' && v != operands.size())) {
+            return;
+        }
+        operands.push_back(v);
+        if (end == std::string::npos) {
+            break;
+        }
+        start = end + 1;
+    }
+
+    if (kind == 'q') {
+        ins.qubits = operands;
+        specialized.insert(std::make_pair(specialized_hash(ins.base, operands), opcode));
+    } else {
+        ins.nparams = int(operands.size());
+        parameterized[uint64_t(ins.base) << 32 | operands.size()] = opcode;
+    }
+}
+
 // FIXME: constructed object is not usable
-quantum_platform::quantum_platform() : name("default") {
+quantum_platform::quantum_platform() :
+    name("default"),
+    instructions(std::make_shared<instruction_table>()),
+    distances(std::make_shared<topology_distances>())
+{
 }
 
 quantum_platform::quantum_platform(
@@ -22,7 +154,8 @@ quantum_platform::quantum_platform(
     const std::string &configuration_file_name
 ) :
     name(name),
-    configuration_file_name(configuration_file_name)
+    configuration_file_name(configuration_file_name),
+    distances(std::make_shared<topology_distances>())
 {
     ql::hardware_configuration hwc(configuration_file_name);
     hwc.load(instruction_map, instruction_settings, hardware_settings, resources, topology, aliases);
@@ -42,6 +175,43 @@ quantum_platform::quantum_platform(
     } else {
         cycle_time = hardware_settings["cycle_time"];
     }
+
+    // intern the instructions; the gates in the instruction map carry their opcode to the gates copied from them
+    auto table = std::make_shared<instruction_table>();
+    for (auto &i : instruction_map) {
+        int opcode = table->add(i.first);
+        table->instructions[opcode].prototype = i.second;
+        i.second->opcode = opcode;
+    }
+    for (json::const_iterator it = instruction_settings.begin(); it != instruction_settings.end(); ++it) {
+        table->add(it.key());
+    }
+    for (size_t opcode = 0; opcode < table->instructions.size(); opcode++) {   // also visits the added base names
+        std::string iname = table->instructions[opcode].name;
+        size_t p = iname.find(' ');
+        if (p != std::string::npos) {
+            int base = table->add(iname.substr(0, p));
+            table->instructions[opcode].base = base;
+            table->index(opcode);
+        }
+
+        auto sit = instruction_settings.find(iname);
+        if (sit != instruction_settings.end()) {
+            instruction_table::instruction &ins = table->instructions[opcode];
+            ins.has_settings = true;
+            ins.settings = *sit;
+            if (ins.settings.count("type") > 0 && ins.settings["type"].is_string()) {
+                ins.has_type = true;
+                ins.type = ins.settings["type"].get<std::string>();
+            }
+            if (ins.settings.count("latency") > 0 && ins.settings["latency"].is_number()) {
+                ins.has_latency = true;
+                ins.latency = ins.settings["latency"];
+            }
+        }
+    }
+    DOUT("interned " << table->size() << " instruction names");
+    instructions = table;
 }
 
 /**
@@ -7,14 +7,93 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include "json.h"
 #include "hardware_configuration.h"
 
 namespace ql {
 
+/**
+ * the instructions of a platform, interned once when its configuration file is loaded;
+ * each name in the instruction map, each key of the instruction settings
+ * and each of those names stripped of its operands (e.g. "cz" of "cz q0,q3")
+ * is given a small integer opcode that indexes the table
+ *
+ * a gate created by a kernel of the platform carries the opcode of its name (see gate::opcode and gate_arena),
+ * so that passes find the attributes of its instruction by indexing instead of by looking up its name;
+ * gates without an opcode, e.g. with a name unknown to the platform, are looked up by name
+ *
+ * the specialized (e.g. "cz q0,q3") and parameterized (e.g. "cz %0,%1") instructions of the instruction map
+ * are also indexed by the opcode of their name without operands and by their operands,
+ * so that a kernel finds the definition of a new gate without constructing these names
+ */
+class instruction_table {
+public:
+    struct instruction {
+        std::string         name;           // e.g. "cz q0,q3", "cz" or "cz %0,%1"
+        int                 base;           // opcode of name without its operands, e.g. of "cz" for "cz q0,q3"
+        const custom_gate  *prototype;      // the gate in the instruction map with this name, nullptr if none
+        bool                has_settings;   // whether name is a key of the instruction settings
+        json                settings;       // those settings, null if none
+        bool                has_type;       // whether the settings have a string "type"
+        std::string         type;           // that "type", e.g. "mw", "flux" or "readout"
+        bool                has_latency;    // whether the settings have a numeric "latency"
+        float               latency;        // that "latency" in ns
+        std::vector<size_t> qubits;         // the qubits of a specialized name, e.g. {0,3} for "cz q0,q3", else empty
+        int                 nparams;        // the number of parameters of a parameterized name, e.g. 2 for "cz %0,%1", else -1
+    };
+
+    // opcode of the instruction with the given name, -1 if not in the table
+    int find(const std::string &name) const;
+
+    size_t size() const;
+    const instruction &operator[](int opcode) const;
+
+    // the instruction of the gate's name, nullptr if not in the table
+    const instruction *get(const gate *g) const;
+
+    // name of the gate without its operands, e.g. "cz" for "cz q0,q3";
+    // buf holds it when the gate has no opcode and its name has operands
+    const std::string &base_name(const gate *g, std::string &buf) const;
+
+    // opcode of the specialized instruction in the instruction map with the name of opcode base and the given qubits,
+    // e.g. of "cz q0,q3" for base "cz" and qubits {0,3}; -1 if none
+    int find_specialized(int base, const std::vector<size_t> &qubits) const;
+
+    // opcode of the parameterized instruction in the instruction map with the name of opcode base and nparams parameters,
+    // e.g. of "cz %0,%1" for base "cz" and nparams 2; -1 if none
+    int find_parameterized(int base, size_t nparams) const;
+
+private:
+    friend class quantum_platform;
+    int add(const std::string &name);
+    void index(int opcode);
+    static size_t specialized_hash(int base, const std::vector<size_t> &qubits);
+
+    std::vector<instruction>                instructions;   // instructions[opcode]
+    std::unordered_map<std::string, int>    opcodes;        // opcodes[name] == opcode
+    std::unordered_multimap<size_t, int>    specialized;    // specialized[specialized_hash(base, qubits)] includes opcode
+    std::unordered_map<uint64_t, int>       parameterized;  // parameterized[base << 32 | nparams] == opcode
+};
+
+/**
+ * the shortest distances between the qubits of a platform over the edges of its topology;
+ * they are computed once per platform, by the first mapper that needs them (see Grid::ComputeDist),
+ * and are then shared by the copies of the platform and by the mappers of the later kernels and programs on it
+ */
+class topology_distances {
+public:
+    std::once_flag          computed;   // guards the computation of dist
+    std::vector<size_t>     dist;       // dist[i*qubit_number+j] is the distance between qubits i and j
+};
+
 class quantum_platform {
 public:
     std::string             name;                     // platform name
@@ -29,6 +108,8 @@ public:
     json                    resources;
     json                    topology;
     json                    aliases;                  // workaround the generic instruction composition
+    std::shared_ptr<const instruction_table> instructions;  // the interned instructions, shared by copies of the platform
+    std::shared_ptr<topology_distances> distances;  // computed when first needed, shared by copies of the platform
 
     // FIXME: constructed object is not usable
     quantum_platform();
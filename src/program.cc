@@ -8,8 +8,13 @@
 
 #include "program.h"
 
+#include <mutex>
+#include <exception>
+#include <unordered_set>
+
 #include "compiler.h"
 #include "utils.h"
+#include "thread_pool.h"
 #include "options.h"
 #include "interactionMatrix.h"
 #include "scheduler.h"
@@ -464,4 +469,66 @@ const std::vector<quantum_kernel> &quantum_program::get_kernels() const {
     return kernels;
 }
 
+// kernels can only be done in parallel when they don't share gates, since passes update the gates;
+// a kernel that was added to the program twice (e.g. as a copy under another name) shares all its gates
+static bool kernels_share_gates(const quantum_program *programp) {
+    std::unordered_set<const gate *> seen;
+    for (auto &k : programp->kernels) {
+        for (auto gp : k.c) {
+            if (!seen.insert(gp).second) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void for_each_kernel(quantum_program *programp, const std::function<void(quantum_kernel &)> &f) {
+    auto &kernels = programp->kernels;
+    size_t nthreads = utils::thread_pool::threads_option(ql::options::get("kernelthreads"));
+    nthreads = std::min(nthreads, kernels.size());
+    if (nthreads > 1 && kernels_share_gates(programp)) {
+        DOUT("for_each_kernel: kernels share gates, so these are done sequentially");
+        nthreads = 1;
+    }
+    if (nthreads <= 1) {
+        for (auto &k : kernels) {
+            f(k);
+        }
+        return;
+    }
+
+    // each kernel's log output is buffered in logs[i];
+    // these are written and released as soon as the kernels before it have been written
+    size_t nk = kernels.size();
+    std::vector<utils::logger::log_buffer> logs(nk);
+    std::vector<bool> done(nk, false);
+    size_t next_written = 0;
+    std::mutex written_mutex;
+    DOUT("for_each_kernel: doing " << nk << " kernels by " << nthreads << " threads");
+    utils::thread_pool pool(nthreads);
+    pool.run(nk, [&](size_t i) {
+        utils::logger::redirect(&logs[i].out(), &logs[i].err());
+        std::exception_ptr e;
+        try {
+            f(kernels[i]);
+        } catch (...) {
+            e = std::current_exception();
+        }
+        utils::logger::redirect(nullptr, nullptr);
+
+        {
+            std::lock_guard<std::mutex> lock(written_mutex);
+            done[i] = true;
+            while (next_written < nk && done[next_written]) {
+                logs[next_written].replay();
+                next_written++;
+            }
+        }
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    });
+}
+
 } // namespace ql
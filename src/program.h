@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "platform.h"
 #include "kernel.h"
 
@@ -64,4 +66,14 @@ public:
 
 };
 
+/**
+ * apply f to each kernel of the program, as a per-kernel pass does;
+ * when option kernelthreads allows more than one thread, this is done by a pool of threads
+ * that each repeatedly take the next kernel that was not done yet;
+ * the log output of each kernel is then buffered, keeping the order of its lines to std::cout and std::cerr,
+ * and written in kernel order; and when f throws for some kernels, the exception of the first of these
+ * is rethrown after all were done; so the result is the same as when done sequentially
+ */
+void for_each_kernel(quantum_program *programp, const std::function<void(quantum_kernel &)> &f);
+
 } // namespace ql
@@ -45,13 +45,13 @@ namespace ql {
  * support functions for reporting statistics
  */
 static size_t get_classical_operations_count(
-    const circuit &c,
+    const circuit_view &v,
     const quantum_platform &platform
 ) {
     size_t classical_operations = 0;
     // DOUT("... reporting get_classical_operations_count");
-    for (auto &gp : c) {
-        switch (gp->type()) {
+    for (size_t i = 0; i < v.size(); i++) {
+        switch (v.type[i]) {
             case __classical_gate__:
                 classical_operations++;
                 break;
@@ -66,19 +66,19 @@ static size_t get_classical_operations_count(
 }
 
 static size_t get_non_single_qubit_quantum_gates_count(
-    const circuit &c,
+    const circuit_view &v,
     const quantum_platform &platform
 ) {
     size_t quantum_gates = 0;
     // DOUT("... reporting get_non_single_qubit_quantum_gates_count");
-    for (auto &gp : c) {
-        switch (gp->type()) {
+    for (size_t i = 0; i < v.size(); i++) {
+        switch (v.type[i]) {
             case __classical_gate__:
                 break;
             case __wait_gate__:
                 break;
             default:    // quantum gate
-                if (gp->operands.size() > 1) {
+                if (v.operand_count(i) > 1) {
                     quantum_gates++;
                 }
                 break;
@@ -89,19 +89,19 @@ static size_t get_non_single_qubit_quantum_gates_count(
 }
 
 static void get_qubit_usecount(
-    const circuit &c,
+    const circuit_view &v,
     const quantum_platform &platform,
     std::vector<size_t> &usecount
 ) {
     // DOUT("... reporting get_qubit_usecount");
-    for (auto &gp : c) {
-        switch (gp->type()) {
+    for (size_t i = 0; i < v.size(); i++) {
+        switch (v.type[i]) {
             case __classical_gate__:
             case __wait_gate__:
                 break;
             default:    // quantum gate
-                for (auto v : gp->operands) {
-                    usecount[v]++;
+                for (size_t o = v.operand_begin[i]; o < v.operand_begin[i+1]; o++) {
+                    usecount[v.operands[o]]++;
                 }
                 break;
         }
@@ -110,22 +110,22 @@ static void get_qubit_usecount(
 }
 
 static void get_qubit_usedcyclecount(
-    const circuit &c,
+    const circuit_view &v,
     const quantum_platform &platform,
     std::vector<size_t> &usedcyclecount
 ) {
     size_t  cycle_time = platform.cycle_time;
 
     // DOUT("... reporting get_qubit_usedcyclecount");
-    for (auto &gp : c) {
-        switch (gp->type()) {
+    for (size_t i = 0; i < v.size(); i++) {
+        switch (v.type[i]) {
             case __classical_gate__:
                 break;
             case __wait_gate__:
                 break;
             default:    // quantum gate
-                for (auto v : gp->operands) {
-                    usedcyclecount[v] += (gp->duration+cycle_time-1)/cycle_time;
+                for (size_t o = v.operand_begin[i]; o < v.operand_begin[i+1]; o++) {
+                    usedcyclecount[v.operands[o]] += (v.duration[i]+cycle_time-1)/cycle_time;
                 }
                 break;
         }
@@ -134,13 +134,13 @@ static void get_qubit_usedcyclecount(
 }
 
 static size_t get_quantum_gates_count(
-    const circuit &c,
+    const circuit_view &v,
     const quantum_platform &platform
 ) {
     size_t quantum_gates = 0;
     // DOUT("... reporting get_quantum_gates_count");
-    for (auto &gp : c) {
-        switch (gp->type()) {
+    for (size_t i = 0; i < v.size(); i++) {
+        switch (v.type[i]) {
             case __classical_gate__:
                 break;
             case __wait_gate__:
@@ -155,20 +155,20 @@ static size_t get_quantum_gates_count(
 }
 
 static size_t get_circuit_latency(
-    const circuit &c,
+    const circuit_view &v,
     const quantum_platform &platform
 ) {
     size_t cycle_time = platform.cycle_time;
     size_t circuit_latency_result;
     // DOUT("... reporting get_circuit_latency");
-    if (c.size() < 1) {
+    if (v.size() < 1) {
         circuit_latency_result = 0;
         // DOUT("In get_circuit_latency() result is 0 because circuit is empty");
-    } else if (c.back()->cycle == MAX_CYCLE) {
+    } else if (v.cycle.back() == MAX_CYCLE) {
         circuit_latency_result = 0;
         // DOUT("In get_circuit_latency() result is 0 because c.back()->cycle == MAX_CYCLE");
     } else {
-        circuit_latency_result = c.back()->cycle + (c.back()->duration+cycle_time-1)/cycle_time - c.front()->cycle;
+        circuit_latency_result = v.cycle.back() + (v.duration.back()+cycle_time-1)/cycle_time - v.cycle.front();
     }
     // DOUT("Computed get_circuit_latency(): result is " << circuit_latency_result);
     return circuit_latency_result;
@@ -345,21 +345,22 @@ void report_kernel_statistics(
     }
 
     // DOUT("... reporting report_kernel_statistics");
+    circuit_view cv(k.c);
     std::vector<size_t> usecount;
     usecount.resize(platform.qubit_number, 0);
-    get_qubit_usecount(k.c, platform, usecount);
+    get_qubit_usecount(cv, platform, usecount);
     size_t qubits_used = 0; for (auto v: usecount) { if (v != 0) { qubits_used++; } }
 
     std::vector<size_t> usedcyclecount;
     usedcyclecount.resize(platform.qubit_number, 0);
-    get_qubit_usedcyclecount(k.c, platform, usedcyclecount);
+    get_qubit_usedcyclecount(cv, platform, usedcyclecount);
 
-    size_t  circuit_latency = get_circuit_latency(k.c, platform);
+    size_t  circuit_latency = get_circuit_latency(cv, platform);
     ofs << comment_prefix << "kernel: " << k.name << "\n";
     ofs << comment_prefix << "----- circuit_latency: " << circuit_latency << "\n";
-    ofs << comment_prefix << "----- quantum gates: " << get_quantum_gates_count(k.c, platform) << "\n";
-    ofs << comment_prefix << "----- non single qubit gates: " << get_non_single_qubit_quantum_gates_count(k.c, platform) << "\n";
-    ofs << comment_prefix << "----- classical operations: " << get_classical_operations_count(k.c, platform) << "\n";
+    ofs << comment_prefix << "----- quantum gates: " << get_quantum_gates_count(cv, platform) << "\n";
+    ofs << comment_prefix << "----- non single qubit gates: " << get_non_single_qubit_quantum_gates_count(cv, platform) << "\n";
+    ofs << comment_prefix << "----- classical operations: " << get_classical_operations_count(cv, platform) << "\n";
     ofs << comment_prefix << "----- qubits used: " << qubits_used << "\n";
     ofs << comment_prefix << "----- qubit cycles use:" << utils::to_string(usedcyclecount) << "\n";
     // DOUT("... reporting report_kernel_statistics [done]");
@@ -379,21 +380,22 @@ void get_kernel_statistics(
     }
 
     // DOUT("... reporting report_kernel_statistics");
+    circuit_view cv(k.c);
     std::vector<size_t> usecount;
     usecount.resize(platform.qubit_number, 0);
-    get_qubit_usecount(k.c, platform, usecount);
+    get_qubit_usecount(cv, platform, usecount);
     size_t qubits_used = 0; for (auto v: usecount) { if (v != 0) { qubits_used++; } }
 
     std::vector<size_t> usedcyclecount;
     usedcyclecount.resize(platform.qubit_number, 0);
-    get_qubit_usedcyclecount(k.c, platform, usedcyclecount);
+    get_qubit_usedcyclecount(cv, platform, usedcyclecount);
 
-    size_t  circuit_latency = get_circuit_latency(k.c, platform);
+    size_t  circuit_latency = get_circuit_latency(cv, platform);
     *ofs += comment_prefix; *ofs += "kernel: " ; *ofs += k.name ; *ofs += "\n";
     *ofs += comment_prefix ; *ofs += "----- circuit_latency: " ; *ofs += std::to_string(circuit_latency) ; *ofs += "\n";
-    *ofs += comment_prefix ; *ofs += "----- quantum gates: " ; *ofs += std::to_string(get_quantum_gates_count(k.c, platform)) ; *ofs += "\n";
-    *ofs += comment_prefix; *ofs += "----- non single qubit gates: " ; *ofs += std::to_string(get_non_single_qubit_quantum_gates_count(k.c, platform)) ; *ofs += "\n";
-    *ofs += comment_prefix; *ofs +=  "----- classical operations: "; *ofs += std::to_string(get_classical_operations_count(k.c, platform)); *ofs +=  "\n";
+    *ofs += comment_prefix ; *ofs += "----- quantum gates: " ; *ofs += std::to_string(get_quantum_gates_count(cv, platform)) ; *ofs += "\n";
+    *ofs += comment_prefix; *ofs += "----- non single qubit gates: " ; *ofs += std::to_string(get_non_single_qubit_quantum_gates_count(cv, platform)) ; *ofs += "\n";
+    *ofs += comment_prefix; *ofs +=  "----- classical operations: "; *ofs += std::to_string(get_classical_operations_count(cv, platform)); *ofs +=  "\n";
     *ofs += comment_prefix; *ofs += "----- qubits used: "; *ofs += std::to_string(qubits_used); *ofs += "\n";
     *ofs += comment_prefix; *ofs += "----- qubit cycles use:"; *ofs += utils::to_string(usedcyclecount); *ofs += "\n";
 
@@ -440,12 +442,13 @@ void report_totals_statistics(
     size_t total_quantum_gates = 0;
     size_t total_non_single_qubit_gates= 0;
     for (auto &k : kernels) {
-        get_qubit_usecount(k.c, platform, usecount);
+        circuit_view cv(k.c);
+        get_qubit_usecount(cv, platform, usecount);
 
-        total_circuit_latency += get_circuit_latency(k.c, platform);
-        total_classical_operations += get_classical_operations_count(k.c, platform);
-        total_quantum_gates += get_quantum_gates_count(k.c, platform);
-        total_non_single_qubit_gates += get_non_single_qubit_quantum_gates_count(k.c, platform);
+        total_circuit_latency += get_circuit_latency(cv, platform);
+        total_classical_operations += get_classical_operations_count(cv, platform);
+        total_quantum_gates += get_quantum_gates_count(cv, platform);
+        total_non_single_qubit_gates += get_non_single_qubit_quantum_gates_count(cv, platform);
     }
     size_t qubits_used = 0; for (auto v: usecount) { if (v != 0) { qubits_used++; } }
 
@@ -482,12 +485,13 @@ void get_totals_statistics(
     size_t total_quantum_gates = 0;
     size_t total_non_single_qubit_gates= 0;
     for (auto &k : kernels) {
-        get_qubit_usecount(k.c, platform, usecount);
+        circuit_view cv(k.c);
+        get_qubit_usecount(cv, platform, usecount);
 
-        total_circuit_latency += get_circuit_latency(k.c, platform);
-        total_classical_operations += get_classical_operations_count(k.c, platform);
-        total_quantum_gates += get_quantum_gates_count(k.c, platform);
-        total_non_single_qubit_gates += get_non_single_qubit_quantum_gates_count(k.c, platform);
+        total_circuit_latency += get_circuit_latency(cv, platform);
+        total_classical_operations += get_classical_operations_count(cv, platform);
+        total_quantum_gates += get_quantum_gates_count(cv, platform);
+        total_non_single_qubit_gates += get_non_single_qubit_quantum_gates_count(cv, platform);
     }
     size_t qubits_used = 0; for (auto v: usecount) { if (v != 0) { qubits_used++; } }
 
@@ -1,4 +1,5 @@
 #include "resource_manager.h"
+#include "options.h"
 
 #include "arch/cc_light/cc_light_resource_manager.h"
 // #include "arch/cc/cc_resource_manager.h"
@@ -16,11 +17,168 @@ resource_t::resource_t(
     DOUT("constructing resource: " << n << " for direction (0:fwd,1:bwd): " << dir);
 }
 
+size_t resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    return (forward_scheduling == direction ? op_start_cycle + 1 : op_start_cycle - 1);
+}
+
 void resource_t::Print(const std::string &s) {
     DOUT(s);
     DOUT("resource name=" << name << "; count=" << count);
 }
 
+const size_t timeline_resource_t::no_key;
+
+timeline_resource_t::timeline_resource_t(
+    const std::string &n,
+    scheduling_direction_t dir,
+    size_t units
+) :
+    resource_t(n, dir)
+{
+    count = units;
+    timeline.resize(units);
+    longest.assign(units, 0);
+    horizon = (forward_scheduling == dir ? 0 : MAX_CYCLE);
+    std::string windowopt = options::get("scheduler_resources_window");
+    window = (windowopt == "inf" ? MAX_CYCLE : std::stoi(windowopt));
+}
+
+// whether the claims cv of a gate starting at op_start_cycle for duration cycles
+// overlap a reservation on the same unit with a different key, or the reserved cycles beyond the horizon;
+// when so, next_cycle is the first cycle after (fwd) or before (bwd) op_start_cycle that it may fit:
+// - fwd: at the end of the conflicting reservation, or at its start when the keys may become equal there
+// - bwd: so that it completes at the start of the conflicting reservation, or starts at its start, as fwd
+// of all conflicting reservations, the one furthest away in the scheduling direction is taken,
+// since the gate cannot fit before any of these
+bool timeline_resource_t::conflicts(
+    size_t op_start_cycle,
+    size_t duration,
+    const std::vector<resource_claim_t> &cv,
+    size_t &next_cycle
+) const {
+    size_t  length = std::max<size_t>(duration, 1);     // a gate occupies at least its start cycle
+    bool    found = false;
+
+    next_cycle = op_start_cycle;
+    if (forward_scheduling == direction) {
+        if (op_start_cycle < horizon) {
+            found = true;
+            next_cycle = horizon;
+        }
+    } else {
+        if (op_start_cycle + length > horizon) {
+            found = true;
+            next_cycle = (horizon >= length ? horizon - length : 0);
+        }
+    }
+
+    for (auto &c : cv) {
+        auto &tl = timeline[c.unit];
+        size_t from = (op_start_cycle >= longest[c.unit] ? op_start_cycle - longest[c.unit] + 1 : 0);
+        for (auto it = tl.lower_bound(from); it != tl.end() && it->first < op_start_cycle + length; ++it) {
+            if (it->second.end <= op_start_cycle) {
+                continue;
+            }
+            if (c.key != no_key && c.key == it->second.key) {
+                continue;
+            }
+            found = true;
+            size_t start = it->first;
+            if (forward_scheduling == direction) {
+                next_cycle = std::max(next_cycle, (start > op_start_cycle ? start : it->second.end));
+            } else {
+                next_cycle = std::min(next_cycle, (start < op_start_cycle ? start : (start >= length ? start - length : 0)));
+            }
+        }
+    }
+    return found;
+}
+
+bool timeline_resource_t::available(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    size_t duration;
+    size_t next_cycle;
+
+    claims(op_start_cycle, ins, platform, cv, duration);
+    bool is_available = !conflicts(op_start_cycle, duration, cv, next_cycle);
+    DOUT(" available " << name << "? op_start_cycle: " << op_start_cycle << " for " << ins->qasm() << ": " << (is_available ? "yes" : "no"));
+    return is_available;
+}
+
+void timeline_resource_t::reserve(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    size_t duration;
+
+    claims(op_start_cycle, ins, platform, cv, duration);
+    if (duration == 0) {
+        return;
+    }
+    for (auto &c : cv) {
+        timeline[c.unit].insert(std::make_pair(op_start_cycle, reservation_t{op_start_cycle + duration, c.key}));
+        longest[c.unit] = std::max(longest[c.unit], duration);
+        DOUT("reserved " << name << ". op_start_cycle: " << op_start_cycle << " unit: " << c.unit << " till cycle: " << op_start_cycle + duration << " for " << ins->qasm());
+    }
+    advance_horizon(op_start_cycle, duration);
+}
+
+// keep the reservations within window cycles from the latest one, in the scheduling direction;
+// the horizon is moved in steps of a quarter window, to amortize the pruning over the reservations
+void timeline_resource_t::advance_horizon(size_t op_start_cycle, size_t duration) {
+    if (forward_scheduling == direction) {
+        if (op_start_cycle < window || op_start_cycle - window < horizon + window/4) {
+            return;
+        }
+        horizon = op_start_cycle - window;
+        for (auto &tl : timeline) {
+            for (auto it = tl.begin(); it != tl.end() && it->first < horizon; ) {
+                if (it->second.end <= horizon) {
+                    it = tl.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    } else {
+        size_t end = op_start_cycle + duration;
+        if (end + window + window/4 > horizon) {
+            return;
+        }
+        horizon = end + window;
+        for (auto &tl : timeline) {
+            tl.erase(tl.lower_bound(horizon), tl.end());
+        }
+    }
+}
+
+size_t timeline_resource_t::next_available_cycle(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    size_t duration;
+    size_t cycle = op_start_cycle;
+
+    while (true) {
+        size_t next_cycle;
+        claims(cycle, ins, platform, cv, duration);
+        if (!conflicts(cycle, duration, cv, next_cycle)) {
+            return cycle;
+        }
+        ASSERT(next_cycle != cycle);
+        cycle = next_cycle;
+    }
+}
+
 platform_resource_manager_t::platform_resource_manager_t(
     const quantum_platform &platform,
     scheduling_direction_t dir
@@ -91,6 +249,45 @@ void platform_resource_manager_t::reserve(
     // DOUT("all resources reserved for: " << ins->qasm());
 }
 
+size_t platform_resource_manager_t::first_unavailable(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    for (size_t r = 0; r < resource_ptrs.size(); r++) {
+        if (resource_ptrs[r]->available(op_start_cycle, ins, platform) == false) {
+            return r;
+        }
+    }
+    return resource_ptrs.size();
+}
+
+size_t platform_resource_manager_t::next_available_cycle(
+    size_t r,
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    return resource_ptrs[r]->next_available_cycle(op_start_cycle, ins, platform);
+}
+
+// by repeatedly finding a resource that is not available and continuing at the cycle that it may be;
+// since next_available_cycle never skips a cycle at which the resource is available, this is the first one
+size_t platform_resource_manager_t::earliest_available_cycle(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    size_t cycle = op_start_cycle;
+    while (true) {
+        size_t r = first_unavailable(cycle, ins, platform);
+        if (r == resource_ptrs.size()) {
+            return cycle;
+        }
+        cycle = resource_ptrs[r]->next_available_cycle(cycle, ins, platform);
+    }
+}
+
 // destructor destroying deep resource_t's
 // runs before shallow destruction which is done by synthesized platform_resource_manager_t destructor
 platform_resource_manager_t::~platform_resource_manager_t() {
@@ -167,6 +364,35 @@ void resource_manager_t::reserve(
     platform_resource_manager_ptr->reserve(op_start_cycle, ins, platform);
 }
 
+size_t resource_manager_t::resource_count() const {
+    return platform_resource_manager_ptr->resource_ptrs.size();
+}
+
+size_t resource_manager_t::first_unavailable(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    return platform_resource_manager_ptr->first_unavailable(op_start_cycle, ins, platform);
+}
+
+size_t resource_manager_t::next_available_cycle(
+    size_t r,
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    return platform_resource_manager_ptr->next_available_cycle(r, op_start_cycle, ins, platform);
+}
+
+size_t resource_manager_t::earliest_available_cycle(
+    size_t op_start_cycle,
+    gate *ins,
+    const quantum_platform &platform
+) {
+    return platform_resource_manager_ptr->earliest_available_cycle(op_start_cycle, ins, platform);
+}
+
 // destructor destroying deep platform_resource_managert_t
 // runs before shallow destruction which is done by synthesized resource_manager_t destructor
 resource_manager_t::~resource_manager_t() {
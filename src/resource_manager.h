@@ -12,6 +12,7 @@
 #pragma once
 
 #include <vector>
+#include <map>
 #include <string>
 
 #include <platform.h>
@@ -37,12 +38,74 @@ public:
     virtual bool available(size_t op_start_cycle, gate *ins, const quantum_platform &platform) = 0;
     virtual void reserve(size_t op_start_cycle, gate *ins, const quantum_platform &platform) = 0;
 
+    // when not available at op_start_cycle, the first cycle in the scheduling direction at which it may be;
+    // reservations at op_start_cycle and later cycles (in the scheduling direction) must not be able
+    // to make it available before the cycle returned, so that a scheduler need not test it before then;
+    // this default returns the next cycle, which is always safe
+    virtual size_t next_available_cycle(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+
     virtual resource_t *clone() const & = 0;
     virtual resource_t *clone() && = 0;
 
     void Print(const std::string &s);
 };
 
+// the claim of a gate on one unit of a timeline_resource_t, see there
+typedef struct {
+    size_t unit;        // which unit of the resource
+    size_t key;         // claims with the same key may overlap in time, except for no_key
+} resource_claim_t;
+
+// A resource that keeps for each of its units the reservations made on it as a timeline,
+// i.e. as the set of intervals [start,end) of cycles that the unit is reserved,
+// instead of just the latest reservation as the resources of a platform usually do.
+// A gate claims a set of units (see claims, to be defined by the particular resource) during its duration;
+// it is available when none of its claims overlaps in time a reservation on the same unit with a different key.
+// Since all reservations are kept, a gate can be found to fit in a hole between earlier reservations (backfilling),
+// and next_available_cycle returns the exact first cycle that the gate fits, in the scheduling direction.
+// To bound the timelines, only the reservations within window cycles from the latest one are kept
+// (see option scheduler_resources_window); the cycles before (forward) or after (backward) are considered reserved,
+// so a gate is never backfilled into a hole further away than that.
+//
+// available takes O(c*(log r + k)) for a gate with c claims, on units with r reservations in their timelines,
+// of which k start from longest cycles before op_start_cycle until its end;
+// next_available_cycle does this once for each conflicting reservation that it skips.
+class timeline_resource_t : public resource_t {
+public:
+    static const size_t no_key = ~size_t(0);        // conflicts with all reservations
+
+    typedef struct {
+        size_t end;         // not inclusive
+        size_t key;
+    } reservation_t;
+
+    std::vector<std::multimap<size_t,reservation_t>> timeline;  // timeline[unit]: start cycle -> reservation
+    std::vector<size_t> longest;    // longest[unit]: the longest duration of the reservations in timeline[unit]
+    size_t horizon;                 // fwd: cycles < horizon are reserved; bwd: cycles >= horizon are reserved
+    size_t window;                  // number of cycles kept, from option scheduler_resources_window
+
+    timeline_resource_t(const std::string &n, scheduling_direction_t dir, size_t units);
+
+    // the claims of ins when starting in op_start_cycle, and its duration
+    virtual void claims(
+        size_t op_start_cycle,
+        gate *ins,
+        const quantum_platform &platform,
+        std::vector<resource_claim_t> &cv,
+        size_t &duration
+    ) = 0;
+
+    bool available(size_t op_start_cycle, gate *ins, const quantum_platform &platform) override;
+    void reserve(size_t op_start_cycle, gate *ins, const quantum_platform &platform) override;
+    size_t next_available_cycle(size_t op_start_cycle, gate *ins, const quantum_platform &platform) override;
+
+private:
+    bool conflicts(size_t op_start_cycle, size_t duration, const std::vector<resource_claim_t> &cv, size_t &next_cycle) const;
+    void advance_horizon(size_t op_start_cycle, size_t duration);
+
+    std::vector<resource_claim_t> cv;   // the claims of the gate at hand, kept to reuse its storage
+};
+
 class platform_resource_manager_t {
 public:
 
@@ -72,6 +135,13 @@ public:
     bool available(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
     void reserve(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
 
+    // index in resource_ptrs of the first resource that is not available, resource_ptrs.size() when all are
+    size_t first_unavailable(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+    // for resource r that is not available at op_start_cycle, the first cycle at which it may be
+    size_t next_available_cycle(size_t r, size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+    // the first cycle from op_start_cycle on in the scheduling direction at which all resources are available
+    size_t earliest_available_cycle(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+
     // destructor destroying deep resource_t's
     // runs before shallow destruction which is done by synthesized platform_resource_manager_t destructor
     virtual ~platform_resource_manager_t();
@@ -100,6 +170,14 @@ public:
     bool available(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
     void reserve(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
 
+    // number of resources, and for parking a gate that is not available on the resource that isn't (see resource_t)
+    size_t resource_count() const;
+    size_t first_unavailable(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+    size_t next_available_cycle(size_t r, size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+
+    // the first cycle from op_start_cycle on in the scheduling direction at which all resources are available
+    size_t earliest_available_cycle(size_t op_start_cycle, gate *ins, const quantum_platform &platform);
+
     // destructor destroying deep platform_resource_managert_t
     // runs before shallow destruction which is done by synthesized resource_manager_t destructor
     virtual ~resource_manager_t();
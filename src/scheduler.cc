@@ -1,36 +1,115 @@
 #include "scheduler.h"
 
+#include <limits>
+#include <set>
+#include <tuple>
+
 namespace ql {
 
-Scheduler::Scheduler() :
-    instruction(graph),
-    name(graph),
-    weight(graph),
-    cause(graph),
-    depType(graph)
-{
+size_t DepGraph::NumNodes() const {
+    return instruction.size();
+}
+
+size_t DepGraph::NumArcs() const {
+    return predNode.size();
+}
+
+// add a node for gp; return its index
+size_t DepGraph::AddNode(gate *gp) {
+    instruction.push_back(gp);
+    return instruction.size() - 1;
 }
 
-// ins->name may contain parameters, so must be stripped first before checking it for gate's name
-void Scheduler::stripname(std::string &name) {
-    size_t p = name.find(' ');
-    if (p != std::string::npos) {
-        name = name.substr(0,p);
+// add an arc; the arcs must be added with non-decreasing tgt, as Scheduler::init does
+void DepGraph::AddArc(size_t src, size_t tgt, int weight, int cause, int depType) {
+    ASSERT(src < tgt && tgt < instruction.size());     // so the graph cannot but be a DAG
+    ASSERT(arcTgt.empty() || arcTgt.back() <= tgt);
+    arcSrc.push_back(src);
+    arcTgt.push_back(tgt);
+    arcWeight.push_back(weight);
+    arcCause.push_back(cause);
+    arcDepType.push_back(depType);
+}
+
+// build the pred and succ arrays from the arcs added;
+// the arcs were added grouped by target, so the pred arrays are those arcs, each group reversed;
+// the succ arrays are made by a counting sort on source, filling each group from its end
+void DepGraph::Finalize() {
+    size_t nn = instruction.size();
+    size_t na = arcSrc.size();
+
+    predBegin.assign(nn+1, 0);
+    succBegin.assign(nn+1, 0);
+    for (size_t a = 0; a < na; a++) {
+        predBegin[arcTgt[a]+1]++;
+        succBegin[arcSrc[a]+1]++;
+    }
+    for (size_t n = 0; n < nn; n++) {
+        predBegin[n+1] += predBegin[n];
+        succBegin[n+1] += succBegin[n];
+    }
+
+    predNode.resize(na);
+    predWeight.resize(na);
+    predCause.resize(na);
+    predDepType.resize(na);
+    succNode.resize(na);
+    succWeight.resize(na);
+    succCause.resize(na);
+    succDepType.resize(na);
+    std::vector<size_t> predFill(predBegin.begin()+1, predBegin.end());  // next free position, from the end of each group
+    std::vector<size_t> succFill(succBegin.begin()+1, succBegin.end());
+    for (size_t a = 0; a < na; a++) {
+        size_t pa = --predFill[arcTgt[a]];
+        predNode[pa] = arcSrc[a];
+        predWeight[pa] = arcWeight[a];
+        predCause[pa] = arcCause[a];
+        predDepType[pa] = arcDepType[a];
+
+        size_t sa = --succFill[arcSrc[a]];
+        succNode[sa] = arcTgt[a];
+        succWeight[sa] = arcWeight[a];
+        succCause[sa] = arcCause[a];
+        succDepType[sa] = arcDepType[a];
     }
+
+    std::vector<size_t>().swap(arcSrc);
+    std::vector<size_t>().swap(arcTgt);
+    std::vector<int>().swap(arcWeight);
+    std::vector<int>().swap(arcCause);
+    std::vector<int>().swap(arcDepType);
+}
+
+Scheduler::Scheduler() : remaining_dir(-1) {
 }
 
 // factored out code from Init to add a dependence between two nodes
 // operand is in qubit_creg combined index space
-void Scheduler::add_dep(int srcID, int tgtID, enum DepTypes deptype, int operand) {
+void Scheduler::add_dep(size_t srcID, size_t tgtID, enum DepTypes deptype, int operand) {
     DOUT(".. adddep ... from srcID " << srcID << " to tgtID " << tgtID << "   opnd=" << operand << ", dep=" << DepTypesNames[deptype]);
-    auto srcNode = graph.nodeFromId(srcID);
-    auto tgtNode = graph.nodeFromId(tgtID);
-    auto arc = graph.addArc(srcNode, tgtNode);
-    weight[arc] = int(std::ceil(static_cast<float>(instruction[srcNode]->duration) / cycle_time));
-    // weight[arc] = (instruction[srcNode]->duration + cycle_time -1)/cycle_time;
-    cause[arc] = operand;
-    depType[arc] = deptype;
-    DOUT("... dep " << name[srcNode] << " -> " << name[tgtNode] << " (opnd=" << operand << ", dep=" << DepTypesNames[deptype] << ", wght=" << weight[arc] << ")");
+    int weight = int(std::ceil(static_cast<float>(graph.instruction[srcID]->duration) / cycle_time));
+    // weight = (graph.instruction[srcID]->duration + cycle_time -1)/cycle_time;
+    graph.AddArc(srcID, tgtID, weight, operand, deptype);
+    DOUT("... dep " << graph.instruction[srcID]->qasm() << " -> " << graph.instruction[tgtID]->qasm() << " (opnd=" << operand << ", dep=" << DepTypesNames[deptype] << ", wght=" << weight << ")");
+}
+
+// replace the group of commuting gates in members by a new GROUP node that depends on each of them;
+// the GROUP node has duration 0, so a dependence on it constrains a gate as dependences on all members would
+void Scheduler::add_group(std::vector<size_t> &members, enum DepTypes deptype, int operand) {
+    groups.emplace_back();
+    gate *groupgp = &groups.back();
+    size_t groupID = graph.AddNode(groupgp);
+    node[groupgp] = groupID;
+    DOUT(".. adding GROUP node " << groupID << " for " << members.size() << " gates on opnd=" << operand);
+    for (auto memberID : members) {
+        add_dep(memberID, groupID, deptype, operand);
+    }
+    members.assign(1, groupID);
+}
+
+// whether node n is a GROUP node, i.e. a dummy gate other than SOURCE and SINK
+bool Scheduler::is_group(size_t n) const {
+    return n != s && n != t && graph.instruction[n]->type() == gate_type_t::__dummy_gate__;
 }
 
 // fill the dependence graph ('graph') with nodes from the circuit and adding arcs for their dependences
@@ -54,7 +133,7 @@ void Scheduler::init(
     // - the previous gates that D qubit q in LastDs[q]; this is a list
     // - the previous gate that Wrote r in LastWriter[r]; this can only be one
     // operands can be a qubit or a classical register
-    typedef std::vector<int> ReadersListType;
+    typedef std::vector<size_t> ReadersListType;
 
     std::vector<ReadersListType> LastReaders;
     LastReaders.resize(qubit_creg_count);
@@ -62,19 +141,20 @@ void Scheduler::init(
     std::vector<ReadersListType> LastDs;
     LastDs.resize(qubit_creg_count);
 
+    node.reserve(ckt.size() + 2);
+
     // start filling the dependence graph by creating the s node, the top of the graph
     {
         // add dummy source node
-        auto srcNode = graph.addNode();
-        instruction[srcNode] = new SOURCE();    // so SOURCE is defined as instruction[s], not unique in itself
-        node[instruction[srcNode]] = srcNode;
-        name[srcNode] = instruction[srcNode]->qasm();
-        s = srcNode;
+        gate *srcgp = &source;          // so SOURCE is defined as instruction[s], not unique in itself
+        s = graph.AddNode(srcgp);
+        node[srcgp] = s;
     }
-    int srcID = graph.id(s);
-    std::vector<int> LastWriter(qubit_creg_count, srcID);     // it implicitly writes to all qubits and class. regs
+    size_t srcID = s;
+    std::vector<size_t> LastWriter(qubit_creg_count, srcID);  // it implicitly writes to all qubits and class. regs
 
     // for each gate pointer ins in the circuit, add a node and add dependences from previous gates to it
+    std::string namebuf;
     for (auto ins : ckt) {
         DOUT("Current instruction's name: `" << ins->name << "'");
         DOUT(".. Qasm(): " << ins->qasm());
@@ -85,15 +165,12 @@ void Scheduler::init(
             DOUT(".. Classical operand: `" << coperand << "'");
         }
 
-        auto iname = ins->name; // copy!!!!
-        stripname(iname);
+        // ins->name may contain parameters, so use its name without them for checking it for gate's name
+        const std::string &iname = platform.instructions->base_name(ins, namebuf);
 
         // Add node
-        lemon::ListDigraph::Node consNode = graph.addNode();
-        int consID = graph.id(consNode);
-        instruction[consNode] = ins;
-        node[ins] = consNode;
-        name[consNode] = ins->qasm();
+        size_t consID = graph.AddNode(ins);
+        node[ins] = consID;
 
         // Add edges (arcs)
         // In quantum computing there are no real Reads and Writes on qubits because they cannot be cloned.
@@ -159,7 +236,7 @@ void Scheduler::init(
 
         // each type of gate has a different 'signature' of events; switch out to each one
         if (iname == "measure") {
-            DOUT(". considering " << name[consNode] << " as measure");
+            DOUT(". considering " << ins->qasm() << " as measure");
             // Read+Write each qubit operand + Write corresponding creg
             auto operands = ins->operands;
             for (auto operand : operands) {
@@ -199,7 +276,7 @@ void Scheduler::init(
             }
             DOUT(". measure done");
         } else if (iname == "display") {
-            DOUT(". considering " << name[consNode] << " as display");
+            DOUT(". considering " << ins->qasm() << " as display");
             // no operands, display all qubits and cregs
             // Read+Write each operand
             std::vector<size_t> qubits(qubit_creg_count);
@@ -222,7 +299,7 @@ void Scheduler::init(
                 LastDs[operand].clear();
             }
         } else if (ins->type() == gate_type_t::__classical_gate__) {
-            DOUT(". considering " << name[consNode] << " as classical gate");
+            DOUT(". considering " << ins->qasm() << " as classical gate");
             // Read+Write each classical operand
             for (auto coperand : ins->creg_operands) {
                 DOUT("... Classical operand: " << coperand);
@@ -242,7 +319,7 @@ void Scheduler::init(
                 LastDs[qubit_count+coperand].clear();
             }
         } else if (iname == "cnot") {
-            DOUT(". considering " << name[consNode] << " as cnot");
+            DOUT(". considering " << ins->qasm() << " as cnot");
             // CNOTs Read the first operands, and Ds the second operand
             size_t operandNo=0;
             auto operands = ins->operands;
@@ -286,7 +363,7 @@ void Scheduler::init(
                 operandNo++;
             }
         } else if (iname == "cz" || iname == "cphase") {
-            DOUT(". considering " << name[consNode] << " as cz");
+            DOUT(". considering " << ins->qasm() << " as cz");
             // CZs Read all operands
             size_t operandNo = 0;
             auto operands = ins->operands;
@@ -317,7 +394,7 @@ void Scheduler::init(
             // Read on all operands, Write on last operand
             // before implementing it, check whether all commutativity on Reads above hold for this Control Unitary
         ) {
-            DOUT(". considering " << name[consNode] << " as Control Unitary");
+            DOUT(". considering " << ins->qasm() << " as Control Unitary");
             // Control Unitaries Read all operands, and Write the last operand
             size_t operandNo=0;
             auto operands = ins->operands;
@@ -354,7 +431,7 @@ void Scheduler::init(
             } // end of operand for
 #endif  // HAVEGENERALCONTROLUNITARIES
         } else {
-            DOUT(". considering " << name[consNode] << " as no special gate (catch-all, generic rules)");
+            DOUT(". considering " << ins->qasm() << " as no special gate (catch-all, generic rules)");
             // Read+Write on each quantum operand
             // Read+Write on each classical operand
             auto operands = ins->operands;
@@ -390,6 +467,16 @@ void Scheduler::init(
                 LastDs[qubit_count+coperand].clear();
             } // end of coperand for
         } // end of if/else
+
+        // keep the groups of commuting gates small, so that a next gate depends on few gates
+        for (auto operand : ins->operands) {
+            if (LastReaders[operand].size() >= COMMUTE_GROUP_MAX) {
+                add_group(LastReaders[operand], RAR, operand);
+            }
+            if (LastDs[operand].size() >= COMMUTE_GROUP_MAX) {
+                add_group(LastDs[operand], DAD, operand);
+            }
+        }
         DOUT(". instruction done: " << ins->qasm());
     } // end of instruction for
 
@@ -397,12 +484,10 @@ void Scheduler::init(
     // finish filling the dependence graph by creating the t node, the bottom of the graph
     {
         // add dummy target node
-        lemon::ListDigraph::Node consNode = graph.addNode();
-        int consID = graph.id(consNode);
-        instruction[consNode] = new SINK();    // so SINK is defined as instruction[t], not unique in itself
-        node[instruction[consNode]] = consNode;
-        name[consNode] = instruction[consNode]->qasm();
-        t = consNode;
+        gate *tgtgp = &sink;            // so SINK is defined as instruction[t], not unique in itself
+        size_t consID = graph.AddNode(tgtgp);
+        node[tgtgp] = consID;
+        t = consID;
 
         // add deps to the dummy target node to close the dependence chains
         // it behaves as a W to every qubit and creg
@@ -437,114 +522,90 @@ void Scheduler::init(
         }
     }
 
-    // useless as well because by construction, there cannot be cycles
-    // but when afterwards dependences are added, cycles may be created,
-    // and after doing so (a copy of) this test should certainly be done because
-    // a cyclic dependence graph cannot be scheduled;
-    // this test here is a kind of debugging aid whether dependence creation was done well
-    if (!dag(graph)) {
-        FATAL("The dependence graph is not a DAG.");
-    }
+    // by construction, there cannot be cycles: each dependence is from a previous gate to the current one,
+    // which DepGraph::AddArc checks, so no test for being a DAG is needed
+    graph.Finalize();
     DOUT("Dependence graph creation Done.");
 }
 
 void Scheduler::print() const {
     COUT("Printing Dependence Graph ");
-    digraphWriter(graph).
-        nodeMap("name", name).
-        arcMap("cause", cause).
-        arcMap("weight", weight).
-        // arcMap("depType", depType).
-        node("source", s).
-        node("target", t).
-        run();
+    print_lists(std::cout);
 }
 
-void Scheduler::write_dependence_matrix() const {
-    COUT("Printing Dependence Matrix ...");
-    std::ofstream fout;
-    std::string datfname( options::get("output_dir") + "/dependenceMatrix.dat");
-    fout.open(datfname, std::ios::binary);
-    if (fout.fail()) {
-        EOUT("opening file " << datfname << std::endl
-                             << "Make sure the output directory ("<< options::get("output_dir") << ") exists");
-        return;
-    }
-
-    size_t totalInstructions = countNodes(graph);
-    std::vector<std::vector<bool> > Matrix(totalInstructions, std::vector<bool>(totalInstructions));
-
-    // now print the edges
-    for (lemon::ListDigraph::ArcIt arc(graph); arc != lemon::INVALID; ++arc) {
-        auto srcNode = graph.source(arc);
-        auto dstNode = graph.target(arc);
-        size_t srcID = graph.id( srcNode );
-        size_t dstID = graph.id( dstNode );
-        Matrix[srcID][dstID] = true;
+// the dependence graph as a list of nodes and a list of arcs, in LEMON graph format
+void Scheduler::print_lists(std::ostream &out) const {
+    out << "@nodes" << std::endl << "label\tname" << std::endl;
+    for (size_t n = 0; n < graph.NumNodes(); n++) {
+        out << n << "\t\"" << graph.instruction[n]->qasm() << "\"" << std::endl;
     }
-
-    for (size_t i = 1; i < totalInstructions - 1; i++) {
-        for (size_t j = 1; j < totalInstructions - 1; j++) {
-            fout << Matrix[j][i] << "\t";
+    out << "@arcs" << std::endl << "\t\tcause\tweight\tdeptype" << std::endl;
+    for (size_t n = 0; n < graph.NumNodes(); n++) {
+        for (size_t a = graph.succBegin[n]; a < graph.succBegin[n+1]; a++) {
+            out << n << "\t" << graph.succNode[a] << "\t" << graph.succCause[a] << "\t" << graph.succWeight[a]
+                << "\t" << DepTypesNames[graph.succDepType[a]] << std::endl;
         }
-        fout << std::endl;
     }
+    out << "@attributes" << std::endl << "source\t" << s << std::endl << "target\t" << t << std::endl;
+}
 
-    fout.close();
+// write the dependence graph to file fname as lists of its nodes and arcs (see print_lists);
+// unlike a dependence matrix, this is linear in the size of the graph
+void Scheduler::write_dependence_list(const std::string &fname) const {
+    std::ofstream fout(fname);
+    if (fout.fail()) {
+        EOUT("opening file " << fname << std::endl
+                             << "Make sure the output directory ("<< options::get("output_dir") << ") exists");
+        return;
+    }
+    print_lists(fout);
 }
 
 // cycle assignment without RC depending on direction: forward:ASAP, backward:ALAP;
 // without RC, this is all there is to schedule, apart from forming the bundles in ir::bundler()
-// set_cycle iterates over the circuit's gates and set_cycle_gate over the dependences of each gate
-// please note that set_cycle_gate expects a caller like set_cycle which iterates gp forward through the circuit
-void Scheduler::set_cycle_gate(gate *gp, scheduling_direction_t dir) {
-    lemon::ListDigraph::Node currNode = node[gp];
+// set_cycle iterates over the graph's nodes and set_cycle_gate over the dependences of each node
+// please note that set_cycle_gate expects a caller like set_cycle which iterates n forward through the nodes
+void Scheduler::set_cycle_gate(size_t n, scheduling_direction_t dir) {
     size_t  currCycle;
     if (forward_scheduling == dir) {
         currCycle = 0;
-        for (lemon::ListDigraph::InArcIt arc(graph,currNode); arc != lemon::INVALID; ++arc) {
-            currCycle = std::max(currCycle, instruction[graph.source(arc)]->cycle + weight[arc]);
+        for (size_t a = graph.predBegin[n]; a < graph.predBegin[n+1]; a++) {
+            currCycle = std::max(currCycle, graph.instruction[graph.predNode[a]]->cycle + graph.predWeight[a]);
         }
     } else {
         currCycle = MAX_CYCLE;
-        for (lemon::ListDigraph::OutArcIt arc(graph,currNode); arc != lemon::INVALID; ++arc) {
-            currCycle = std::min(currCycle, instruction[graph.target(arc)]->cycle - weight[arc]);
+        for (size_t a = graph.succBegin[n]; a < graph.succBegin[n+1]; a++) {
+            currCycle = std::min(currCycle, graph.instruction[graph.succNode[a]]->cycle - graph.succWeight[a]);
         }
     }
-    gp->cycle = currCycle;
+    graph.instruction[n]->cycle = currCycle;
 }
 
 void Scheduler::set_cycle(scheduling_direction_t dir) {
+    // the nodes are by construction in a topological order of the dependence graph, s first and t last
     if (forward_scheduling == dir) {
-        instruction[s]->cycle = 0;
-        DOUT("... set_cycle of " << instruction[s]->qasm() << " cycles " << instruction[s]->cycle);
-        // *circp is by definition in a topological order of the dependence graph
-        for (auto gpit = circp->begin(); gpit != circp->end(); gpit++) {
-            set_cycle_gate(*gpit, dir);
-            DOUT("... set_cycle of " << (*gpit)->qasm() << " cycles " << (*gpit)->cycle);
+        graph.instruction[s]->cycle = 0;
+        DOUT("... set_cycle of " << graph.instruction[s]->qasm() << " cycles " << graph.instruction[s]->cycle);
+        for (size_t n = s+1; n <= t; n++) {
+            set_cycle_gate(n, dir);
+            DOUT("... set_cycle of " << graph.instruction[n]->qasm() << " cycles " << graph.instruction[n]->cycle);
         }
-        set_cycle_gate(instruction[t], dir);
-        DOUT("... set_cycle of " << instruction[t]->qasm() << " cycles " << instruction[t]->cycle);
     } else {
-        instruction[t]->cycle = ALAP_SINK_CYCLE;
-        // *circp is by definition in a topological order of the dependence graph
-        for (auto gpit = circp->rbegin(); gpit != circp->rend(); gpit++) {
-            set_cycle_gate(*gpit, dir);
+        graph.instruction[t]->cycle = ALAP_SINK_CYCLE;
+        for (size_t n = t; n-- > s; ) {
+            set_cycle_gate(n, dir);
         }
-        set_cycle_gate(instruction[s], dir);
 
         // readjust cycle values of gates so that SOURCE is at 0
-        size_t  SOURCECycle = instruction[s]->cycle;
+        size_t  SOURCECycle = graph.instruction[s]->cycle;
         DOUT("... readjusting cycle values by -" << SOURCECycle);
 
-        instruction[t]->cycle -= SOURCECycle;
-        DOUT("... set_cycle of " << instruction[t]->qasm() << " cycles " << instruction[t]->cycle);
-        for (auto &gp : *circp) {
-            gp->cycle -= SOURCECycle;
-            DOUT("... set_cycle of " << gp->qasm() << " cycles " << gp->cycle);
+        for (size_t n = t; n > s; n--) {
+            graph.instruction[n]->cycle -= SOURCECycle;
+            DOUT("... set_cycle of " << graph.instruction[n]->qasm() << " cycles " << graph.instruction[n]->cycle);
         }
-        instruction[s]->cycle -= SOURCECycle;   // i.e. becomes 0
-        DOUT("... set_cycle of " << instruction[s]->qasm() << " cycles " << instruction[s]->cycle);
+        graph.instruction[s]->cycle -= SOURCECycle;   // i.e. becomes 0
+        DOUT("... set_cycle of " << graph.instruction[s]->qasm() << " cycles " << graph.instruction[s]->cycle);
     }
 }
 
@@ -573,79 +634,60 @@ void Scheduler::sort_by_cycle(circuit *cp) {
 }
 
 // ASAP scheduler without RC, setting gate cycle values and sorting the resulting circuit
-void Scheduler::schedule_asap(std::string &sched_dot) {
+void Scheduler::schedule_asap() {
     DOUT("Scheduling ASAP ...");
     set_cycle(forward_scheduling);
     sort_by_cycle(circp);
 
-    if (options::get("print_dot_graphs") == "yes") {
-        std::stringstream ssdot;
-        get_dot(false, true, ssdot);
-        sched_dot = ssdot.str();
-    }
-
     DOUT("Scheduling ASAP [DONE]");
 }
 
 // ALAP scheduler without RC, setting gate cycle values and sorting the resulting circuit
-void Scheduler::schedule_alap(std::string &sched_dot) {
+void Scheduler::schedule_alap() {
     DOUT("Scheduling ALAP ...");
     set_cycle(backward_scheduling);
     sort_by_cycle(circp);
 
-    if (options::get("print_dot_graphs") == "yes") {
-        std::stringstream ssdot;
-        get_dot(false, true, ssdot);
-        sched_dot = ssdot.str();
-    }
-
     DOUT("Scheduling ALAP [DONE]");
 }
 
-// Note that set_remaining_gate expects a caller like set_remaining that iterates gp backward over the circuit
-void Scheduler::set_remaining_gate(gate* gp, scheduling_direction_t dir) {
-    auto currNode = node[gp];
+// Note that set_remaining_gate expects a caller like set_remaining that iterates n backward over the nodes
+void Scheduler::set_remaining_gate(size_t n, scheduling_direction_t dir) {
     size_t currRemain = 0;
     if (forward_scheduling == dir) {
-        for (lemon::ListDigraph::OutArcIt arc(graph,currNode); arc != lemon::INVALID; ++arc) {
-            currRemain = std::max(currRemain, remaining[graph.target(arc)] + weight[arc]);
+        for (size_t a = graph.succBegin[n]; a < graph.succBegin[n+1]; a++) {
+            currRemain = std::max(currRemain, remaining[graph.succNode[a]] + graph.succWeight[a]);
         }
     } else {
-        for (lemon::ListDigraph::InArcIt arc(graph,currNode); arc != lemon::INVALID; ++arc) {
-            currRemain = std::max(currRemain, remaining[graph.source(arc)] + weight[arc]);
+        for (size_t a = graph.predBegin[n]; a < graph.predBegin[n+1]; a++) {
+            currRemain = std::max(currRemain, remaining[graph.predNode[a]] + graph.predWeight[a]);
         }
     }
-    remaining[currNode] = currRemain;
+    remaining[n] = currRemain;
 }
 
 void Scheduler::set_remaining(scheduling_direction_t dir) {
-    gate *gp;
-    remaining.clear();
+    if (remaining_dir == int(dir)) {
+        return;
+    }
+    remaining.assign(graph.NumNodes(), 0);
+    // the nodes are by construction in a topological order of the dependence graph, s first and t last
     if (forward_scheduling == dir) {
         // remaining until SINK (i.e. the SINK.cycle-ALAP value)
         remaining[t] = 0;
-        // *circp is by definition in a topological order of the dependence graph
-        for (auto gpit = circp->rbegin(); gpit != circp->rend(); gpit++) {
-            gate *gp2 = *gpit;
-            set_remaining_gate(gp2, dir);
-            DOUT("... remaining at " << gp2->qasm() << " cycles " << remaining[node[gp2]]);
+        for (size_t n = t; n-- > s; ) {
+            set_remaining_gate(n, dir);
+            DOUT("... remaining at " << graph.instruction[n]->qasm() << " cycles " << remaining[n]);
         }
-        gp = instruction[s];
-        set_remaining_gate(gp, dir);
-        DOUT("... remaining at " << gp->qasm() << " cycles " << remaining[s]);
     } else {
         // remaining until SOURCE (i.e. the ASAP value)
         remaining[s] = 0;
-        // *circp is by definition in a topological order of the dependence graph
-        for (auto gpit = circp->begin(); gpit != circp->end(); gpit++) {
-            gate*   gp2 = *gpit;
-            set_remaining_gate(gp2, dir);
-            DOUT("... remaining at " << gp2->qasm() << " cycles " << remaining[node[gp2]]);
+        for (size_t n = s+1; n <= t; n++) {
+            set_remaining_gate(n, dir);
+            DOUT("... remaining at " << graph.instruction[n]->qasm() << " cycles " << remaining[n]);
         }
-        gp = instruction[t];
-        set_remaining_gate(gp, dir);
-        DOUT("... remaining at " << gp->qasm() << " cycles " << remaining[t]);
     }
+    remaining_dir = int(dir);
 }
 
 gate *Scheduler::find_mostcritical(std::list<gate*> &lg) {
@@ -665,20 +707,26 @@ gate *Scheduler::find_mostcritical(std::list<gate*> &lg) {
 // Set the curr_cycle of the scheduling algorithm to start at the appropriate end as well;
 // note that the cycle attributes will be shifted down to start at 1 after backward scheduling.
 void Scheduler::init_available(
-    std::list<lemon::ListDigraph::Node> &avlist,
+    avlist_t &avlist,
     scheduling_direction_t dir,
     size_t &curr_cycle
 ) {
-    avlist.clear();
+    avlist.seq.assign(graph.NumNodes(), std::numeric_limits<size_t>::max());    // none were made available
+    avlist.nextseq = 0;
+    avlist.ready.clear();
+    avlist.pending.clear();
+    avlist.parked.clear();
+    size_t n;
     if (forward_scheduling == dir) {
         curr_cycle = 0;
-        instruction[s]->cycle = curr_cycle;
-        avlist.push_back(s);
+        n = s;
     } else {
         curr_cycle = ALAP_SINK_CYCLE;
-        instruction[t]->cycle = curr_cycle;
-        avlist.push_back(t);
+        n = t;
     }
+    graph.instruction[n]->cycle = curr_cycle;
+    avlist.seq[n] = avlist.nextseq++;
+    avlist.ready[avlist.key(n)] = n;
 }
 
 // collect the list of directly depending nodes
@@ -686,13 +734,17 @@ void Scheduler::init_available(
 // dependences that are duplicates from the perspective of the scheduler
 // may be present in the dependence graph because the scheduler ignores dependence type and cause
 void Scheduler::get_depending_nodes(
-    lemon::ListDigraph::Node n,
+    size_t n,
     scheduling_direction_t dir,
-    std::list<lemon::ListDigraph::Node> &ln
+    std::list<size_t> &ln
 ) {
     if (forward_scheduling == dir) {
-        for (lemon::ListDigraph::OutArcIt succArc(graph,n); succArc != lemon::INVALID; ++succArc) {
-            auto succNode = graph.target(succArc);
+        for (size_t a = graph.succBegin[n]; a < graph.succBegin[n+1]; a++) {
+            size_t succNode = graph.succNode[a];
+            if (is_group(succNode)) {
+                get_depending_nodes(succNode, dir, ln);     // as if depending on the group's gates directly
+                continue;
+            }
             // DOUT("...... succ of " << instruction[n]->qasm() << " : " << instruction[succNode]->qasm());
             bool found = false;             // filter out duplicates
             for (auto anySuccNode : ln) {
@@ -707,8 +759,12 @@ void Scheduler::get_depending_nodes(
         }
         // ln contains depending nodes of n without duplicates
     } else {
-        for (lemon::ListDigraph::InArcIt predArc(graph,n); predArc != lemon::INVALID; ++predArc) {
-            lemon::ListDigraph::Node predNode = graph.source(predArc);
+        for (size_t a = graph.predBegin[n]; a < graph.predBegin[n+1]; a++) {
+            size_t predNode = graph.predNode[a];
+            if (is_group(predNode)) {
+                get_depending_nodes(predNode, dir, ln);     // as if depending on the group's gates directly
+                continue;
+            }
             // DOUT("...... pred of " << instruction[n]->qasm() << " : " << instruction[predNode]->qasm());
             bool found = false;             // filter out duplicates
             for (auto anyPredNode : ln) {
@@ -731,8 +787,8 @@ void Scheduler::get_depending_nodes(
 // this function is used to order the avlist in an order from highest deep-criticality to lowest deep-criticality;
 // it is the core of the heuristics of the critical path list scheduler.
 bool Scheduler::criticality_lessthan(
-    lemon::ListDigraph::Node n1,
-    lemon::ListDigraph::Node n2,
+    size_t n1,
+    size_t n2,
     scheduling_direction_t dir
 ) {
     if (n1 == n2) return false;             // because not <
@@ -741,8 +797,8 @@ bool Scheduler::criticality_lessthan(
     if (remaining[n1] > remaining[n2]) return false;
     // so: remaining[n1] == remaining[n2]
 
-    std::list<lemon::ListDigraph::Node> ln1;
-    std::list<lemon::ListDigraph::Node> ln2;
+    std::list<size_t> ln1;
+    std::list<size_t> ln2;
 
     get_depending_nodes(n1, dir, ln1);
     get_depending_nodes(n2, dir, ln2);
@@ -750,8 +806,8 @@ bool Scheduler::criticality_lessthan(
     if (ln1.empty()) return true;           // so when both empty, it is equal, so not strictly <, so false
     // so: ln1.non_empty && ln2.non_empty
 
-    ln1.sort([this](const lemon::ListDigraph::Node &d1, const lemon::ListDigraph::Node &d2) { return remaining[d1] < remaining[d2]; });
-    ln2.sort([this](const lemon::ListDigraph::Node &d1, const lemon::ListDigraph::Node &d2) { return remaining[d1] < remaining[d2]; });
+    ln1.sort([this](const size_t &d1, const size_t &d2) { return remaining[d1] < remaining[d2]; });
+    ln2.sort([this](const size_t &d1, const size_t &d2) { return remaining[d1] < remaining[d2]; });
 
     size_t crit_dep_n1 = remaining[ln1.back()];    // the last of the list is the one with the largest remaining value
     size_t crit_dep_n2 = remaining[ln2.back()];
@@ -760,68 +816,84 @@ bool Scheduler::criticality_lessthan(
     if (crit_dep_n1 > crit_dep_n2) return false;
     // so: crit_dep_n1 == crit_dep_n2, call this crit_dep
 
-    ln1.remove_if([this,crit_dep_n1](lemon::ListDigraph::Node n) { return remaining[n] < crit_dep_n1; });
-    ln2.remove_if([this,crit_dep_n2](lemon::ListDigraph::Node n) { return remaining[n] < crit_dep_n2; });
+    ln1.remove_if([this,crit_dep_n1](size_t n) { return remaining[n] < crit_dep_n1; });
+    ln2.remove_if([this,crit_dep_n2](size_t n) { return remaining[n] < crit_dep_n2; });
     // because both contain element with remaining == crit_dep: ln1.non_empty && ln2.non_empty
 
     if (ln1.size() < ln2.size()) return true;
     if (ln1.size() > ln2.size()) return false;
     // so: ln1.size() == ln2.size() >= 1
 
-    ln1.sort([this,dir](const lemon::ListDigraph::Node &d1, const lemon::ListDigraph::Node &d2) { return criticality_lessthan(d1, d2, dir); });
-    ln2.sort([this,dir](const lemon::ListDigraph::Node &d1, const lemon::ListDigraph::Node &d2) { return criticality_lessthan(d1, d2, dir); });
+    ln1.sort([this,dir](const size_t &d1, const size_t &d2) { return criticality_lessthan(d1, d2, dir); });
+    ln2.sort([this,dir](const size_t &d1, const size_t &d2) { return criticality_lessthan(d1, d2, dir); });
     return criticality_lessthan(ln1.back(), ln2.back(), dir);
 }
 
+// rank the nodes on deep-criticality (see criticality_lessthan) for the given direction, after set_remaining:
+// critrank[n] == 0 for the most critical ones and equally critical nodes share their rank;
+// keeping nodes ordered on critrank and then on the order of adding them is then the same as
+// inserting each node in an ordered list just before the first node that is less critical
+void Scheduler::rank_criticality(scheduling_direction_t dir, std::vector<size_t> &critrank) {
+    std::vector<size_t> &ranks = critranks[dir];
+    if (ranks.empty()) {
+        std::vector<size_t> byCriticality;
+        for (size_t n = graph.NumNodes(); n-- > 0; ) {
+            byCriticality.push_back(n);
+        }
+        // stable_sort, since it doesn't rely on criticality_lessthan being a strict weak ordering to stay in range
+        std::stable_sort(byCriticality.begin(), byCriticality.end(),
+            [this,dir](size_t n1, size_t n2) { return criticality_lessthan(n2, n1, dir); });
+
+        ranks.assign(graph.NumNodes(), 0);
+        size_t rank = 0;
+        for (size_t k = 0; k < byCriticality.size(); k++) {
+            if (k > 0 && criticality_lessthan(byCriticality[k], byCriticality[k-1], dir)) {
+                rank++;
+            }
+            ranks[byCriticality[k]] = rank;
+        }
+    }
+    critrank = ranks;
+}
+
+avlist_t::key_t avlist_t::key(size_t n) const {
+    return key_t(critrank[n], seq[n]);
+}
+
+bool avlist_t::empty() const {
+    if (!ready.empty() || !pending.empty()) {
+        return false;
+    }
+    for (auto &p : parked) {
+        if (!p.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // Make node n available
 // add it to the avlist because the condition for that is fulfilled:
 //  all its predecessors were scheduled (forward scheduling) or
 //  all its successors were scheduled (backward scheduling)
 // update its cycle attribute to reflect these dependences;
 // avlist is initialized with s or t as first element by init_available
-// avlist is kept ordered on deep-criticality, non-increasing (i.e. highest deep-criticality first)
+// n is added to avlist.pending, from where it gets ready when it has completed (see SelectAvailable);
+// its sequence number keeps it after the equally critical nodes that were made available before
 void Scheduler::MakeAvailable(
-    lemon::ListDigraph::Node n,
-    std::list<lemon::ListDigraph::Node> &avlist,
+    size_t n,
+    avlist_t &avlist,
     scheduling_direction_t dir
 ) {
-    bool already_in_avlist = false;  // check whether n is already in avlist
-    // originates from having multiple arcs between pair of nodes
-    std::list<lemon::ListDigraph::Node>::iterator first_lower_criticality_inp; // for keeping avlist ordered
-    bool first_lower_criticality_found = false;                          // for keeping avlist ordered
-
-    DOUT(".... making available node " << name[n] << " remaining: " << remaining[n]);
-    for (auto inp = avlist.begin(); inp != avlist.end(); inp++) {
-        if (*inp == n) {
-            already_in_avlist = true;
-            DOUT("...... duplicate when making available: " << name[n]);
-        } else {
-            // scanning avlist from front to back (avlist is ordered from high to low criticality)
-            // when encountering first node *inp with less criticality,
-            // that is where new node n should be inserted just before,
-            // to keep avlist in desired order
-            //
-            // consequence is that
-            // when a node has same criticality as n, new node n is put after it, as last one of set of same criticality,
-            // so order of calling MakeAvailable (and probably original circuit, and running other scheduler first) matters,
-            // also when all dependence sets (and so remaining values) are identical!
-            if (criticality_lessthan(*inp, n, dir) && !first_lower_criticality_found) {
-                first_lower_criticality_inp = inp;
-                first_lower_criticality_found = true;
-            }
-        }
-    }
-    if (!already_in_avlist) {
-        set_cycle_gate(instruction[n], dir);        // for the schedulers to inspect whether gate has completed
-        if (first_lower_criticality_found) {
-            // add n to avlist just before the first with lower criticality
-            avlist.insert(first_lower_criticality_inp, n);
-        } else {
-            // add n to end of avlist, if none found with less criticality
-            avlist.push_back(n);
-        }
-        DOUT("...... made available node(@" << instruction[n]->cycle << "): " << name[n] << " remaining: " << remaining[n]);
+    if (avlist.seq[n] != std::numeric_limits<size_t>::max()) {
+        // originates from having multiple arcs between pair of nodes
+        DOUT("...... duplicate when making available: " << graph.instruction[n]->qasm());
+        return;
     }
+    set_cycle_gate(n, dir);         // for the schedulers to inspect whether gate has completed
+    avlist.seq[n] = avlist.nextseq++;
+    avlist.pending.insert(std::make_pair(graph.instruction[n]->cycle, n));
+    DOUT("...... made available node(@" << graph.instruction[n]->cycle << "): " << graph.instruction[n]->qasm() << " remaining: " << remaining[n]);
 }
 
 // take node n out of avlist because it has been scheduled;
@@ -842,21 +914,20 @@ void Scheduler::MakeAvailable(
 // because from then on that value is compared to the curr_cycle to check
 // whether a node has completed execution and thus is available for scheduling in curr_cycle
 void Scheduler::TakeAvailable(
-    lemon::ListDigraph::Node n,
-    std::list<lemon::ListDigraph::Node> &avlist,
-    std::map<gate*,bool> &scheduled,
+    size_t n,
+    avlist_t &avlist,
+    std::vector<bool> &scheduled,
     scheduling_direction_t dir
 ) {
-    scheduled[instruction[n]] = true;
-    avlist.remove(n);
+    scheduled[n] = true;
+    avlist.ready.erase(avlist.key(n));
 
     if (forward_scheduling == dir) {
-        for (lemon::ListDigraph::OutArcIt succArc(graph,n); succArc != lemon::INVALID; ++succArc) {
-            auto succNode = graph.target(succArc);
+        for (size_t sa = graph.succBegin[n]; sa < graph.succBegin[n+1]; sa++) {
+            size_t succNode = graph.succNode[sa];
             bool schedulable = true;
-            for (lemon::ListDigraph::InArcIt predArc(graph,succNode); predArc != lemon::INVALID; ++predArc) {
-                lemon::ListDigraph::Node predNode = graph.source(predArc);
-                if (!scheduled[instruction[predNode]]) {
+            for (size_t pa = graph.predBegin[succNode]; pa < graph.predBegin[succNode+1]; pa++) {
+                if (!scheduled[graph.predNode[pa]]) {
                     schedulable = false;
                     break;
                 }
@@ -866,12 +937,11 @@ void Scheduler::TakeAvailable(
             }
         }
     } else {
-        for (lemon::ListDigraph::InArcIt predArc(graph,n); predArc != lemon::INVALID; ++predArc) {
-            auto predNode = graph.source(predArc);
+        for (size_t pa = graph.predBegin[n]; pa < graph.predBegin[n+1]; pa++) {
+            size_t predNode = graph.predNode[pa];
             bool schedulable = true;
-            for (lemon::ListDigraph::OutArcIt succArc(graph,predNode); succArc != lemon::INVALID; ++succArc) {
-                auto succNode = graph.target(succArc);
-                if (!scheduled[instruction[succNode]]) {
+            for (size_t sa = graph.succBegin[predNode]; sa < graph.succBegin[predNode+1]; sa++) {
+                if (!scheduled[graph.succNode[sa]]) {
                     schedulable = false;
                     break;
                 }
@@ -884,15 +954,31 @@ void Scheduler::TakeAvailable(
 }
 
 // advance curr_cycle
-// when no node was selected from the avlist, advance to the next cycle
-// and try again; this makes nodes/instructions to complete execution for one more cycle,
-// and makes resources finally available in case of resource constrained scheduling
-// so it contributes to proceeding and to finally have an empty avlist
-void Scheduler::AdvanceCurrCycle(scheduling_direction_t dir, size_t &curr_cycle) {
+// when no node was selected from the avlist, advance to the next cycle at which something may change:
+// a pending node completes, or a resource of a parked node may have become available;
+// the cycles in between are skipped, so the time taken doesn't depend on the number of cycles
+// (e.g. behind a long measurement or wait) but only on the number of nodes
+void Scheduler::AdvanceCurrCycle(const avlist_t &avlist, scheduling_direction_t dir, size_t &curr_cycle) {
+    size_t next_cycle = (forward_scheduling == dir ? MAX_CYCLE : 0);
+    auto consider = [&](const std::multimap<size_t,size_t> &m) {
+        if (!m.empty()) {
+            if (forward_scheduling == dir) {
+                next_cycle = std::min(next_cycle, m.begin()->first);
+            } else {
+                next_cycle = std::max(next_cycle, m.rbegin()->first);
+            }
+        }
+    };
+    consider(avlist.pending);
+    for (auto &p : avlist.parked) {
+        consider(p);
+    }
+
+    // at least one cycle further, as before
     if (forward_scheduling == dir) {
-        curr_cycle++;
+        curr_cycle = std::max(curr_cycle + 1, next_cycle);
     } else {
-        curr_cycle--;
+        curr_cycle = std::min(curr_cycle - 1, next_cycle);
     }
 }
 
@@ -901,14 +987,15 @@ void Scheduler::AdvanceCurrCycle(scheduling_direction_t dir, size_t &curr_cycle)
 // return true when immediately schedulable
 // when returning false, isres indicates whether resource occupation was the reason or operand completion (for debugging)
 bool Scheduler::immediately_schedulable(
-    lemon::ListDigraph::Node n,
+    size_t n,
     scheduling_direction_t dir,
     const size_t curr_cycle,
     const quantum_platform& platform,
     arch::resource_manager_t &rm,
-    bool &isres
+    bool &isres,
+    size_t &r
 ) {
-    gate *gp = instruction[n];
+    gate *gp = graph.instruction[n];
     isres = true;
     // have dependent gates completed at curr_cycle?
     if (
@@ -924,10 +1011,11 @@ bool Scheduler::immediately_schedulable(
             ) {
             return true;
         }
-        if (rm.available(curr_cycle, gp, platform)) {
+        r = rm.first_unavailable(curr_cycle, gp, platform);
+        if (r == rm.resource_count()) {
             return true;
         }
-        isres = true;;
+        isres = true;
         return false;
     } else {
         isres = false;
@@ -937,8 +1025,8 @@ bool Scheduler::immediately_schedulable(
 
 // select a node from the avlist
 // the avlist is deep-ordered from high to low criticality (see criticality_lessthan above)
-lemon::ListDigraph::Node Scheduler::SelectAvailable(
-    std::list<lemon::ListDigraph::Node> &avlist,
+size_t Scheduler::SelectAvailable(
+    avlist_t &avlist,
     scheduling_direction_t dir,
     const size_t curr_cycle,
     const quantum_platform &platform,
@@ -947,22 +1035,49 @@ lemon::ListDigraph::Node Scheduler::SelectAvailable(
 ) {
     success = false;                        // whether a node was found and returned
 
+    // nodes in m that may be schedulable in curr_cycle become ready
+    auto make_ready = [&](std::multimap<size_t,size_t> &m) {
+        while (!m.empty()) {
+            auto it = (forward_scheduling == dir ? m.begin() : std::prev(m.end()));
+            if (forward_scheduling == dir ? it->first > curr_cycle : it->first < curr_cycle) {
+                break;
+            }
+            avlist.ready[avlist.key(it->second)] = it->second;
+            m.erase(it);
+        }
+    };
+    make_ready(avlist.pending);
+    for (auto &p : avlist.parked) {
+        make_ready(p);
+    }
+
     DOUT("avlist(@" << curr_cycle << "):");
-    for (auto n : avlist) {
-        DOUT("...... node(@" << instruction[n]->cycle << "): " << name[n] << " remaining: " << remaining[n]);
+    for (auto &rn : avlist.ready) {
+        size_t n = rn.second;
+        DOUT("...... node(@" << graph.instruction[n]->cycle << "): " << graph.instruction[n]->qasm() << " remaining: " << remaining[n]);
     }
 
     // select the first immediately schedulable, if any
-    // since avlist is deep-criticality ordered, highest first, the first is the most deep-critical
-    for (auto n : avlist) {
+    // since avlist.ready is deep-criticality ordered, highest first, the first is the most deep-critical;
+    // the ones waiting for a resource are parked on it, from this cycle on
+    // until the cycle that it may be available, which is at least the next one
+    for (auto it = avlist.ready.begin(); it != avlist.ready.end(); ) {
+        size_t n = it->second;
         bool isres;
-        if (immediately_schedulable(n, dir, curr_cycle, platform, rm, isres)) {
-            DOUT("... node (@" << instruction[n]->cycle << "): " << name[n] << " immediately schedulable, remaining=" << remaining[n] << ", selected");
+        size_t r;
+        if (immediately_schedulable(n, dir, curr_cycle, platform, rm, isres, r)) {
+            DOUT("... node (@" << graph.instruction[n]->cycle << "): " << graph.instruction[n]->qasm() << " immediately schedulable, remaining=" << remaining[n] << ", selected");
             success = true;
             return n;
-        } else {
-            DOUT("... node (@" << instruction[n]->cycle << "): " << name[n] << " remaining=" << remaining[n] << ", waiting for " << (isres? "resource" : "dependent completion"));
         }
+        DOUT("... node (@" << graph.instruction[n]->cycle << "): " << graph.instruction[n]->qasm() << " remaining=" << remaining[n] << ", waiting for " << (isres? "resource" : "dependent completion"));
+        ASSERT(isres);                      // only completed nodes are ready
+        size_t next_cycle = rm.next_available_cycle(r, curr_cycle, graph.instruction[n], platform);
+        if (r >= avlist.parked.size()) {
+            avlist.parked.resize(r+1);
+        }
+        avlist.parked[r].insert(std::make_pair(next_cycle, n));
+        it = avlist.ready.erase(it);
     }
 
     success = false;
@@ -981,41 +1096,38 @@ void Scheduler::schedule(
     circuit *circp,
     scheduling_direction_t dir,
     const quantum_platform &platform,
-    arch::resource_manager_t &rm,
-    std::string &sched_dot
+    arch::resource_manager_t &rm
 ) {
     DOUT("Scheduling " << (forward_scheduling == dir?"ASAP":"ALAP") << " with RC ...");
 
-    // scheduled[gp] :=: whether gate *gp has been scheduled, init all false
-    std::map<gate*, bool> scheduled;
-    // avlist :=: list of schedulable nodes, initially (see below) just s or t
-    std::list<lemon::ListDigraph::Node> avlist;
+    // scheduled[n] :=: whether node n has been scheduled, init all false, including SOURCE/SINK
+    std::vector<bool> scheduled(graph.NumNodes(), false);
+    // avlist :=: the schedulable nodes, initially (see below) just s or t
+    avlist_t avlist;
 
     // initializations for this scheduler
     // note that dependence graph is not modified by a scheduler, so it can be reused
     DOUT("... initialization");
-    for (lemon::ListDigraph::NodeIt n(graph); n != lemon::INVALID; ++n) {
-        scheduled[instruction[n]] = false;   // none were scheduled, including SOURCE/SINK
-    }
+    set_remaining(dir);         // for each gate, number of cycles until end of schedule
+    rank_criticality(dir, avlist.critrank);     // and its deep-criticality
     size_t  curr_cycle;         // current cycle for which instructions are sought
     init_available(avlist, dir, curr_cycle);     // first node (SOURCE/SINK) is made available and curr_cycle set
-    set_remaining(dir);         // for each gate, number of cycles until end of schedule
 
     DOUT("... loop over avlist until it is empty");
     while (!avlist.empty()) {
         bool success;
-        lemon::ListDigraph::Node selected_node;
+        size_t selected_node;
 
         selected_node = SelectAvailable(avlist, dir, curr_cycle, platform, rm, success);
         if (!success) {
             // i.e. none from avlist was found suitable to schedule in this cycle
-            AdvanceCurrCycle(dir, curr_cycle);
+            AdvanceCurrCycle(avlist, dir, curr_cycle);
             // so try again; eventually instrs complete and machine is empty
             continue;
         }
 
         // commit selected_node to the schedule
-        gate* gp = instruction[selected_node];
+        gate* gp = graph.instruction[selected_node];
         DOUT("... selected " << gp->qasm() << " in cycle " << curr_cycle);
         gp->cycle = curr_cycle;                     // scheduler result, including s and t
         if (
@@ -1036,23 +1148,17 @@ void Scheduler::schedule(
 
     if (dir == backward_scheduling) {
         // readjust cycle values of gates so that SOURCE is at 0
-        size_t SOURCECycle = instruction[s]->cycle;
+        size_t SOURCECycle = graph.instruction[s]->cycle;
         DOUT("... readjusting cycle values by -" << SOURCECycle);
 
-        instruction[t]->cycle -= SOURCECycle;
+        graph.instruction[t]->cycle -= SOURCECycle;
         for (auto & gp : *circp) {
             gp->cycle -= SOURCECycle;
         }
-        instruction[s]->cycle -= SOURCECycle;   // i.e. becomes 0
+        graph.instruction[s]->cycle -= SOURCECycle;   // i.e. becomes 0
     }
     // FIXME HvS cycles_valid now
 
-    if (options::get("print_dot_graphs") == "yes") {
-        std::stringstream ssdot;
-        get_dot(false, true, ssdot);
-        sched_dot = ssdot.str();
-    }
-
     // end scheduling
 
     DOUT("Scheduling " << (forward_scheduling == dir?"ASAP":"ALAP") << " with RC [DONE]");
@@ -1060,21 +1166,19 @@ void Scheduler::schedule(
 
 void Scheduler::schedule_asap(
     arch::resource_manager_t &rm,
-    const quantum_platform &platform,
-    std::string &sched_dot
+    const quantum_platform &platform
 ) {
     DOUT("Scheduling ASAP");
-    schedule(circp, forward_scheduling, platform, rm, sched_dot);
+    schedule(circp, forward_scheduling, platform, rm);
     DOUT("Scheduling ASAP [DONE]");
 }
 
 void Scheduler::schedule_alap(
     arch::resource_manager_t &rm,
-    const quantum_platform &platform,
-    std::string &sched_dot
+    const quantum_platform &platform
 ) {
     DOUT("Scheduling ALAP");
-    schedule(circp, backward_scheduling, platform, rm, sched_dot);
+    schedule(circp, backward_scheduling, platform, rm);
     DOUT("Scheduling ALAP [DONE]");
 }
 
@@ -1086,8 +1190,9 @@ void Scheduler::schedule_alap_uniform() {
     // - dependency analysis in article figure 2 is O(n^2) because of set union
     //   this has been left out, using our own linear dependency analysis creating a digraph
     //   and using the alap values as measure instead of the dep set size computed in article's D[n]
-    // - balanced scheduling algorithm dominates with its O(n^2) when it cannot find a node to forward
-    //   no test has been devised yet to break the loop (figure 3, line 14-35)
+    // - balanced scheduling algorithm (figure 3, line 14-35) scans the bundles backward for a node to forward;
+    //   this is O(n^2) when it cannot find one, so instead an index of candidate nodes is maintained,
+    //   bounded by each node's latest allowed cycle; see below; this makes it O(n log n)
     // - targeted bundle size is adjusted each cycle and is number_of_gates_to_go/number_of_non_empty_bundles_to_go
     //   this is more greedy, preventing oscillation around a target size based on all bundles,
     //   because local variations caused by local dep chains create small bundles and thus leave more gates still to go
@@ -1109,7 +1214,7 @@ void Scheduler::schedule_alap_uniform() {
     // SOURCE (node s) is at cycle 0 and the first circuit's gates are at cycle 1.
     // SINK (node t) is at the earliest cycle that all gates/operations have completed.
     set_cycle(forward_scheduling);
-    size_t cycle_count = instruction[t]->cycle - 1;
+    size_t cycle_count = graph.instruction[t]->cycle - 1;
     // so SOURCE at cycle 0, then all circuit's gates at cycles 1 to cycle_count, and finally SINK at cycle cycle_count+1
 
     // compute remaining which is the opposite of the alap cycle value (remaining[node] :=: SINK->cycle - alapcycle[node])
@@ -1118,11 +1223,12 @@ void Scheduler::schedule_alap_uniform() {
     set_remaining(forward_scheduling);
 
     // DOUT("Creating gates_per_cycle");
-    // create gates_per_cycle[cycle] = for each cycle the list of gates at cycle cycle
+    // create gates_per_cycle[cycle] = for each cycle the number of gates at cycle cycle
     // this is the basic map to be operated upon by the uniforming scheduler below;
-    std::map<size_t,std::list<gate*>> gates_per_cycle;
+    // the gates themselves are found through the candidate index, so only the bundle sizes are kept
+    std::vector<size_t> gates_per_cycle(cycle_count+2, 0);
     for (auto gp : *circp) {
-        gates_per_cycle[gp->cycle].push_back(gp);
+        gates_per_cycle[gp->cycle]++;
     }
 
     // DOUT("Displaying circuit and bundle statistics");
@@ -1134,11 +1240,11 @@ void Scheduler::schedule_alap_uniform() {
     size_t non_empty_bundle_count = 0;
     size_t gate_count = 0;
     for (size_t curr_cycle = 1; curr_cycle <= cycle_count; curr_cycle++) {
-        max_gates_per_cycle = std::max(max_gates_per_cycle, gates_per_cycle[curr_cycle].size());
-        if (int(gates_per_cycle[curr_cycle].size()) != 0) {
+        max_gates_per_cycle = std::max(max_gates_per_cycle, gates_per_cycle[curr_cycle]);
+        if (gates_per_cycle[curr_cycle] != 0) {
             non_empty_bundle_count++;
         }
-        gate_count += gates_per_cycle[curr_cycle].size();
+        gate_count += gates_per_cycle[curr_cycle];
     }
     double avg_gates_per_cycle = double(gate_count)/cycle_count;
     double avg_gates_per_non_empty_cycle = double(gate_count)/non_empty_bundle_count;
@@ -1152,25 +1258,106 @@ void Scheduler::schedule_alap_uniform() {
                                         << "; avg_gates_per_non_empty_cycle=" << avg_gates_per_non_empty_cycle
     );
 
+    // The published algorithm scans the bundles backward from curr_cycle-1 down to 1 for a node that can be moved
+    // to curr_cycle, and within a bundle takes the one with lowest remaining (the first one in circuit order when equal);
+    // a node can be moved when its result, when moved, is ready before end-of-circuit and before used.
+    // Instead of scanning, a candidate index is kept of exactly those nodes that could be moved to curr_cycle,
+    // ordered as the scan would find them: on cycle descending, then on remaining, then on node (i.e. circuit) order.
+    //
+    // latest[n] is the highest cycle that node n can be moved to: the minimum of SINK's and its successors' cycles,
+    // minus its duration in cycles. Nodes only move to higher cycles, so latest[n] only grows and it changes only
+    // for the predecessors of a node that is moved.
+    // A node is a candidate for curr_cycle when its cycle < curr_cycle <= latest[node]. Since curr_cycle decreases,
+    // a node waits in bucket waiting[latest[node]] until curr_cycle comes down to its latest[node] (or is added
+    // immediately when a move increases latest[node] to curr_cycle or beyond); it is dropped from the index when it
+    // is moved or when curr_cycle comes down to its own cycle.
+    // A predecessor that becomes a candidate by a move has a cycle not higher than the moved node's old cycle,
+    // and the bundles between that cycle and curr_cycle don't contain candidates (or the scan would have moved them),
+    // so taking the first candidate of the index is what the scan would have done.
+    //
+    // A GROUP node is not in the circuit and is not moved itself; instead its cycle is kept at the minimum
+    // of its successors' cycles, so that its predecessors get the latest[n] they would get without it.
+    //
+    // Each node enters and leaves the index at most once, and each move updates latest of the node's predecessors,
+    // so the scan below takes at most cycle_count + n iterations, each O(log n), with n the number of nodes.
+    std::vector<bool> is_group_node(graph.NumNodes(), false);
+    std::vector<size_t> duration_in_cycles(graph.NumNodes(), 0);
+    std::vector<long> latest(graph.NumNodes(), 0);      // signed because can become negative
+    std::vector<bool> is_candidate(graph.NumNodes(), false);
+    std::vector<bool> is_done(graph.NumNodes(), false); // moved or passed by curr_cycle
+    std::vector<std::vector<size_t>> waiting(cycle_count+1);
+    std::set<std::tuple<size_t,size_t,size_t>> candidates; // (cycle_count - cycle, remaining, node)
+
+    auto compute_latest = [&](size_t n) {
+        long latest_completion = cycle_count + 1;     // at SINK is ok, later not
+        for (size_t a = graph.succBegin[n]; a < graph.succBegin[n+1]; a++) {
+            latest_completion = std::min(latest_completion, long(graph.instruction[graph.succNode[a]]->cycle));
+        }
+        return latest_completion - long(duration_in_cycles[n]);
+    };
+    auto make_candidate = [&](size_t n) {
+        is_candidate[n] = true;
+        candidates.insert(std::make_tuple(cycle_count - graph.instruction[n]->cycle, remaining[n], n));
+    };
+    auto update_latest = [&](size_t n, size_t curr_cycle) {
+        latest[n] = compute_latest(n);
+        if (latest[n] >= long(curr_cycle)) {
+            make_candidate(n);
+        } else if (latest[n] >= 1) {
+            waiting[latest[n]].push_back(n);
+        }
+    };
+
+    // the predecessors of a moved node may move further now;
+    // a GROUP predecessor follows and passes this on to its own predecessors
+    auto update_preds = [&](size_t n, size_t curr_cycle) {
+        std::vector<size_t> todo(1, n);
+        while (!todo.empty()) {
+            size_t m = todo.back();
+            todo.pop_back();
+            for (size_t a = graph.predBegin[m]; a < graph.predBegin[m+1]; a++) {
+                size_t pred_node = graph.predNode[a];
+                if (pred_node == s) {
+                    continue;
+                }
+                if (is_group_node[pred_node]) {
+                    size_t group_cycle = compute_latest(pred_node);
+                    if (group_cycle != graph.instruction[pred_node]->cycle) {
+                        graph.instruction[pred_node]->cycle = group_cycle;
+                        todo.push_back(pred_node);
+                    }
+                } else if (!is_candidate[pred_node] && !is_done[pred_node]) {
+                    update_latest(pred_node, curr_cycle);
+                }
+            }
+        }
+    };
+
+    for (size_t n = s+1; n < t; n++) {
+        is_group_node[n] = is_group(n);
+        is_done[n] = is_group_node[n];
+        duration_in_cycles[n] = size_t(std::ceil(static_cast<float>(graph.instruction[n]->duration)/cycle_time));
+    }
+    for (size_t n = t; n-- > s+1; ) {
+        if (is_group_node[n]) {
+            graph.instruction[n]->cycle = compute_latest(n);
+        }
+    }
+    for (size_t n = s+1; n < t; n++) {
+        if (!is_group_node[n]) {
+            update_latest(n, cycle_count);
+        }
+    }
+
     // in a backward scan, make non-empty bundles max avg_gates_per_non_empty_cycle long;
     // an earlier version of the algorithm aimed at making bundles max avg_gates_per_cycle long
     // but that flawed because of frequent empty bundles causing this estimate for a uniform length being too low
     // DOUT("Backward scan uniform scheduling");
     for (size_t curr_cycle = cycle_count; curr_cycle >= 1; curr_cycle--) {
-        // Backward with pred_cycle from curr_cycle-1 down to 1, look for node(s) to fill up current too small bundle.
+        // Look for node(s) to fill up current too small bundle.
         // After an iteration at cycle curr_cycle, all bundles from curr_cycle to cycle_count have been filled up,
         // and all bundles from 1 to curr_cycle-1 still have to be done.
         // This assumes that current bundle is never too long, excess having been moved away earlier, as ASAP does.
-        // When such a node cannot be found, this loop scans the whole circuit for each original node to fill up
-        // and this creates a O(n^2) time complexity.
-        //
-        // A test to break this prematurely based on the current data structure, wasn't devised yet.
-        // A solution is to use the dep graph instead to find a node to fill up the current node,
-        // i.e. maintain a so-called "available list" of nodes free to schedule, as in the non-uniform scheduling algorithm,
-        // which is not hard at all but which is not according to the published algorithm.
-        // When the complexity becomes a problem, it is proposed to rewrite the algorithm accordingly.
-
-        long pred_cycle = curr_cycle - 1;    // signed because can become negative
 
         // target size of each bundle is number of gates still to go divided by number of non-empty cycles to go
         // it averages over non-empty bundles instead of all bundles because the latter would be very strict
@@ -1178,86 +1365,67 @@ void Scheduler::schedule_alap_uniform() {
         if (non_empty_bundle_count == 0) break;     // nothing to do
         avg_gates_per_cycle = double(gate_count)/curr_cycle;
         avg_gates_per_non_empty_cycle = double(gate_count)/non_empty_bundle_count;
-        DOUT("Cycle=" << curr_cycle << " number of gates=" << gates_per_cycle[curr_cycle].size()
+        DOUT("Cycle=" << curr_cycle << " number of gates=" << gates_per_cycle[curr_cycle]
                       << "; avg_gates_per_cycle=" << avg_gates_per_cycle
                       << "; avg_gates_per_non_empty_cycle=" << avg_gates_per_non_empty_cycle);
 
-        while (double(gates_per_cycle[curr_cycle].size()) < avg_gates_per_non_empty_cycle && pred_cycle >= 1) {
-            DOUT("pred_cycle=" << pred_cycle);
-            DOUT("gates_per_cycle[curr_cycle].size()=" << gates_per_cycle[curr_cycle].size());
-            size_t min_remaining_cycle = MAX_CYCLE;
-            gate *best_predgp;
-            bool best_predgp_found = false;
-
-            // scan bundle at pred_cycle to find suitable candidate to move forward to curr_cycle
-            for (auto predgp : gates_per_cycle[pred_cycle]) {
-                bool forward_predgp = true;
-                size_t predgp_completion_cycle;
-                lemon::ListDigraph::Node pred_node = node[predgp];
-                DOUT("... considering: " << predgp->qasm() << " @cycle=" << predgp->cycle << " remaining=" << remaining[pred_node]);
-
-                // candidate's result, when moved, must be ready before end-of-circuit and before used
-                predgp_completion_cycle = curr_cycle + size_t(std::ceil(static_cast<float>(predgp->duration)/cycle_time));
-                // predgp_completion_cycle = curr_cycle + (predgp->duration+cycle_time-1)/cycle_time;
-                if (predgp_completion_cycle > cycle_count + 1) { // at SINK is ok, later not
-                    forward_predgp = false;
-                    DOUT("... ... rejected (after circuit): " << predgp->qasm() << " would complete @" << predgp_completion_cycle << " SINK @" << cycle_count+1);
-                } else {
-                    for (lemon::ListDigraph::OutArcIt arc(graph,pred_node); arc != lemon::INVALID; ++arc) {
-                        gate *target_gp = instruction[graph.target(arc)];
-                        size_t target_cycle = target_gp->cycle;
-                        if (predgp_completion_cycle > target_cycle) {
-                            forward_predgp = false;
-                            DOUT("... ... rejected (after succ): " << predgp->qasm() << " would complete @" << predgp_completion_cycle << " target=" << target_gp->qasm() << " target_cycle=" << target_cycle);
-                        }
-                    }
-                }
-
-                // when multiple nodes in bundle qualify, take the one with lowest remaining
-                // because that is the most critical one and thus deserves a cycle as high as possible (ALAP)
-                if (forward_predgp && remaining[pred_node] < min_remaining_cycle) {
-                    min_remaining_cycle = remaining[pred_node];
-                    best_predgp_found = true;
-                    best_predgp = predgp;
-                }
+        // nodes with latest cycle curr_cycle become candidates; skip stale entries
+        for (auto n : waiting[curr_cycle]) {
+            if (!is_candidate[n] && !is_done[n] && latest[n] == long(curr_cycle)) {
+                make_candidate(n);
             }
+        }
+        waiting[curr_cycle].clear();
 
-            // when candidate was found in this bundle, move it, and search for more in this bundle, if needed
-            // otherwise, continue scanning backward
-            if (best_predgp_found) {
-                // move predgp from pred_cycle to curr_cycle;
-                // adjust all bookkeeping that is affected by this
-                gates_per_cycle[pred_cycle].remove(best_predgp);
-                if (gates_per_cycle[pred_cycle].empty()) {
-                    // source bundle was non-empty, now it is empty
-                    non_empty_bundle_count--;
-                }
-                if (gates_per_cycle[curr_cycle].empty()) {
-                    // target bundle was empty, now it will be non_empty
-                    non_empty_bundle_count++;
-                }
-                best_predgp->cycle = curr_cycle;        // what it is all about
-                gates_per_cycle[curr_cycle].push_back(best_predgp);
-
-                // recompute targets
-                if (non_empty_bundle_count == 0) break;     // nothing to do
-                avg_gates_per_cycle = double(gate_count)/curr_cycle;
-                avg_gates_per_non_empty_cycle = double(gate_count)/non_empty_bundle_count;
-                DOUT("... moved " << best_predgp->qasm() << " with remaining=" << remaining[node[best_predgp]]
-                                  << " from cycle=" << pred_cycle << " to cycle=" << curr_cycle
-                                  << "; new avg_gates_per_cycle=" << avg_gates_per_cycle
-                                  << "; avg_gates_per_non_empty_cycle=" << avg_gates_per_non_empty_cycle
-                );
-            } else {
-                pred_cycle --;
+        while (double(gates_per_cycle[curr_cycle]) < avg_gates_per_non_empty_cycle) {
+            // nodes at curr_cycle or higher cannot be moved anymore; they are first in the index
+            while (!candidates.empty() && std::get<0>(*candidates.begin()) <= cycle_count - curr_cycle) {
+                is_done[std::get<2>(*candidates.begin())] = true;
+                candidates.erase(candidates.begin());
+            }
+            if (candidates.empty()) break;      // no node can be moved to curr_cycle
+
+            // take the candidate with highest cycle and within that the lowest remaining
+            // because that is the most critical one and thus deserves a cycle as high as possible (ALAP)
+            size_t best_pred_node = std::get<2>(*candidates.begin());
+            candidates.erase(candidates.begin());
+            is_done[best_pred_node] = true;
+            gate *best_predgp = graph.instruction[best_pred_node];
+            size_t pred_cycle = best_predgp->cycle;
+
+            // move predgp from pred_cycle to curr_cycle;
+            // adjust all bookkeeping that is affected by this
+            gates_per_cycle[pred_cycle]--;
+            if (gates_per_cycle[pred_cycle] == 0) {
+                // source bundle was non-empty, now it is empty
+                non_empty_bundle_count--;
+            }
+            if (gates_per_cycle[curr_cycle] == 0) {
+                // target bundle was empty, now it will be non_empty
+                non_empty_bundle_count++;
             }
-        }   // end for finding a bundle to forward a node from to the current cycle
+            best_predgp->cycle = curr_cycle;        // what it is all about
+            gates_per_cycle[curr_cycle]++;
+
+            // the move may allow its predecessors to move further
+            update_preds(best_pred_node, curr_cycle);
+
+            // recompute targets
+            if (non_empty_bundle_count == 0) break;     // nothing to do
+            avg_gates_per_cycle = double(gate_count)/curr_cycle;
+            avg_gates_per_non_empty_cycle = double(gate_count)/non_empty_bundle_count;
+            DOUT("... moved " << best_predgp->qasm() << " with remaining=" << remaining[best_pred_node]
+                              << " from cycle=" << pred_cycle << " to cycle=" << curr_cycle
+                              << "; new avg_gates_per_cycle=" << avg_gates_per_cycle
+                              << "; avg_gates_per_non_empty_cycle=" << avg_gates_per_non_empty_cycle
+            );
+        }   // end for finding a node to forward to the current cycle
 
         // curr_cycle ready, recompute counts for remaining cycles
         // mask current cycle and its gates from the target counts:
         // - gate_count, non_empty_bundle_count, curr_cycle (as cycles still to go)
-        gate_count -= gates_per_cycle[curr_cycle].size();
-        if (gates_per_cycle[curr_cycle].size() != 0) {
+        gate_count -= gates_per_cycle[curr_cycle];
+        if (gates_per_cycle[curr_cycle] != 0) {
             // bundle is non-empty
             non_empty_bundle_count--;
         }
@@ -1273,11 +1441,11 @@ void Scheduler::schedule_alap_uniform() {
     gate_count = 0;
     // cycle_count was not changed
     for (size_t curr_cycle = 1; curr_cycle <= cycle_count; curr_cycle++) {
-        max_gates_per_cycle = std::max(max_gates_per_cycle, gates_per_cycle[curr_cycle].size());
-        if (int(gates_per_cycle[curr_cycle].size()) != 0) {
+        max_gates_per_cycle = std::max(max_gates_per_cycle, gates_per_cycle[curr_cycle]);
+        if (gates_per_cycle[curr_cycle] != 0) {
             non_empty_bundle_count++;
         }
-        gate_count += gates_per_cycle[curr_cycle].size();
+        gate_count += gates_per_cycle[curr_cycle];
     }
     avg_gates_per_cycle = double(gate_count)/cycle_count;
     avg_gates_per_non_empty_cycle = double(gate_count)/non_empty_bundle_count;
@@ -1301,19 +1469,9 @@ void Scheduler::get_dot(
     std::ostream &dotout
 ) {
     DOUT("Get_dot");
-    lemon::Path<lemon::ListDigraph> p;
-    lemon::ListDigraph::ArcMap<bool> isInCritical{graph};
-    if (WithCritical) {
-        for (lemon::ListDigraph::ArcIt a(graph); a != lemon::INVALID; ++a) {
-            isInCritical[a] = false;
-            for (lemon::Path<lemon::ListDigraph>::ArcIt ap(p); ap != lemon::INVALID; ++ap) {
-                if (a == ap) {
-                    isInCritical[a] = true;
-                    break;
-                }
-            }
-        }
-    }
+    // isInCritical[a] :=: whether arc a (an index in the succ arrays) is on a critical path;
+    // no critical path is computed (yet), so no arc is highlighted
+    std::vector<bool> isInCritical(graph.NumArcs(), false);
 
     std::string NodeStyle(" fontcolor=black, style=filled, fontsize=16");
     std::string EdgeStyle1(" color=black");
@@ -1324,10 +1482,10 @@ void Scheduler::get_dot(
            << "\nedge [fontsize=16, arrowhead=vee, arrowsize=0.5];"
            << std::endl;
 
-    // first print the nodes
-    for (lemon::ListDigraph::NodeIt n(graph); n != lemon::INVALID; ++n) {
-        dotout  << "\"" << graph.id(n) << "\""
-                << " [label=\" " << name[n] <<" \""
+    // first print the nodes, last created first
+    for (size_t n = graph.NumNodes(); n-- > 0; ) {
+        dotout  << "\"" << n << "\""
+                << " [label=\" " << graph.instruction[n]->qasm() <<" \""
                 << NodeStyle
                 << "];" << std::endl;
     }
@@ -1351,57 +1509,92 @@ void Scheduler::get_dot(
         dotout << ";\n}\n";
 
         // Now print ranks, as shown below
-        dotout << "{ rank=same; Cycle" << instruction[s]->cycle <<"; " << graph.id(s) << "; }\n";
+        dotout << "{ rank=same; Cycle" << graph.instruction[s]->cycle <<"; " << s << "; }\n";
         for (auto gp : *circp) {
-            dotout << "{ rank=same; Cycle" << gp->cycle <<"; " << graph.id(node[gp]) << "; }\n";
+            dotout << "{ rank=same; Cycle" << gp->cycle <<"; " << node[gp] << "; }\n";
         }
-        dotout << "{ rank=same; Cycle" << instruction[t]->cycle <<"; " << graph.id(t) << "; }\n";
+        dotout << "{ rank=same; Cycle" << graph.instruction[t]->cycle <<"; " << t << "; }\n";
     }
 
-    // now print the edges
-    for (lemon::ListDigraph::ArcIt arc(graph); arc != lemon::INVALID; ++arc) {
-        auto srcNode = graph.source(arc);
-        auto dstNode = graph.target(arc);
-        int srcID = graph.id( srcNode );
-        int dstID = graph.id( dstNode );
+    // now print the edges, grouped by source node, last created first
+    for (size_t srcID = graph.NumNodes(); srcID-- > 0; ) {
+        for (size_t arc = graph.succBegin[srcID]; arc < graph.succBegin[srcID+1]; arc++) {
+            size_t dstID = graph.succNode[arc];
 
-        if (WithCritical) {
-            EdgeStyle = (isInCritical[arc] == true) ? EdgeStyle2 : EdgeStyle1;
-        }
+            if (WithCritical) {
+                EdgeStyle = (isInCritical[arc] == true) ? EdgeStyle2 : EdgeStyle1;
+            }
 
-        dotout << std::dec
-               << "\"" << srcID << "\""
-               << "->"
-               << "\"" << dstID << "\""
-               << "[ label=\""
-               << "q" << cause[arc]
-               << " , " << weight[arc]
-               << " , " << DepTypesNames[ depType[arc] ]
-               <<"\""
-               << " " << EdgeStyle << " "
-               << "]"
-               << std::endl;
+            dotout << std::dec
+                   << "\"" << srcID << "\""
+                   << "->"
+                   << "\"" << dstID << "\""
+                   << "[ label=\""
+                   << "q" << graph.succCause[arc]
+                   << " , " << graph.succWeight[arc]
+                   << " , " << DepTypesNames[ graph.succDepType[arc] ]
+                   <<"\""
+                   << " " << EdgeStyle << " "
+                   << "]"
+                   << std::endl;
+        }
     }
 
     dotout << "}" << std::endl;
     DOUT("Get_dot[DONE]");
 }
 
-void Scheduler::get_dot(std::string &dot) {
-    set_cycle(forward_scheduling);
-    sort_by_cycle(circp);
+// write the dot of the dependence graph to file fname, streaming it instead of first building it in memory;
+// with asap, the cycles shown are those of an ASAP schedule, which then also orders the circuit,
+// otherwise they are the gates' current cycles, e.g. those of a schedule just done
+void Scheduler::write_dot(const std::string &fname, bool asap) {
+    if (asap) {
+        set_cycle(forward_scheduling);
+        sort_by_cycle(circp);
+    }
 
-    std::stringstream ssdot;
-    get_dot(false, true, ssdot);
-    dot = ssdot.str();
+    std::ofstream dotout(fname);
+    if (dotout.fail()) {
+        EOUT("opening file " << fname << std::endl
+                             << "Make sure the output directory ("<< options::get("output_dir") << ") exists");
+        return;
+    }
+    get_dot(false, true, dotout);
+}
+
+// whether the dot files of the dependence graph of kernel kernelname are to be written:
+// print_dot_graphs must be yes, print_dot_kernels must select the kernel (a comma separated list of names, or all)
+// and the graph must not have more nodes than print_dot_maxnodes; this bounds the time and space they take,
+// so that they can stay enabled for big programs
+bool Scheduler::print_dot_enabled(const std::string &kernelname) const {
+    if (options::get("print_dot_graphs") != "yes") {
+        return false;
+    }
+    std::string kernelsopt = options::get("print_dot_kernels");
+    if (kernelsopt != "all") {
+        bool selected = false;
+        std::stringstream ss(kernelsopt);
+        std::string name;
+        while (std::getline(ss, name, ',')) {
+            selected = selected || name == kernelname;
+        }
+        if (!selected) {
+            return false;
+        }
+    }
+    std::string maxnodesopt = options::get("print_dot_maxnodes");
+    if (maxnodesopt != "inf" && graph.NumNodes() > size_t(atol(maxnodesopt.c_str()))) {
+        IOUT("not writing dot files of kernel " << kernelname << ": its dependence graph has " << graph.NumNodes()
+             << " nodes, more than print_dot_maxnodes=" << maxnodesopt);
+        return false;
+    }
+    return true;
 }
 
 // schedule support for program.h::schedule()
 void schedule_kernel(
     quantum_kernel &kernel,
-    const quantum_platform &platform,
-    std::string &dot,
-    std::string &sched_dot
+    const quantum_platform &platform
 ) {
     std::string scheduler = options::get("scheduler");
     std::string scheduler_uniform = options::get("scheduler_uniform");
@@ -1411,19 +1604,30 @@ void schedule_kernel(
     Scheduler sched;
     sched.init(kernel.c, platform, kernel.qubit_count, kernel.creg_count);
 
-    if (options::get("print_dot_graphs") == "yes") {
-        sched.get_dot(dot);
+    bool print_dot = sched.print_dot_enabled(kernel.name);
+    if (print_dot) {
+        std::string fname = options::get("output_dir") + "/" + kernel.get_name() + "_dependence_graph";
+        IOUT("writing dependence graph dot file to '" << fname << ".dot' ...");
+        sched.write_dot(fname + ".dot", true);
+        IOUT("writing dependence graph lists to '" << fname << ".lgf' ...");
+        sched.write_dependence_list(fname + ".lgf");
     }
 
     if (scheduler_uniform == "yes") {
         sched.schedule_alap_uniform(); // result in current kernel's circuit (k.c)
     } else if (scheduler == "ASAP") {
-        sched.schedule_asap(sched_dot); // result in current kernel's circuit (k.c)
+        sched.schedule_asap(); // result in current kernel's circuit (k.c)
     } else if (scheduler == "ALAP") {
-        sched.schedule_alap(sched_dot); // result in current kernel's circuit (k.c)
+        sched.schedule_alap(); // result in current kernel's circuit (k.c)
     } else {
         FATAL("Not supported scheduler option: scheduler=" << scheduler);
     }
+
+    if (print_dot) {
+        std::string fname = options::get("output_dir") + "/" + kernel.get_name() + scheduler + "_scheduled.dot";
+        IOUT("writing scheduled dot to '" << fname << "' ...");
+        sched.write_dot(fname, false);
+    }
     DOUT(scheduler << " scheduling the quantum kernel '" << kernel.name << "' DONE");
     kernel.cycles_valid = true;
 }
@@ -1441,23 +1645,9 @@ void schedule(
         report_qasm(programp, platform, "in", passname);
 
         IOUT("scheduling the quantum program");
-        for (auto &k : programp->kernels) {
-            std::string dot;
-            std::string kernel_sched_dot;
-            schedule_kernel(k, platform, dot, kernel_sched_dot);
-
-            if (options::get("print_dot_graphs") == "yes") {
-                std::string fname;
-                fname = options::get("output_dir") + "/" + k.get_name() + "_dependence_graph.dot";
-                IOUT("writing scheduled dot to '" << fname << "' ...");
-                utils::write_file(fname, dot);
-
-                std::string scheduler_opt = options::get("scheduler");
-                fname = options::get("output_dir") + "/" + k.get_name() + scheduler_opt + "_scheduled.dot";
-                IOUT("writing scheduled dot to '" << fname << "' ...");
-                utils::write_file(fname, kernel_sched_dot);
-            }
-        }
+        for_each_kernel(programp, [&platform](quantum_kernel &k) {
+            schedule_kernel(k, platform);
+        });
 
         report_statistics(programp, platform, "out", passname, "# ");
         report_qasm(programp, platform, "out", passname);
@@ -1467,27 +1657,31 @@ void schedule(
 void rcschedule_kernel(
     quantum_kernel &kernel,
     const quantum_platform &platform,
-    std::string &dot,
+    const std::string &passname,
     size_t nqubits,
     size_t ncreg
 ) {
     IOUT("Resource constraint scheduling ...");
 
     std::string schedopt = options::get("scheduler");
+    if (schedopt != "ASAP" && schedopt != "ALAP") {
+        FATAL("Not supported scheduler option: scheduler=" << schedopt);
+    }
+    Scheduler sched;
+    sched.init(kernel.c, platform, nqubits, ncreg);
     if (schedopt == "ASAP") {
-        Scheduler sched;
-        sched.init(kernel.c, platform, nqubits, ncreg);
-
         arch::resource_manager_t rm(platform, forward_scheduling);
-        sched.schedule_asap(rm, platform, dot);
-    } else if (schedopt == "ALAP") {
-        Scheduler sched;
-        sched.init(kernel.c, platform, nqubits, ncreg);
-
-        arch::resource_manager_t rm(platform, backward_scheduling);
-        sched.schedule_alap(rm, platform, dot);
+        sched.schedule_asap(rm, platform);
     } else {
-        FATAL("Not supported scheduler option: scheduler=" << schedopt);
+        arch::resource_manager_t rm(platform, backward_scheduling);
+        sched.schedule_alap(rm, platform);
+    }
+
+    if (sched.print_dot_enabled(kernel.name)) {
+        std::stringstream fname;
+        fname << options::get("output_dir") << "/" << kernel.name << "_" << passname << ".dot";
+        IOUT("writing " << passname << " dependence graph dot file to '" << fname.str() << "' ...");
+        sched.write_dot(fname.str(), false);
     }
 
     IOUT("Resource constraint scheduling [Done].");
@@ -1504,23 +1698,15 @@ void rcschedule(
     report_statistics(programp, platform, "in", passname, "# ");
     report_qasm(programp, platform, "in", passname);
 
-    for (auto &kernel : programp->kernels) {
+    for_each_kernel(programp, [&platform, &passname](quantum_kernel &kernel) {
         IOUT("Scheduling kernel: " << kernel.name);
         if (!kernel.c.empty()) {
             auto num_creg = kernel.creg_count;
-            std::string sched_dot;
 
-            rcschedule_kernel(kernel, platform, sched_dot, platform.qubit_number, num_creg);
+            rcschedule_kernel(kernel, platform, passname, platform.qubit_number, num_creg);
             kernel.cycles_valid = true; // FIXME HvS move this back into call to right after sort_cycle
-
-            if (options::get("print_dot_graphs") == "yes") {
-                std::stringstream fname;
-                fname << options::get("output_dir") << "/" << kernel.name << "_" << passname << ".dot";
-                IOUT("writing " << passname << " dependence graph dot file to '" << fname.str() << "' ...");
-                utils::write_file(fname.str(), sched_dot);
-            }
         }
-    }
+    });
 
     report_statistics(programp, platform, "out", passname, "# ");
     report_qasm(programp, platform, "out", passname);
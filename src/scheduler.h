@@ -46,6 +46,14 @@
     the respective commutatable gates are sequentialized according to the original circuit's order.
     With all 'no's replaced by '/', all event types become equivalent (i.e. as if they were Write).
 
+    The gates with R (or D) events on a qubit since its last W are kept as a group, and a next event
+    on that qubit gets a dependence on each of them; when also RAR (or DAD) dependences are created,
+    each gate in the group depends on all previous ones.
+    To keep the number of dependences linear in the number of gates, a group is not allowed to grow
+    beyond COMMUTE_GROUP_MAX gates: then a GROUP node is added which depends on all gates in the group,
+    and which replaces them in the group; a GROUP node is not in the circuit, and has duration 0.
+    With this, the constraints on the gates' cycles are exactly the same as with dependences on the gates in the group.
+
     Schedulers come essentially in the following forms:
     - ASAP: a plain forward scheduler using dependences only, aiming at execution each gate as soon as possible
     - ASAP with resource constraints: similar but taking resource constraints of the gates of the platform into account
@@ -59,11 +67,12 @@
     It is enabled by option "scheduler_commute".
  */
 
-#include <lemon/list_graph.h>
-#include <lemon/lgf_reader.h>
-#include <lemon/lgf_writer.h>
-#include <lemon/dijkstra.h>
-#include <lemon/connectivity.h>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
 
 #include "options.h"
 #include "utils.h"
@@ -80,24 +89,103 @@ namespace ql {
 enum DepTypes{RAW, WAW, WAR, RAR, RAD, DAR, DAD, WAD, DAW};
 const std::string DepTypesNames[] = {"RAW", "WAW", "WAR", "RAR", "RAD", "DAR", "DAD", "WAD", "DAW"};
 
+// maximum number of gates in a group of commuting gates on a qubit before it is replaced by a GROUP node
+const size_t COMMUTE_GROUP_MAX = 8;
+
+// dependence graph, a DAG in compressed sparse row (CSR) form
+//
+// Nodes are dense indices 0..NumNodes()-1, given in the order of AddNode, i.e. in the order of the circuit;
+// SOURCE is first, SINK last, and a GROUP node directly follows the gate that filled up its group.
+// The arcs into node n are the arcs a with predBegin[n] <= a < predBegin[n+1] in the pred arrays,
+// the arcs out of node n are the arcs a with succBegin[n] <= a < succBegin[n+1] in the succ arrays;
+// each arc is in both, with its weight, cause and depType, so that walking the dependences in either direction
+// is a linear scan through contiguous memory.
+// The arcs of a node are ordered from most recently added to first added;
+// this is the order in which the schedulers always visited them, and their tie-breaking depends on it.
+//
+// The graph is built by AddNode/AddArc calls in a single pass over the circuit, followed by Finalize;
+// from then on it is immutable.
+class DepGraph {
+public:
+    std::vector<gate*>  instruction;    // instruction[n] == gate*
+
+    std::vector<size_t> predBegin;      // arcs into node n: predBegin[n] .. predBegin[n+1]-1
+    std::vector<size_t> predNode;       // predNode[a] == source node of arc a into n
+    std::vector<int>    predWeight;     // number of cycles of dependence
+    std::vector<int>    predCause;      // qubit/creg index of dependence
+    std::vector<int>    predDepType;    // RAW, WAW, ...
+
+    std::vector<size_t> succBegin;      // arcs out of node n: succBegin[n] .. succBegin[n+1]-1
+    std::vector<size_t> succNode;       // succNode[a] == target node of arc a out of n
+    std::vector<int>    succWeight;     // number of cycles of dependence
+    std::vector<int>    succCause;      // qubit/creg index of dependence
+    std::vector<int>    succDepType;    // RAW, WAW, ...
+
+    size_t NumNodes() const;
+    size_t NumArcs() const;
+
+    // add a node for gp; return its index
+    size_t AddNode(gate *gp);
+
+    // add an arc; the arcs must be added with non-decreasing tgt, as Scheduler::init does;
+    // the target is the node of the gate being added, the source a node of a previous gate
+    void AddArc(size_t src, size_t tgt, int weight, int cause, int depType);
+
+    // build the pred and succ arrays from the arcs added
+    void Finalize();
+
+private:
+    // arcs in the order of adding them, until Finalize
+    std::vector<size_t> arcSrc;
+    std::vector<size_t> arcTgt;
+    std::vector<int>    arcWeight;
+    std::vector<int>    arcCause;
+    std::vector<int>    arcDepType;
+};
+
+// available list of the list scheduler with RC (see Scheduler::schedule)
+//
+// A node is available when all nodes it depends on (in the scheduling direction) have been scheduled.
+// From then on it waits in one of:
+// - pending: for the nodes it depends on to complete, i.e. until curr_cycle reaches its cycle attribute;
+// - parked[r]: for resource r that was not available for it, until the cycle at which r may be (see resource_t);
+// - ready: to be selected.
+// ready is ordered on deep-criticality, highest first, and on the order of becoming available when equally critical,
+// which is the order in which the schedulers always considered the available nodes;
+// the criticality ranks are computed once (see Scheduler::rank_criticality), so this order is a simple key.
+// So a node blocked by a resource is not tested again each cycle but only when the resource may have freed up,
+// and curr_cycle can advance to the next cycle at which something might be scheduled.
+class avlist_t {
+public:
+    typedef std::pair<size_t,size_t> key_t;     // (critrank[n], seq[n])
+
+    std::vector<size_t> critrank;               // critrank[n] == rank of n in deep-criticality, 0 is most critical
+    std::vector<size_t> seq;                    // seq[n] == sequence number of n becoming available
+    size_t              nextseq;
+
+    std::map<key_t,size_t> ready;               // ready nodes, in the order of selection
+    std::multimap<size_t,size_t> pending;       // cycle -> node waiting for its dependences to complete
+    std::vector<std::multimap<size_t,size_t>> parked;   // parked[r]: cycle -> node waiting for resource r
+
+    key_t key(size_t n) const;
+    bool empty() const;
+};
+
 class Scheduler {
 public:
     // dependence graph is constructed (see Init) once from the sequence of gates in a kernel's circuit
     // it can be reused as often as needed as long as no gates are added/deleted; it doesn't modify those gates
-    lemon::ListDigraph graph;
+    DepGraph graph;
 
     // conversion between gate* (pointer to the gate in the circuit) and node (of the dependence graph)
-    lemon::ListDigraph::NodeMap<gate*> instruction;// instruction[n] == gate*
-    std::map<gate*, lemon::ListDigraph::Node>  node;// node[gate*] == n
-
-    // attributes
-    lemon::ListDigraph::NodeMap<std::string> name;     // name[n] == qasm string
-    lemon::ListDigraph::ArcMap<int> weight;            // number of cycles of dependence
-    lemon::ListDigraph::ArcMap<int> cause;             // qubit/creg index of dependence
-    lemon::ListDigraph::ArcMap<int> depType;           // RAW, WAW, ...
+    // graph.instruction[n] == gate*
+    std::unordered_map<gate*, size_t>  node;   // node[gate*] == n
 
     // s and t nodes are the top and bottom of the dependence graph
-    lemon::ListDigraph::Node s, t;                     // instruction[s]==SOURCE, instruction[t]==SINK
+    size_t s, t;                                // instruction[s]==SOURCE, instruction[t]==SINK
+    SOURCE source;                              // the gates of s and t
+    SINK sink;
+    std::list<GROUP> groups;                    // the GROUP nodes' gates, see add_group
 
     // parameters of dependence graph construction
     size_t          cycle_time;                        // to convert durations to cycles as weight of dependence
@@ -106,17 +194,27 @@ public:
     circuit*    circp;                             // current and result circuit, passed from Init to each scheduler
 
     // scheduler support
-    std::map<lemon::ListDigraph::Node,size_t>  remaining;  // remaining[node] == cycles until end; critical path representation
+    std::vector<size_t>  remaining;             // remaining[node] == cycles until end; critical path representation
+    int             remaining_dir;              // direction for which remaining was computed, -1 when not
+    std::vector<size_t>  critranks[2];          // rank_criticality result per direction, empty when not computed
+    std::mutex      mutex;                      // held by users of a graph shared between threads
+                                                // while computing or copying remaining and critranks
 
 public:
     Scheduler();
-
-    // ins->name may contain parameters, so must be stripped first before checking it for gate's name
-    static void stripname(std::string &name);
+    // the graph refers to source, sink and the gates in groups, so a copy would refer to those of the original
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
 
     // factored out code from Init to add a dependence between two nodes
     // operand is in qubit_creg combined index space
-    void add_dep(int srcID, int tgtID, enum DepTypes deptype, int operand);
+    void add_dep(size_t srcID, size_t tgtID, enum DepTypes deptype, int operand);
+
+    // replace the group of commuting gates in members by a new GROUP node that depends on each of them
+    void add_group(std::vector<size_t> &members, enum DepTypes deptype, int operand);
+
+    // whether node n is a GROUP node, i.e. a dummy gate other than SOURCE and SINK
+    bool is_group(size_t n) const;
 
     // fill the dependence graph ('graph') with nodes from the circuit and adding arcs for their dependences
     void init(
@@ -127,7 +225,10 @@ public:
     );
 
     void print() const;
-    void write_dependence_matrix() const;
+    void print_lists(std::ostream &out) const;
+
+    // write the dependence graph to file fname as lists of its nodes and arcs (see print_lists)
+    void write_dependence_list(const std::string &fname) const;
 
 private:
 
@@ -170,19 +271,20 @@ public:
 
     // cycle assignment without RC depending on direction: forward:ASAP, backward:ALAP;
     // without RC, this is all there is to schedule, apart from forming the bundles in ir::bundler()
-    // set_cycle iterates over the circuit's gates and set_cycle_gate over the dependences of each gate
-    // please note that set_cycle_gate expects a caller like set_cycle which iterates gp forward through the circuit
-    void set_cycle_gate(gate *gp, scheduling_direction_t dir);
+    // set_cycle iterates over the nodes and set_cycle_gate over the dependences of node n
+    // please note that set_cycle_gate expects a caller like set_cycle which iterates n forward through the nodes,
+    // which by construction are in a topological order
+    void set_cycle_gate(size_t n, scheduling_direction_t dir);
     void set_cycle(scheduling_direction_t dir);
 
     // sort circuit by the gates' cycle attribute in non-decreasing order
     static void sort_by_cycle(circuit *cp);
 
     // ASAP scheduler without RC, setting gate cycle values and sorting the resulting circuit
-    void schedule_asap(std::string &sched_dot);
+    void schedule_asap();
 
     // ALAP scheduler without RC, setting gate cycle values and sorting the resulting circuit
-    void schedule_alap(std::string &sched_dot);
+    void schedule_alap();
 
 // =========== schedulers with RC
     // Most code from here on deals with scheduling with Resource Constraints.
@@ -208,11 +310,19 @@ public:
     // This means that criticality has become independent of the direction of scheduling
     // which is easier in the core of the scheduler.
 
-    // Note that set_remaining_gate expects a caller like set_remaining that iterates gp backward over the circuit
-    void set_remaining_gate(gate* gp, scheduling_direction_t dir);
+    // Note that set_remaining_gate expects a caller like set_remaining that iterates n backward over the nodes;
+    // since the graph doesn't change, set_remaining only computes remaining when not done before for dir
+    void set_remaining_gate(size_t n, scheduling_direction_t dir);
     void set_remaining(scheduling_direction_t dir);
     gate* find_mostcritical(std::list<gate*>& lg);
 
+    // rank the nodes on deep-criticality (see criticality_lessthan) for the given direction, after set_remaining:
+    // critrank[n] == 0 for the most critical ones and equally critical nodes share their rank;
+    // keeping nodes ordered on critrank and then on the order of adding them is then the same as
+    // inserting each node in an ordered list just before the first node that is less critical;
+    // the ranks are computed once per direction and then copied out
+    void rank_criticality(scheduling_direction_t dir, std::vector<size_t> &critrank);
+
     // ASAP/ALAP list scheduling support code with RC
     // Uses an "available list" (avlist) as interface between dependence graph and scheduler
     // the avlist contains all nodes that wrt their dependences can be scheduled:
@@ -233,7 +343,7 @@ public:
     // Set the curr_cycle of the scheduling algorithm to start at the appropriate end as well;
     // note that the cycle attributes will be shifted down to start at 1 after backward scheduling.
     void init_available(
-        std::list<lemon::ListDigraph::Node> &avlist,
+        avlist_t &avlist,
         scheduling_direction_t dir,
         size_t &curr_cycle
     );
@@ -241,11 +351,12 @@ public:
     // collect the list of directly depending nodes
     // (i.e. those necessarily scheduled after the given node) without duplicates;
     // dependences that are duplicates from the perspective of the scheduler
-    // may be present in the dependence graph because the scheduler ignores dependence type and cause
+    // may be present in the dependence graph because the scheduler ignores dependence type and cause;
+    // instead of a GROUP node, the nodes depending on it are collected
     void get_depending_nodes(
-        lemon::ListDigraph::Node n,
+        size_t n,
         scheduling_direction_t dir,
-        std::list<lemon::ListDigraph::Node> &ln
+        std::list<size_t> &ln
     );
 
     // Compute of two nodes whether the first one is less deep-critical than the second, for the given scheduling direction;
@@ -254,8 +365,8 @@ public:
     // this function is used to order the avlist in an order from highest deep-criticality to lowest deep-criticality;
     // it is the core of the heuristics of the critical path list scheduler.
     bool criticality_lessthan(
-        lemon::ListDigraph::Node n1,
-        lemon::ListDigraph::Node n2,
+        size_t n1,
+        size_t n2,
         scheduling_direction_t dir
     );
 
@@ -265,10 +376,10 @@ public:
     //  all its successors were scheduled (backward scheduling)
     // update its cycle attribute to reflect these dependences;
     // avlist is initialized with s or t as first element by init_available
-    // avlist is kept ordered on deep-criticality, non-increasing (i.e. highest deep-criticality first)
+    // n is added to avlist.pending, from where it gets ready when it has completed (see SelectAvailable)
     void MakeAvailable(
-        lemon::ListDigraph::Node n,
-        std::list<lemon::ListDigraph::Node> &avlist,
+        size_t n,
+        avlist_t &avlist,
         scheduling_direction_t dir
     );
 
@@ -290,36 +401,41 @@ public:
     // because from then on that value is compared to the curr_cycle to check
     // whether a node has completed execution and thus is available for scheduling in curr_cycle
     void TakeAvailable(
-        lemon::ListDigraph::Node n,
-        std::list<lemon::ListDigraph::Node> &avlist,
-        std::map<gate*,bool> &scheduled,
+        size_t n,
+        avlist_t &avlist,
+        std::vector<bool> &scheduled,
         scheduling_direction_t dir
     );
 
     // advance curr_cycle
     // when no node was selected from the avlist, advance to the next cycle
-    // and try again; this makes nodes/instructions to complete execution for one more cycle,
+    // at which a pending node completes or at which a resource of a parked node may have become available,
+    // and try again; this makes nodes/instructions to complete execution,
     // and makes resources finally available in case of resource constrained scheduling
     // so it contributes to proceeding and to finally have an empty avlist
-    static void AdvanceCurrCycle(scheduling_direction_t dir, size_t &curr_cycle);
+    static void AdvanceCurrCycle(const avlist_t &avlist, scheduling_direction_t dir, size_t &curr_cycle);
 
     // a gate must wait until all its operand are available, i.e. the gates having computed them have completed,
     // and must wait until all resources required for the gate's execution are available;
     // return true when immediately schedulable
-    // when returning false, isres indicates whether resource occupation was the reason or operand completion (for debugging)
+    // when returning false, isres indicates whether resource occupation was the reason or operand completion,
+    // and when it was resource occupation, r is the index of the resource that was not available
     bool immediately_schedulable(
-        lemon::ListDigraph::Node n,
+        size_t n,
         scheduling_direction_t dir,
         const size_t curr_cycle,
         const quantum_platform& platform,
         arch::resource_manager_t &rm,
-        bool &isres
+        bool &isres,
+        size_t &r
     );
 
     // select a node from the avlist
-    // the avlist is deep-ordered from high to low criticality (see criticality_lessthan above)
-    lemon::ListDigraph::Node SelectAvailable(
-        std::list<lemon::ListDigraph::Node> &avlist,
+    // first the pending and parked nodes that may be schedulable in curr_cycle are made ready;
+    // then the ready nodes are tried in their order, deep-ordered from high to low criticality
+    // (see criticality_lessthan above), and those for which a resource is not available are parked
+    size_t SelectAvailable(
+        avlist_t &avlist,
         scheduling_direction_t dir,
         const size_t curr_cycle,
         const quantum_platform &platform,
@@ -339,35 +455,50 @@ public:
         circuit *circp,
         scheduling_direction_t dir,
         const quantum_platform &platform,
-        arch::resource_manager_t &rm,
-        std::string &sched_dot
+        arch::resource_manager_t &rm
     );
 
     void schedule_asap(
         arch::resource_manager_t &rm,
-        const quantum_platform &platform,
-        std::string &sched_dot
+        const quantum_platform &platform
     );
 
     void schedule_alap(
         arch::resource_manager_t &rm,
-        const quantum_platform &platform,
-        std::string &sched_dot
+        const quantum_platform &platform
     );
 
     void schedule_alap_uniform();
 
     // printing dot of the dependence graph
     void get_dot(bool WithCritical, bool WithCycles, std::ostream &dotout);
-    void get_dot(std::string &dot);
+
+    // write the dot of the dependence graph to file fname, streaming it instead of first building it in memory;
+    // with asap, the cycles shown are those of an ASAP schedule, otherwise the gates' current cycles
+    void write_dot(const std::string &fname, bool asap);
+
+    // whether the dot files of the dependence graph of kernel kernelname are to be written,
+    // i.e. print_dot_graphs is yes, print_dot_kernels selects it and it is within print_dot_maxnodes
+    bool print_dot_enabled(const std::string &kernelname) const;
+};
+
+// binds a graph that outlives the circuit it was built from to a circuit with the same gates, for the duration of a use
+class circuit_binding {
+public:
+    circuit_binding(Scheduler &sched, circuit &ckt) : sched(sched) {
+        sched.circp = &ckt;
+    }
+    ~circuit_binding() {
+        sched.circp = nullptr;
+    }
+private:
+    Scheduler &sched;
 };
 
 // schedule support for program.h::schedule()
 void schedule_kernel(
     quantum_kernel &kernel,
-    const quantum_platform &platform,
-    std::string &dot,
-    std::string &sched_dot
+    const quantum_platform &platform
 );
 
 /*
@@ -382,7 +513,7 @@ void schedule(
 void rcschedule_kernel(
     quantum_kernel &kernel,
     const quantum_platform &platform,
-    std::string &dot,
+    const std::string &passname,
     size_t nqubits,
     size_t ncreg = 0
 );
@@ -0,0 +1,115 @@
+/**
+ * @file   thread_pool.cc
+ * @date   10/2026
+ * @brief  pool of threads doing a number of independent tasks in parallel
+ */
+
+#include "thread_pool.h"
+
+#include <cstdlib>
+#include <algorithm>
+
+namespace ql {
+namespace utils {
+
+thread_pool::thread_pool(size_t nthreads) :
+    generation(0), nbusy(0), running(false), stopping(false), task(nullptr), ntasks(0), next(0)
+{
+    for (size_t t = 1; t < nthreads; t++) {
+        workers.emplace_back(&thread_pool::work, this);
+    }
+}
+
+thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        stopping = true;
+    }
+    started.notify_all();
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
+size_t thread_pool::size() const {
+    return workers.size() + 1;
+}
+
+size_t thread_pool::threads_option(const std::string &value) {
+    if (value == "max") {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+    return atoi(value.c_str());
+}
+
+void thread_pool::run(size_t n, const std::function<void(size_t)> &t) {
+    bool sequential;
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        sequential = (workers.empty() || running || n <= 1);
+        if (!sequential) {
+            running = true;
+            task = &t;
+            ntasks = n;
+            next = 0;
+            exceptions.assign(n, nullptr);
+            nbusy = workers.size();
+            generation++;
+        }
+    }
+    if (sequential) {
+        for (size_t i = 0; i < n; i++) {
+            t(i);
+        }
+        return;
+    }
+
+    started.notify_all();
+    do_tasks();
+    {
+        std::unique_lock<std::mutex> l(mutex);
+        finished.wait(l, [this]() { return nbusy == 0; });
+        running = false;
+        task = nullptr;
+    }
+
+    for (auto &e : exceptions) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+
+void thread_pool::work() {
+    size_t seen = 0;        // generation of the last run done
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> l(mutex);
+            started.wait(l, [this, seen]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+        do_tasks();
+        {
+            std::lock_guard<std::mutex> l(mutex);
+            if (--nbusy == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+}
+
+void thread_pool::do_tasks() {
+    for (size_t i = next++; i < ntasks; i = next++) {
+        try {
+            (*task)(i);
+        } catch (...) {
+            exceptions[i] = std::current_exception();
+        }
+    }
+}
+
+} // namespace utils
+} // namespace ql
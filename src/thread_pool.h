@@ -0,0 +1,68 @@
+/**
+ * @file   thread_pool.h
+ * @date   10/2026
+ * @brief  pool of threads doing a number of independent tasks in parallel
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+namespace ql {
+namespace utils {
+
+/**
+ * pool of threads to do the independent tasks 0 .. n-1 of a run in parallel
+ *
+ * run(n, task) calls task(i) for each i in 0 .. n-1, by the calling thread and the workers of the pool,
+ * each repeatedly taking the next task that was not taken yet, and returns when all tasks were done.
+ * When task throws for some i, the exception of the first of these is rethrown after all were done,
+ * as would have happened when doing them sequentially (apart from the tasks after it having been done too).
+ * The workers are created with the pool and wait in between runs, so a run doesn't create threads.
+ * A run that is started while the pool is doing another one, e.g. by one of its tasks, is done sequentially
+ * by the calling thread.
+ */
+class thread_pool {
+public:
+    // a pool of which runs are done by nthreads threads: the calling thread and nthreads-1 workers
+    explicit thread_pool(size_t nthreads);
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+    ~thread_pool();
+
+    // number of threads doing a run, including the calling thread
+    size_t size() const;
+
+    void run(size_t n, const std::function<void(size_t)> &task);
+
+    // number of threads asked for by the value of a threads option: a number, or "max" for the number of cores
+    static size_t threads_option(const std::string &value);
+
+private:
+    void work();        // loop of a worker
+    void do_tasks();    // take and do tasks of the current run until none is left
+
+    std::vector<std::thread>        workers;
+    std::mutex                      mutex;
+    std::condition_variable         started;    // a run was started or the pool is being destroyed
+    std::condition_variable         finished;   // the last worker finished its part of the run
+    size_t                          generation; // number of runs started by workers
+    size_t                          nbusy;      // number of workers still doing tasks of the current run
+    bool                            running;    // a run is in progress
+    bool                            stopping;   // the pool is being destroyed
+
+    const std::function<void(size_t)> *task;    // of the current run
+    size_t                          ntasks;
+    std::atomic<size_t>             next;       // next task to be taken
+    std::vector<std::exception_ptr> exceptions; // exceptions[i]: thrown by task i, if any
+};
+
+} // namespace utils
+} // namespace ql
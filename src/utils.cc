@@ -32,6 +32,70 @@ void set_log_level(const std::string &level) {
     }
 }
 
+static thread_local std::ostream *log_out_stream = nullptr;
+static thread_local std::ostream *log_err_stream = nullptr;
+
+std::ostream &log_out() {
+    return (log_out_stream ? *log_out_stream : std::cout);
+}
+
+std::ostream &log_err() {
+    return (log_err_stream ? *log_err_stream : std::cerr);
+}
+
+void redirect(std::ostream *out, std::ostream *err) {
+    log_out_stream = out;
+    log_err_stream = err;
+}
+
+log_buffer::chunk_buf::chunk_buf(log_buffer &b, bool is_err) : buffer(b), is_err(is_err) {
+}
+
+log_buffer::chunk_buf::int_type log_buffer::chunk_buf::overflow(int_type c) {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        char ch = traits_type::to_char_type(c);
+        buffer.append(is_err, &ch, 1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize log_buffer::chunk_buf::xsputn(const char *s, std::streamsize n) {
+    buffer.append(is_err, s, n);
+    return n;
+}
+
+log_buffer::log_buffer() :
+    out_buf(*this, false),
+    err_buf(*this, true),
+    out_stream(&out_buf),
+    err_stream(&err_buf)
+{
+}
+
+std::ostream &log_buffer::out() {
+    return out_stream;
+}
+
+std::ostream &log_buffer::err() {
+    return err_stream;
+}
+
+// consecutive output to the same stream is kept in one chunk
+void log_buffer::append(bool is_err, const char *s, size_t n) {
+    if (chunks.empty() || chunks.back().first != is_err) {
+        chunks.emplace_back(is_err, std::string());
+    }
+    chunks.back().second.append(s, n);
+}
+
+void log_buffer::replay() {
+    for (auto &c : chunks) {
+        std::ostream &os = (c.first ? std::cerr : std::cout);
+        os << c.second << std::flush;
+    }
+    chunks.clear();
+}
+
 } // namespace logger
 
 void make_output_dir(const std::string &dir) {
@@ -26,34 +26,34 @@
 #define EOUT(content) \
     do {                                                                                                    \
         if (::ql::utils::logger::LOG_LEVEL >= ::ql::utils::logger::log_level_t::LOG_ERROR) {                \
-            ::std::cerr << "[OPENQL] " __FILE__ ":" << __LINE__ << " Error: " << content << ::std::endl;    \
+            ::ql::utils::logger::log_err() << "[OPENQL] " __FILE__ ":" << __LINE__ << " Error: " << content << ::std::endl;    \
         }                                                                                                   \
     } while (false)
 
 #define WOUT(content) \
     do {                                                                                                    \
         if (::ql::utils::logger::LOG_LEVEL >= ::ql::utils::logger::log_level_t::LOG_WARNING) {              \
-            ::std::cerr << "[OPENQL] " __FILE__ ":" << __LINE__ << " Warning: " << content << ::std::endl;  \
+            ::ql::utils::logger::log_err() << "[OPENQL] " __FILE__ ":" << __LINE__ << " Warning: " << content << ::std::endl;  \
         }                                                                                                   \
     } while (false)
 
 #define IOUT(content) \
     do {                                                                                                    \
         if (::ql::utils::logger::LOG_LEVEL >= ::ql::utils::logger::log_level_t::LOG_INFO) {                 \
-            ::std::cout << "[OPENQL] " __FILE__ ":" << __LINE__ << " Info: "<< content << ::std::endl;      \
+            ::ql::utils::logger::log_out() << "[OPENQL] " __FILE__ ":" << __LINE__ << " Info: "<< content << ::std::endl;      \
         }                                                                                                   \
     } while (false)
 
 #define DOUT(content) \
     do {                                                                                                    \
         if (::ql::utils::logger::LOG_LEVEL >= ::ql::utils::logger::log_level_t::LOG_DEBUG) {                \
-            ::std::cout << "[OPENQL] " __FILE__ ":" << __LINE__ << " " << content << ::std::endl;           \
+            ::ql::utils::logger::log_out() << "[OPENQL] " __FILE__ ":" << __LINE__ << " " << content << ::std::endl;           \
         }                                                                                                   \
     } while (false)
 
 #define COUT(content) \
     do {                                                                                                    \
-        ::std::cout << "[OPENQL] " __FILE__ ":" << __LINE__ << " " << content << ::std::endl;               \
+        ::ql::utils::logger::log_out() << "[OPENQL] " __FILE__ ":" << __LINE__ << " " << content << ::std::endl;               \
     } while (false)
 
 // helper macro: stringstream to string
@@ -125,6 +125,50 @@ OPENQL_DECLSPEC extern log_level_t LOG_LEVEL;
 
 void set_log_level(const std::string &level);
 
+// the streams that the log macros above write to: std::cout and std::cerr,
+// unless redirected for the calling thread, as is done to buffer the log output of a kernel
+// that is compiled by a thread of its own (see log_buffer below and for_each_kernel in program.h);
+// redirect(nullptr, nullptr) restores std::cout and std::cerr
+std::ostream &log_out();
+std::ostream &log_err();
+void redirect(std::ostream *out, std::ostream *err);
+
+// log output buffered to be written later, keeping the order in which it was written to out and err;
+// so that e.g. a warning still appears between the info lines that it appeared between when written directly
+class log_buffer {
+public:
+    log_buffer();
+    log_buffer(const log_buffer &) = delete;
+    log_buffer &operator=(const log_buffer &) = delete;
+
+    std::ostream &out();
+    std::ostream &err();
+
+    // write the buffered output to std::cout and std::cerr, in the order in which it was written, and clear it
+    void replay();
+
+private:
+    // appends all characters written to it to the chunks of the buffer
+    class chunk_buf : public std::streambuf {
+    public:
+        chunk_buf(log_buffer &b, bool is_err);
+    protected:
+        int_type overflow(int_type c) override;
+        std::streamsize xsputn(const char *s, std::streamsize n) override;
+    private:
+        log_buffer &buffer;
+        bool is_err;
+    };
+
+    void append(bool is_err, const char *s, size_t n);
+
+    std::vector<std::pair<bool, std::string>> chunks;   // (written to err, text), in the order written
+    chunk_buf out_buf;
+    chunk_buf err_buf;
+    std::ostream out_stream;
+    std::ostream err_stream;
+};
+
 } // namespace logger
 
 
@@ -0,0 +1,76 @@
+version 1.0
+# this file has been automatically generated by the OpenQL compiler please do not modify it manually.
+qubits 7
+
+.aKernel
+    { x q[0] | x q[3] }
+    cz q[3],q[0]
+    x q[1]
+    cz q[3],q[1]
+    x q[5]
+    { t q[0] | cz q[3],q[5] }
+    x q[6]
+    cz q[3],q[6]
+    { y q[0] | t q[1] }
+    cz q[3],q[0]
+    t q[5]
+    { t q[6] | cz q[3],q[1] }
+    wait 1
+    cz q[3],q[5]
+    { y q[6] | t q[0] }
+    cz q[3],q[6]
+    t q[1]
+    { t q[5] | cz q[3],q[0] }
+    wait 1
+    cz q[3],q[1]
+    { y q[5] | t q[6] }
+    cz q[3],q[5]
+    t q[0]
+    { t q[1] | cz q[3],q[6] }
+    wait 1
+    cz q[3],q[0]
+    { y q[1] | t q[5] }
+    cz q[3],q[1]
+    t q[6]
+    { t q[0] | cz q[3],q[5] }
+    wait 1
+    cz q[3],q[6]
+    { y q[0] | t q[1] }
+    cz q[3],q[0]
+    t q[5]
+    { t q[6] | cz q[3],q[1] }
+    wait 1
+    cz q[3],q[5]
+    { y q[6] | t q[0] }
+    cz q[3],q[6]
+    wait 1
+    cnot q[0],q[3]
+    t q[1]
+    wait 2
+    { t q[5] | cnot q[1],q[3] }
+    wait 2
+    y q[5]
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    wait 3
+    cnot q[5],q[3]
+    t q[6]
+    wait 1
+    { x q[2] | x q[4] }
+    { measure q[0] | measure q[1] | measure q[2] | measure q[3] | measure q[4] | measure q[5] | measure q[6] }
+    wait 15
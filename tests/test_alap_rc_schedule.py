@@ -16,6 +16,7 @@ class Test_Alap_Rc_Schedule(unittest.TestCase):
         ql.set_option('scheduler', self._SCHEDULER)
         ql.set_option('output_dir', output_dir)
         ql.set_option('log_level', "LOG_NOTHING")
+        ql.set_option('kernelthreads', '1')
 
     def test_qwg(self):
         self.setUp()
@@ -340,6 +341,44 @@ class Test_Alap_Rc_Schedule(unittest.TestCase):
         self.assertTrue(file_compare(QISA_fn, GOLD_fn))
 
 
+    def test_kernelthreads(self):
+        self.setUp()
+        # several kernels, each with rotations, cnots and measures;
+        # these are scheduled by 4 threads in parallel, which must give the same result as sequentially
+        v = 'kernelthreads'
+        scheduler = self._SCHEDULER
+
+        # compile the same program with the given number of threads, under its own name
+        def compile_with(prog_name, kernelthreads):
+            starmon = ql.Platform("starmon", self.config)
+            prog = ql.Program(prog_name, starmon, 7, 0)
+
+            for i in range(8):
+                k = ql.Kernel("kernel_" + v + "_" + scheduler + "_" + str(i), starmon, 7, 0)
+                for j in range(7):
+                    k.gate("x" if (i+j) % 2 == 0 else "y", [j])
+                k.gate("cnot", [0, 2])
+                k.gate("cnot", [3, 5])
+                k.gate("cnot", [4, 1 if i % 2 == 0 else 6])
+                k.gate("h", [i % 7])
+                for j in range(7):
+                    k.gate("measure", [j])
+                prog.add_kernel(k)
+
+            ql.set_option("scheduler", scheduler)
+            ql.set_option('kernelthreads', kernelthreads)
+            prog.compile()
+            return os.path.join(output_dir, prog.name+'.qisa')
+
+        prog_name = "test_" + v + "_" + scheduler
+        SEQ_fn = compile_with(prog_name + "_sequential", '1')
+        QISA_fn = compile_with(prog_name, '4')
+        GOLD_fn = os.path.join(curdir, 'golden', prog_name + '.qisa')
+
+        self.assertTrue(file_compare(QISA_fn, SEQ_fn))
+        self.assertTrue(file_compare(QISA_fn, GOLD_fn))
+
+
 if __name__ == '__main__':
     # ql.set_option('log_level', 'LOG_DEBUG')
     unittest.main()
@@ -172,5 +172,81 @@ class Test_commutation(unittest.TestCase):
         qasm_fn = os.path.join(output_dir, p.name+'_scheduled.qasm')
         self.assertTrue( file_compare(qasm_fn, gold_fn) )
 
+    def test_cz_groupcommute(self):
+        # qubit 3 is used by more cz gates than fit in a commutation group;
+        # the schedule must be the same as when each cz would depend directly on all others
+        config_fn = os.path.join(curdir, 'test_179.json')
+        platf = ql.Platform("starmon", config_fn)
+        ql.set_option("scheduler", 'ALAP');
+        ql.set_option("scheduler_post179", 'yes');
+        ql.set_option("scheduler_commute", 'yes');
+
+        nqubits = 7
+        k = ql.Kernel("aKernel", platf, nqubits)
+
+        for j in range(7):
+            k.gate("x", [j])
+        for i in range(20):
+            j = [0,1,5,6][i % 4]
+            k.gate("cz", [3,j]);
+            k.gate("t", [j]);
+            if i % 3 == 0:
+                k.gate("y", [j]);
+        k.gate("cnot", [0,3]);
+        k.gate("cnot", [1,3]);
+        for i in range(10):
+            k.gate("cnot", [5,3]);
+        for j in range(7):
+            k.gate("measure", [j])
+
+        sweep_points = [2]
+
+        p = ql.Program("test_cz_groupcommute", platf, nqubits)
+        p.set_sweep_points(sweep_points)
+        p.add_kernel(k)
+        p.compile()
+
+        gold_fn = curdir + '/golden/'+ p.name + '_scheduled.qasm'
+        qasm_fn = os.path.join(output_dir, p.name+'_scheduled.qasm')
+        self.assertTrue( file_compare(qasm_fn, gold_fn) )
+
+    def test_cz_groupnocommute(self):
+        # as test_cz_groupcommute but without commutation,
+        # so the cz gates on qubit 3 are sequentialized in their original order
+        config_fn = os.path.join(curdir, 'test_179.json')
+        platf = ql.Platform("starmon", config_fn)
+        ql.set_option("scheduler", 'ALAP');
+        ql.set_option("scheduler_post179", 'yes');
+        ql.set_option("scheduler_commute", 'no');
+
+        nqubits = 7
+        k = ql.Kernel("aKernel", platf, nqubits)
+
+        for j in range(7):
+            k.gate("x", [j])
+        for i in range(20):
+            j = [0,1,5,6][i % 4]
+            k.gate("cz", [3,j]);
+            k.gate("t", [j]);
+            if i % 3 == 0:
+                k.gate("y", [j]);
+        k.gate("cnot", [0,3]);
+        k.gate("cnot", [1,3]);
+        for i in range(10):
+            k.gate("cnot", [5,3]);
+        for j in range(7):
+            k.gate("measure", [j])
+
+        sweep_points = [2]
+
+        p = ql.Program("test_cz_groupnocommute", platf, nqubits)
+        p.set_sweep_points(sweep_points)
+        p.add_kernel(k)
+        p.compile()
+
+        gold_fn = curdir + '/golden/'+ p.name + '_scheduled.qasm'
+        qasm_fn = os.path.join(output_dir, p.name+'_scheduled.qasm')
+        self.assertTrue( file_compare(qasm_fn, gold_fn) )
+
 if __name__ == '__main__':
     unittest.main()
@@ -229,5 +229,36 @@ class Test_dependence(unittest.TestCase):
         self.assertTrue( file_compare(qasm_fn, gold_fn) )
 
 
+    # @unittest.skip
+    def test_print_dot_selection(self):
+        self.setUp()
+        ql.set_option('print_dot_graphs', 'yes')
+        ql.set_option('print_dot_kernels', 'dotKernel,bigKernel')
+        ql.set_option('print_dot_maxnodes', '100')
+
+        nqubits = 4
+        p = ql.Program("print_dot_selection", platf, nqubits)
+        for name, ngates in [("dotKernel", 10), ("bigKernel", 200), ("otherKernel", 10)]:
+            for ext in ['.dot', '.lgf']:
+                fn = os.path.join(output_dir, name+'_dependence_graph'+ext)
+                if os.path.exists(fn):
+                    os.remove(fn)
+            k = ql.Kernel(name, platf, nqubits)
+            for i in range(ngates):
+                k.gate("x", [i % nqubits])
+            p.add_kernel(k)
+        p.compile()
+
+        # only the selected kernel with at most print_dot_maxnodes nodes gets its graph printed
+        for name, printed in [("dotKernel", True), ("bigKernel", False), ("otherKernel", False)]:
+            for ext in ['.dot', '.lgf']:
+                fn = os.path.join(output_dir, name+'_dependence_graph'+ext)
+                self.assertEqual(os.path.exists(fn), printed)
+
+        ql.set_option('print_dot_graphs', 'no')
+        ql.set_option('print_dot_kernels', 'all')
+        ql.set_option('print_dot_maxnodes', '100000')
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,71 @@
+#include <openql_i.h>
+#include <cstdlib>
+
+// the arena of a kernel creates exactly the gates of its circuit
+void
+test_kernel_arena()
+{
+    int n = 17;
+    ql::quantum_platform starmon("starmon", "test_mapper_s17.json");
+    ql::quantum_kernel k("test_kernel_arena", starmon, n, 0);
+    for (int i=0; i<n; i++) {
+        k.x(i);
+        k.gate("ry90", i);
+        k.cnot(i, (i+1) % n);
+    }
+    if (k.arena->size() != k.c.size()) {
+        std::cout << "test_kernel_arena: arena has " << k.arena->size() << " gates, circuit " << k.c.size() << std::endl;
+        std::exit(1);
+    }
+}
+
+// a scratch copy of a kernel with an arena of its own, as the mapper's trial passes use (see gate_arena):
+// its gates don't go to the kernel's arena, and after adopting its arena, they live as long as the kernel
+void
+test_scratch_arena()
+{
+    int n = 17;
+    ql::quantum_platform starmon("starmon", "test_mapper_s17.json");
+    ql::quantum_kernel k("test_scratch_arena", starmon, n, 0);
+    k.x(0);
+    k.cnot(0, 1);
+
+    ql::gate *gp;
+    {
+        ql::quantum_kernel scratch = k;
+        scratch.arena = std::make_shared<ql::gate_arena>(k.instructions);
+        scratch.x(2);
+        scratch.cnot(2, 3);
+        gp = scratch.c.back();
+        if (k.arena->size() != 2 || scratch.arena->size() != 2) {
+            std::cout << "test_scratch_arena: scratch gates went to the arena of the kernel" << std::endl;
+            std::exit(1);
+        }
+        k.arena->adopt(*scratch.arena);
+        if (k.arena->size() != 4 || scratch.arena->size() != 0) {
+            std::cout << "test_scratch_arena: adopt didn't take over the gates" << std::endl;
+            std::exit(1);
+        }
+        k.c.push_back(gp);
+    }
+    if (gp->name != "cnot" || gp->operands != std::vector<size_t>({2, 3})) {
+        std::cout << "test_scratch_arena: adopted gate was destroyed with the scratch kernel" << std::endl;
+        std::exit(1);
+    }
+    k.x(4);
+    if (k.arena->size() != 5) {
+        std::cout << "test_scratch_arena: arena has " << k.arena->size() << " gates after adopting" << std::endl;
+        std::exit(1);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    ql::utils::logger::set_log_level("LOG_NOTHING");
+    ql::options::set("unique_output", "no");
+
+    test_kernel_arena();
+    test_scratch_arena();
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <openql_i.h>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+// gate creation and teardown time benchmark on a 17 qubit platform;
+// the kernel gets ngates random single- and two-qubit gates, which are created in its gate arena;
+// creation is timed over the k.gate calls, teardown over the destruction of the kernel
+// which destroys all its gates and releases the arena's blocks in one go;
+// the arena must have created exactly the gates of the kernel's circuit
+void
+bench_gate_arena(int ngates)
+{
+    int n = 17;
+    std::string kernel_name = "bench_gate_arena_ngates=" + std::to_string(ngates);
+
+    ql::quantum_platform starmon("starmon", "test_mapper_s17.json");
+
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> dis(0, n-1);
+    std::vector<int> qs;
+    for (int i=0; i<2*ngates; i++) {
+        qs.push_back(dis(gen));
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::chrono::high_resolution_clock::time_point t2;
+    {
+        ql::quantum_kernel k(kernel_name, starmon, n, 0);
+        for (int i=0; i<ngates; i++) {
+            int q0 = qs[2*i];
+            int q1 = qs[2*i+1];
+            if (i % 5 == 0 && q0 != q1) {
+                k.cnot(q0, q1);
+            } else if (i % 2 == 0) {
+                k.x(q0);
+            } else {
+                k.gate("ry90", q0);
+            }
+        }
+        t2 = std::chrono::high_resolution_clock::now();
+        if (k.arena->size() != k.c.size()) {
+            std::cout << kernel_name << ": arena has " << k.arena->size() << " gates, circuit " << k.c.size() << std::endl;
+            std::exit(1);
+        }
+    }
+    auto t3 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> create_span = t2 - t1;
+    std::chrono::duration<double> teardown_span = t3 - t2;
+
+    std::cout << kernel_name << ": creation took " << create_span.count() << " seconds"
+              << ", teardown took " << teardown_span.count() << " seconds" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    ql::utils::logger::set_log_level("LOG_NOTHING");
+    ql::options::set("unique_output", "no");
+
+    for (int ngates : { 10000, 100000, 1000000 }) {
+        bench_gate_arena(ngates);
+    }
+
+    return 0;
+}
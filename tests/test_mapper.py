@@ -44,6 +44,8 @@ class Test_mapper(unittest.TestCase):
         ql.set_option('mapper', 'minextendrc')
         ql.set_option('mapinitone2one', 'yes')
         ql.set_option('initialplace', 'no')
+        ql.set_option('mapportfolio', 'no')
+        ql.set_option('scheduler_resources', 'state')
         ql.set_option('initialplace2qhorizon', '0')
         ql.set_option('mapusemoves', 'yes')
         ql.set_option('mapreverseswap', 'yes')
@@ -273,6 +275,195 @@ class Test_mapper(unittest.TestCase):
         self.assertTrue(file_compare(QISA_fn, GOLD_fn))
 
 
+    def test_mapper_allDbeam(self):
+        # all possible cnots in s7, in lexicographic order, as in test_mapper_allD
+        # but mapped by mapper=beam, keeping 4 partial routings alive while mapping
+        # parameters
+        v = 'allDbeam'
+        config = os.path.join(curdir, "test_mapper_s7.json")
+        num_qubits = 7
+
+        # create and set platform
+        prog_name = "test_mapper_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("starmon", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, 0)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, 0)
+
+        for j in range(7):
+            k.gate("x", [j])
+
+        for i in range(7):
+            for j in range(7):
+                if (i != j):
+                    k.gate("cnot", [i,j])
+
+        for j in range(7):
+            k.gate("x", [j])
+
+        prog.add_kernel(k)
+
+        ql.set_option('mapper', 'beam')
+        ql.set_option('mapbeamwidth', '4')
+        prog.compile()
+
+        GOLD_fn = os.path.join(curdir, 'golden', prog.name + '.qisa')
+        QISA_fn = os.path.join(output_dir, prog.name+'.qisa')
+
+        self.assertTrue(file_compare(QISA_fn, GOLD_fn))
+
+
+    def test_mapper_allDportfolio(self):
+        # all possible cnots in s7, in lexicographic order, as in test_mapper_allD
+        # but mapped by a portfolio of 4 mapper configurations in parallel, taking the one with lowest depth;
+        # all members' configurations are deterministic, so is the result
+        # parameters
+        v = 'allDportfolio'
+        config = os.path.join(curdir, "test_mapper_s7.json")
+        num_qubits = 7
+
+        # create and set platform
+        prog_name = "test_mapper_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("starmon", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, 0)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, 0)
+
+        for j in range(7):
+            k.gate("x", [j])
+
+        for i in range(7):
+            for j in range(7):
+                if (i != j):
+                    k.gate("cnot", [i,j])
+
+        for j in range(7):
+            k.gate("x", [j])
+
+        prog.add_kernel(k)
+
+        ql.set_option('mapportfolio', 'all')
+        ql.set_option('mapportfoliosize', '4')
+        prog.compile()
+
+        GOLD_fn = os.path.join(curdir, 'golden', prog.name + '.qisa')
+        QISA_fn = os.path.join(output_dir, prog.name+'.qisa')
+
+        self.assertTrue(file_compare(QISA_fn, GOLD_fn))
+
+
+    def test_mapper_classicalportfolio(self):
+        # cnots in s7 with a classical gate in between, mapped by a portfolio without prescheduler;
+        # the classical gate isn't scheduled by the mapper, so its cycle must not count in a member's depth
+        # parameters
+        v = 'classicalportfolio'
+        config = os.path.join(curdir, "test_mapper_s7.json")
+        num_qubits = 7
+        num_cregs = 2
+
+        # create and set platform
+        prog_name = "test_mapper_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("starmon", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, num_cregs)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, num_cregs)
+
+        for j in range(7):
+            k.gate("x", [j])
+        k.gate("cnot", [0,6])
+        k.classical(ql.CReg(1), ql.Operation(1))
+        k.gate("cnot", [1,5])
+        k.gate("cnot", [2,4])
+
+        prog.add_kernel(k)
+
+        ql.set_option('prescheduler', 'no')
+        ql.set_option('mapportfolio', 'all')
+        ql.set_option('mapportfoliosize', '4')
+        ql.set_option('write_report_files', 'yes')
+        prog.compile()
+
+        REPORT_fn = os.path.join(output_dir, prog.name + '_mapper_out.report')
+        with open(REPORT_fn) as f:
+            winner = [line for line in f if 'portfolio winner:' in line]
+        self.assertEqual(len(winner), 1)
+        depth = int(winner[0].split('depth=')[1])
+        self.assertTrue(0 < depth < 100)
+
+
+    def test_mapper_allDtimeline(self):
+        # all possible cnots in s7, in lexicographic order, as in test_mapper_allD, followed by measurements,
+        # but with resources keeping timelines of reservations so that gates can be backfilled in holes
+        # parameters
+        v = 'allDtimeline'
+        config = os.path.join(curdir, "test_mapper_s7.json")
+        num_qubits = 7
+
+        # create and set platform
+        prog_name = "test_mapper_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("starmon", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, 0)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, 0)
+
+        for j in range(7):
+            k.gate("x", [j])
+
+        for i in range(7):
+            for j in range(7):
+                if (i != j):
+                    k.gate("cnot", [i,j])
+
+        for j in range(7):
+            k.gate("measure", [j])
+
+        prog.add_kernel(k)
+
+        ql.set_option('scheduler_resources', 'timeline')
+        prog.compile()
+
+        GOLD_fn = os.path.join(curdir, 'golden', prog.name + '.qisa')
+        QISA_fn = os.path.join(output_dir, prog.name+'.qisa')
+
+        self.assertTrue(file_compare(QISA_fn, GOLD_fn))
+
+
+    def test_mapper_lineSabre(self):
+        # virtual qubits in a line, with cnots between consecutive ones, three times over, in s7
+        # the one-to-one initial mapping doesn't make these nearest-neighbor, but there is a mapping that does;
+        # initialplace=sabre, which doesn't need the MIP solver, finds it by mapping forward and backward
+        # parameters
+        v = 'lineSabre'
+        config = os.path.join(curdir, "test_mapper_s7.json")
+        num_qubits = 7
+
+        # create and set platform
+        prog_name = "test_mapper_" + v
+        kernel_name = "kernel_" + v
+        starmon = ql.Platform("starmon", config)
+        prog = ql.Program(prog_name, starmon, num_qubits, 0)
+        k = ql.Kernel(kernel_name, starmon, num_qubits, 0)
+
+        for j in range(7):
+            k.gate("x", [j])
+
+        for r in range(3):
+            for i in range(6):
+                k.gate("cnot", [i,i+1])
+
+        for j in range(7):
+            k.gate("measure", [j])
+
+        prog.add_kernel(k)
+
+        ql.set_option('initialplace', 'sabre')
+        prog.compile()
+
+        GOLD_fn = os.path.join(curdir, 'golden', prog.name + '.qisa')
+        QISA_fn = os.path.join(output_dir, prog.name+'.qisa')
+
+        self.assertTrue(file_compare(QISA_fn, GOLD_fn))
+
     def test_mapper_allDopt(self):
         # all possible cnots in s7, avoiding collisions:
         # - the pair of possible CNOTs in both directions hopefully in parallel
@@ -0,0 +1,67 @@
+#include <openql_i.h>
+#include <mapper.h>
+#include <chrono>
+#include <random>
+
+// mapping time benchmark on a 7x7 grid with all 49 qubits in use;
+// only the mapper is run, on fresh copies of the same kernel, and the average time per Map is reported
+void
+bench_fullgrid(std::string v, std::string mapper, int ngates, int nruns, std::string portfolio = "no")
+{
+    int n = 49;
+    std::string kernel_name = "bench_" + v + "_mapper=" + mapper + "_ngates=" + std::to_string(ngates);
+
+    ql::quantum_platform starmon("starmon", "test_mapper_s49.json");
+    ql::quantum_kernel k(kernel_name, starmon, n, 0);
+
+    // full occupancy: every qubit is used, and pairs are random, so most cnots need routing
+    std::mt19937 gen(49);
+    std::uniform_int_distribution<int> dis(0, n-1);
+    for (int j=0; j<n; j++) { k.gate("x", j); }
+    for (int i=0; i<ngates; i++) {
+        int q0 = dis(gen);
+        int q1 = dis(gen);
+        if (q0 == q1) { q1 = (q1+1) % n; }
+        k.gate("cnot", q0, q1);
+    }
+    for (int j=0; j<n; j++) { k.gate("measure", j); }
+
+    ql::options::set("mapper", mapper);
+    ql::options::set("mapportfolio", portfolio);
+
+    ql::Mapper m;
+    m.Init(&starmon);
+    double timetaken = 0.0;
+    for (int r=0; r<nruns; r++) {
+        ql::quantum_kernel kr = k;
+        auto t1 = std::chrono::high_resolution_clock::now();
+        m.Map(kr);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> time_span = t2 - t1;
+        timetaken += time_span.count();
+    }
+    std::cout << kernel_name << ": Map took " << timetaken/nruns << " seconds (average of " << nruns << " runs)"
+              << ", added " << m.nswapsadded << " swaps of which " << m.nmovesadded << " moves"
+              << (m.portfoliowinner.empty() ? "" : ", portfolio winner " + m.portfoliowinner) << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    ql::utils::logger::set_log_level("LOG_NOTHING");
+    ql::options::set("unique_output", "no");
+    ql::options::set("use_default_gates", "no");
+
+    ql::options::set("mapinitone2one", "yes");
+    ql::options::set("initialplace", "no");
+    ql::options::set("mapassumezeroinitstate", "yes");
+    ql::options::set("mappathselect", "all");
+    ql::options::set("mapusemoves", "yes");
+    ql::options::set("maptiebreak", "first");
+
+    bench_fullgrid("fullgrid", "base", 1000, 5);
+    bench_fullgrid("fullgrid", "minextend", 200, 3);
+    bench_fullgrid("fullgrid", "beam", 200, 3);
+    bench_fullgrid("fullgrid_portfolio", "minextend", 200, 3, "all");
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <openql_i.h>
+#include <scheduler.h>
+#include <chrono>
+#include <random>
+
+// resource-constrained scheduling time benchmark on a 17 qubit platform;
+// the kernel has random single-qubit gates and measurements, with every 100th gate a wait of waitns ns;
+// since the scheduler skips the cycles in which nothing can be scheduled,
+// the time taken should hardly depend on waitns, although the depth does
+void
+bench_rcschedule(std::string scheduler, std::string resources, int ngates, size_t waitns)
+{
+    int n = 17;
+    std::string kernel_name = "bench_rcschedule_" + scheduler + "_" + resources
+                              + "_ngates=" + std::to_string(ngates) + "_waitns=" + std::to_string(waitns);
+
+    ql::quantum_platform starmon("starmon", "test_mapper_s17.json");
+    ql::quantum_kernel k(kernel_name, starmon, n, 0);
+
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> dis(0, n-1);
+    for (int i=0; i<ngates; i++) {
+        int q = dis(gen);
+        if (i % 100 == 0) {
+            k.wait({size_t(q)}, waitns);
+        } else if (i % 7 == 0) {
+            k.gate("measure", q);
+        } else {
+            k.gate("x", q);
+        }
+    }
+
+    ql::options::set("scheduler", scheduler);
+    ql::options::set("scheduler_resources", resources);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    ql::rcschedule_kernel(k, starmon, "rcscheduler", n, 0);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> time_span = t2 - t1;
+
+    size_t depth = k.c.empty() ? 0 : k.c.back()->cycle - k.c.front()->cycle;
+    std::cout << kernel_name << ": rcschedule_kernel took " << time_span.count() << " seconds"
+              << ", depth " << depth << " cycles" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    ql::utils::logger::set_log_level("LOG_NOTHING");
+    ql::options::set("unique_output", "no");
+
+    for (auto scheduler : { "ASAP", "ALAP" }) {
+        for (auto resources : { "state", "timeline" }) {
+            for (size_t waitns : { 0, 100000, 10000000 }) {
+                bench_rcschedule(scheduler, resources, 20000, waitns);
+            }
+        }
+    }
+    ql::options::set("scheduler", "ALAP");
+    ql::options::set("scheduler_resources", "state");
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <openql_i.h>
+#include <scheduler.h>
+#include <chrono>
+#include <random>
+
+// uniform scheduling time benchmark on a 17 qubit platform;
+// the kernel has long single-qubit chains interrupted by random cnots, creating the small bundles
+// that the uniform scheduler tries to fill up from the large ones;
+// only the scheduler is run, and the time includes building its dependence graph
+void
+bench_uniform(int ngates)
+{
+    int n = 17;
+    std::string kernel_name = "bench_uniform_ngates=" + std::to_string(ngates);
+
+    ql::quantum_platform starmon("starmon", "test_mapper_s17.json");
+    ql::quantum_kernel k(kernel_name, starmon, n, 0);
+
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<int> dis(0, n-1);
+    std::uniform_int_distribution<int> kind(0, 9);
+    for (int i=0; i<ngates; i++) {
+        int q0 = dis(gen);
+        int q1 = dis(gen);
+        int c = kind(gen);
+        if (c == 0 && q0 != q1) {
+            k.gate("cnot", q0, q1);
+        } else if (c == 1) {
+            k.gate("measure", q0);
+        } else {
+            k.gate("x", q0);
+        }
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    ql::Scheduler sched;
+    sched.init(k.c, starmon, n, 0);
+    sched.schedule_alap_uniform();
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> time_span = t2 - t1;
+
+    size_t depth = k.c.empty() ? 0 : k.c.back()->cycle;
+    std::cout << kernel_name << ": schedule_alap_uniform took " << time_span.count() << " seconds"
+              << ", depth " << depth << " cycles" << std::endl;
+}
+
+int main(int argc, char ** argv)
+{
+    ql::utils::logger::set_log_level("LOG_NOTHING");
+    ql::options::set("unique_output", "no");
+
+    bench_uniform(5000);
+    bench_uniform(50000);
+    bench_uniform(500000);
+
+    return 0;
+}